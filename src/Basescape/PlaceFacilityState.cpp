@@ -144,6 +144,7 @@ void PlaceFacilityState::viewClick(Action *)
 		fac->setY(_view->getGridY());
 		fac->setBuildTime(_rule->getBuildTime());
 		_base->getFacilities()->push_back(fac);
+		_base->updateCapacities();
 		if (Options::allowBuildingQueue)
 		{
 			if (_view->isQueuedBuilding(_rule)) fac->setBuildTime(INT_MAX);
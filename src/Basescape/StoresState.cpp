@@ -88,16 +88,12 @@ StoresState::StoresState(Base *base) : _base(base)
 	const std::vector<std::string> &items = _game->getMod()->getItemsList();
 	for (std::vector<std::string>::const_iterator i = items.begin(); i != items.end(); ++i)
 	{
-		int qty = _base->getStorageItems()->getItem(*i);
-		if (qty > 0)
+		if (_base->getStorageItems()->getItem(*i) > 0)
 		{
-			RuleItem *rule = _game->getMod()->getItem(*i, true);
-			std::ostringstream ss, ss2;
-			ss << qty;
-			ss2 << qty * rule->getSize();
-			_lstStores->addRow(3, tr(*i).c_str(), ss.str().c_str(), ss2.str().c_str());
+			_items.push_back(*i);
 		}
 	}
+	_lstStores->setRowSource(this, (RowSource)&StoresState::lstStoresRow, _items.size());
 }
 
 /**
@@ -108,6 +104,24 @@ StoresState::~StoresState()
 
 }
 
+/**
+ * Fills in the quantity and space used of a stored item.
+ * @param row Row number.
+ * @param cells Text of each cell.
+ */
+void StoresState::lstStoresRow(size_t row, std::vector<std::string> &cells)
+{
+	const std::string &item = _items[row];
+	int qty = _base->getStorageItems()->getItem(item);
+	RuleItem *rule = _game->getMod()->getItem(item, true);
+	std::ostringstream ss, ss2;
+	ss << qty;
+	ss2 << qty * rule->getSize();
+	cells.push_back(tr(item));
+	cells.push_back(ss.str());
+	cells.push_back(ss2.str());
+}
+
 /**
  * Returns to the previous screen.
  * @param action Pointer to an action.
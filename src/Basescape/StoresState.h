@@ -18,6 +18,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "../Engine/State.h"
+#include <vector>
+#include <string>
 
 namespace OpenXcom
 {
@@ -41,11 +43,14 @@ private:
 	Window *_window;
 	Text *_txtTitle, *_txtItem, *_txtQuantity, *_txtSpaceUsed;
 	TextList *_lstStores;
+	std::vector<std::string> _items;
 public:
 	/// Creates the Stores state.
 	StoresState(Base *base);
 	/// Cleans up the Stores state.
 	~StoresState();
+	/// Fills in a row of the stores list.
+	void lstStoresRow(size_t row, std::vector<std::string> &cells);
 	/// Handler for clicking the OK button.
 	void btnOkClick(Action *action);
 };
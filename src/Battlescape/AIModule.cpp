@@ -21,6 +21,7 @@
 #include "AIModule.h"
 #include "../Savegame/BattleItem.h"
 #include "../Savegame/Node.h"
+#include "../Savegame/NodeIndex.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/SavedGame.h"
 #include "TileEngine.h"
@@ -30,6 +31,7 @@
 #include "Pathfinding.h"
 #include "../Engine/RNG.h"
 #include "../Engine/Logger.h"
+#include "../Engine/Profiler.h"
 #include "../Engine/Game.h"
 #include "../Mod/Armor.h"
 #include "../Mod/Mod.h"
@@ -136,6 +138,7 @@ YAML::Node AIModule::save() const
  */
 void AIModule::think(BattleAction *action)
 {
+	PROFILE_SCOPE("AIModule::think");
 	action->type = BA_RETHINK;
 	action->actor = _unit;
 	action->weapon = _unit->getMainHandWeapon(false);
@@ -443,23 +446,7 @@ void AIModule::setupPatrol()
 	{
 		// assume closest node as "from node"
 		// on same level to avoid strange things, and the node has to match unit size or it will freeze
-		int closest = 1000000;
-		for (std::vector<Node*>::iterator i = _save->getNodes()->begin(); i != _save->getNodes()->end(); ++i)
-		{
-			if ((*i)->isDummy())
-			{
-				continue;
-			}
-			node = *i;
-			int d = _save->getTileEngine()->distanceSq(_unit->getPosition(), node->getPosition());
-			if (_unit->getPosition().z == node->getPosition().z
-				&& d < closest
-				&& (!(node->getType() & Node::TYPE_SMALL) || _unit->getArmor()->getSize() == 1))
-			{
-				_fromNode = node;
-				closest = d;
-			}
-		}
+		_fromNode = _save->getNodeIndex()->getNearestNode(_unit->getPosition(), _unit->getArmor()->getSize());
 	}
 	int triesLeft = 5;
 
@@ -591,12 +578,10 @@ void AIModule::setupAmbush()
 		Position origin = _save->getTileEngine()->getSightOriginVoxel(_aggroTarget);
 
 		// we'll use node positions for this, as it gives map makers a good degree of control over how the units will use the environment.
-		for (std::vector<Node*>::const_iterator i = _save->getNodes()->begin(); i != _save->getNodes()->end(); ++i)
+		std::vector<Node*> nodes;
+		_save->getNodeIndex()->getNodesInRange(_unit->getPosition(), 10, nodes);
+		for (std::vector<Node*>::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
 		{
-			if ((*i)->isDummy())
-			{
-				continue;
-			}
 			Position pos = (*i)->getPosition();
 			Tile *tile = _save->getTile(pos);
 			if (tile == 0 || _save->getTileEngine()->distance(pos, _unit->getPosition()) > 10 || pos.z != _unit->getPosition().z || tile->getDangerous() ||
@@ -1554,6 +1539,7 @@ bool AIModule::explosiveEfficacy(Position targetPos, BattleUnit *attackingUnit,
 		++efficacy;
 	}
 
+	std::vector<Position> traj;
 	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
 	{
 			// don't grenade dead guys
@@ -1575,7 +1561,7 @@ bool AIModule::explosiveEfficacy(Position targetPos, BattleUnit *attackingUnit,
 			// trace a line from the grenade origin to the unit we're checking against
 			Position voxelPosA = Position ((targetPos.x * 16)+8, (targetPos.y * 16)+8, (targetPos.z * 24)+12);
 			Position voxelPosB = Position (((*i)->getPosition().x * 16)+8, ((*i)->getPosition().y * 16)+8, ((*i)->getPosition().z * 24)+12);
-			std::vector<Position> traj;
+			traj.clear();
 			int collidesWith = _save->getTileEngine()->calculateLine(voxelPosA, voxelPosB, false, &traj, target, true, false, *i);
 
 			if (collidesWith == V_UNIT && traj.front() / Position(16,16,24) == (*i)->getPosition())
@@ -1901,7 +1887,7 @@ bool AIModule::psiAction()
 				// they must be player units
 				(*i)->getOriginalFaction() == _targetFaction &&
 				(!LOSRequired ||
-				std::find(_unit->getVisibleUnits()->begin(), _unit->getVisibleUnits()->end(), *i) != _unit->getVisibleUnits()->end()))
+				_unit->hasVisibleUnit(*i)))
 			{
 				int chanceToAttackMe = psiAttackStrength
 					+ (((*i)->getBaseStats()->psiSkill > 0) ? (*i)->getBaseStats()->psiSkill * -0.4 : 0)
@@ -2100,12 +2086,10 @@ bool AIModule::getNodeOfBestEfficacy(BattleAction *action)
 	int bestScore = 2;
 	Position originVoxel = _save->getTileEngine()->getSightOriginVoxel(_unit);
 	Position targetVoxel;
-	for (std::vector<Node*>::const_iterator i = _save->getNodes()->begin(); i != _save->getNodes()->end(); ++i)
+	std::vector<Node*> nodes;
+	_save->getNodeIndex()->getNodesInRange(_unit->getPosition(), 20, nodes);
+	for (std::vector<Node*>::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
 	{
-		if ((*i)->isDummy())
-		{
-			continue;
-		}
 		int dist = _save->getTileEngine()->distance((*i)->getPosition(), _unit->getPosition());
 		if (dist <= 20 && dist > action->weapon->getRules()->getExplosionRadius() &&
 			_save->getTileEngine()->canTargetTile(&originVoxel, _save->getTile((*i)->getPosition()), O_FLOOR, &targetVoxel, _unit, false))
@@ -1453,7 +1453,7 @@ void BattlescapeGame::primaryAction(Position pos)
 			if (_save->selectUnit(pos) && _save->selectUnit(pos)->getFaction() != _save->getSelectedUnit()->getFaction() && _save->selectUnit(pos)->getVisible())
 			{
 				if (!_currentAction.weapon->getRules()->isLOSRequired() ||
-					std::find(_currentAction.actor->getVisibleUnits()->begin(), _currentAction.actor->getVisibleUnits()->end(), _save->selectUnit(pos)) != _currentAction.actor->getVisibleUnits()->end())
+					_currentAction.actor->hasVisibleUnit(_save->selectUnit(pos)))
 				{
 					if (_currentAction.actor->spendTimeUnits(_currentAction.TU))
 					{
@@ -1479,7 +1479,7 @@ void BattlescapeGame::primaryAction(Position pos)
 				_currentAction.TU = _currentAction.actor->getActionTUs(_currentAction.type, _currentAction.weapon);
 				_currentAction.target = pos;
 				if (!_currentAction.weapon->getRules()->isLOSRequired() ||
-					std::find(_currentAction.actor->getVisibleUnits()->begin(), _currentAction.actor->getVisibleUnits()->end(), _save->selectUnit(pos)) != _currentAction.actor->getVisibleUnits()->end())
+					_currentAction.actor->hasVisibleUnit(_save->selectUnit(pos)))
 				{
 					// get the sound/animation started
 					getMap()->setCursorType(CT_NONE);
@@ -1712,7 +1712,8 @@ void BattlescapeGame::dropItem(Position position, BattleItem *item, bool newItem
 	if (item->getRules()->getBattleType() == BT_FLARE)
 	{
 		getTileEngine()->calculateTerrainLighting();
-		getTileEngine()->calculateFOV(position);
+		getTileEngine()->invalidateLight(position);
+		getTileEngine()->updateFOV();
 	}
 
 }
@@ -17,7 +17,6 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <assert.h>
-#include <fstream>
 #include <sstream>
 #include "BattlescapeGenerator.h"
 #include "TileEngine.h"
@@ -40,7 +39,6 @@
 #include "../Savegame/AlienBase.h"
 #include "../Savegame/EquipmentLayoutItem.h"
 #include "../Engine/Game.h"
-#include "../Engine/FileMap.h"
 #include "../Engine/Options.h"
 #include "../Engine/RNG.h"
 #include "../Engine/Exception.h"
@@ -70,7 +68,7 @@ static bool _addItem(BattleItem *item, BattleUnit *unit, Mod *mod, SavedBattleGa
  * @param game pointer to Game object.
  */
 BattlescapeGenerator::BattlescapeGenerator(Game *game) : _game(game), _save(game->getSavedGame()->getSavedBattle()), _mod(game->getMod()), _craft(0), _ufo(0), _base(0), _mission(0), _alienBase(0), _terrain(0), _mapsize_x(0), _mapsize_y(0), _mapsize_z(0),
-														 _worldTexture(0), _worldShade(0), _unitSequence(0), _craftInventoryTile(0), _alienItemLevel(0), _baseInventory(false), _generateFuel(true), _craftDeployed(false), _craftZ(0), _blocksToDo(0), _dummy(0)
+														 _worldTexture(0), _worldShade(0), _unitSequence(0), _craftInventoryTile(0), _alienItemLevel(0), _baseInventory(false), _generateFuel(true), _craftDeployed(false), _craftZ(0), _blocksToDo(0), _dummy(0), _ground(0), _rightHand(0)
 {
 	_allowAutoLoadout = !Options::disableAutoEquip;
 }
@@ -447,7 +445,7 @@ void BattlescapeGenerator::nextStage()
 			if (!(*j)->isOut())
 			{
 				(*j)->setTurnsSinceSpotted(255);
-				(*j)->getVisibleTiles()->clear();
+				(*j)->forgetVisibleTiles();
 				(*j)->setCache(0);
 				if (!selectedFirstSoldier && (*j)->getGeoscapeSoldier())
 				{
@@ -534,9 +532,7 @@ void BattlescapeGenerator::nextStage()
 	_save->setAborted(false);
 	setMusic(ruleDeploy, true);
 	_save->setGlobalShade(_worldShade);
-	_save->getTileEngine()->calculateSunShading();
-	_save->getTileEngine()->calculateTerrainLighting();
-	_save->getTileEngine()->calculateUnitLighting();
+	_save->getTileEngine()->calculateLighting();
 }
 
 /**
@@ -632,9 +628,7 @@ void BattlescapeGenerator::run()
 	// set shade (alien bases are a little darker, sites depend on worldshade)
 	_save->setGlobalShade(_worldShade);
 
-	_save->getTileEngine()->calculateSunShading();
-	_save->getTileEngine()->calculateTerrainLighting();
-	_save->getTileEngine()->calculateUnitLighting();
+	_save->getTileEngine()->calculateLighting();
 }
 
 /**
@@ -770,6 +764,7 @@ void BattlescapeGenerator::deployXCOM()
 	}
 
 	// equip soldiers based on equipment-layout
+	indexLayouts();
 	for (std::vector<BattleItem*>::iterator i = _craftInventoryTile->getInventory()->begin(); i != _craftInventoryTile->getInventory()->end(); ++i)
 	{
 		// set all the items on this tile as belonging to the XCOM faction.
@@ -790,6 +785,8 @@ void BattlescapeGenerator::deployXCOM()
 			continue;
 		placeItemByLayout(*i);
 	}
+	_layoutSlots.clear();
+	_layoutAmmo.clear();
 
 	// auto-equip soldiers (only soldiers without layout) and clean up moved items
 	autoEquip(*_save->getUnits(), _game->getMod(), _save, _craftInventoryTile->getInventory(), ground, _worldShade, _allowAutoLoadout, false);
@@ -1277,6 +1274,43 @@ BattleUnit *BattlescapeGenerator::addCivilian(Unit *rules)
 	return unit;
 }
 
+/**
+ * Builds the lookups used to equip soldiers by their layouts:
+ * every free layout slot by the item type it wants, in the order
+ * they should be filled, and every item on the craft tile by type.
+ * That way placing each item doesn't need to look through all the
+ * soldiers, their layouts and the whole craft inventory again.
+ */
+void BattlescapeGenerator::indexLayouts()
+{
+	_ground = _game->getMod()->getInventory("STR_GROUND", true);
+	_rightHand = _game->getMod()->getInventory("STR_RIGHT_HAND", true);
+	_layoutSlots.clear();
+	_layoutAmmo.clear();
+
+	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	{
+		// skip the vehicles, we need only X-Com soldiers WITH equipment-layout
+		if ((*i)->getArmor()->getSize() > 1 || !(*i)->getGeoscapeSoldier() || (*i)->getGeoscapeSoldier()->getEquipmentLayout()->empty())
+		{
+			continue;
+		}
+
+		std::vector<EquipmentLayoutItem*> *layoutItems = (*i)->getGeoscapeSoldier()->getEquipmentLayout();
+		for (std::vector<EquipmentLayoutItem*>::iterator j = layoutItems->begin(); j != layoutItems->end(); ++j)
+		{
+			_layoutSlots[(*j)->getItemType()].push_back(std::make_pair(*i, *j));
+		}
+	}
+
+	// stored back to front, so the first item on the tile is at the back
+	std::vector<BattleItem*> *inventory = _craftInventoryTile->getInventory();
+	for (std::vector<BattleItem*>::reverse_iterator i = inventory->rbegin(); i != inventory->rend(); ++i)
+	{
+		_layoutAmmo[(*i)->getRules()->getType()].push_back(*i);
+	}
+}
+
 /**
  * Places an item on an XCom soldier based on equipment layout.
  * @param item Pointer to the Item.
@@ -1284,66 +1318,72 @@ BattleUnit *BattlescapeGenerator::addCivilian(Unit *rules)
  */
 bool BattlescapeGenerator::placeItemByLayout(BattleItem *item)
 {
-	RuleInventory *ground = _game->getMod()->getInventory("STR_GROUND", true);
-	if (item->getSlot() == ground)
+	if (item->getSlot() != _ground)
 	{
-		bool loaded;
-		RuleInventory *righthand = _game->getMod()->getInventory("STR_RIGHT_HAND", true);
+		return false;
+	}
 
-		// find the first soldier with a matching layout-slot
-		for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	// find the first soldier with a matching layout-slot
+	std::map<std::string, std::list<std::pair<BattleUnit*, EquipmentLayoutItem*> > >::iterator slots = _layoutSlots.find(item->getRules()->getType());
+	if (slots == _layoutSlots.end())
+	{
+		return false;
+	}
+
+	for (std::list<std::pair<BattleUnit*, EquipmentLayoutItem*> >::iterator j = slots->second.begin(); j != slots->second.end();)
+	{
+		BattleUnit *unit = j->first;
+		EquipmentLayoutItem *layout = j->second;
+
+		// an occupied slot never frees up again, forget about it
+		if (unit->getItem(layout->getSlot(), layout->getSlotX(), layout->getSlotY()))
 		{
-			// skip the vehicles, we need only X-Com soldiers WITH equipment-layout
-			if ((*i)->getArmor()->getSize() > 1 || !(*i)->getGeoscapeSoldier() || (*i)->getGeoscapeSoldier()->getEquipmentLayout()->empty())
-			{
-				continue;
-			}
+			j = slots->second.erase(j);
+			continue;
+		}
 
-			// find the first matching layout-slot which is not already occupied
-			std::vector<EquipmentLayoutItem*> *layoutItems = (*i)->getGeoscapeSoldier()->getEquipmentLayout();
-			for (std::vector<EquipmentLayoutItem*>::iterator j = layoutItems->begin(); j != layoutItems->end(); ++j)
+		bool loaded = true;
+		if (layout->getAmmoItem() != "NONE")
+		{
+			loaded = false;
+			// maybe we find the layout-ammo on the ground to load it with
+			std::map<std::string, std::vector<BattleItem*> >::iterator ammo = _layoutAmmo.find(layout->getAmmoItem());
+			if (ammo != _layoutAmmo.end())
 			{
-				if (item->getRules()->getType() != (*j)->getItemType()
-				|| (*i)->getItem((*j)->getSlot(), (*j)->getSlotX(), (*j)->getSlotY())) continue;
-
-				if ((*j)->getAmmoItem() == "NONE")
+				std::vector<BattleItem*> &clips = ammo->second;
+				while (!clips.empty() && clips.back()->getSlot() != _ground)
 				{
-					loaded = true;
+					clips.pop_back();
 				}
-				else
+				if (!clips.empty() && item->setAmmoItem(clips.back()) == 0)
 				{
-					loaded = false;
-					// maybe we find the layout-ammo on the ground to load it with
-					for (std::vector<BattleItem*>::iterator k = _craftInventoryTile->getInventory()->begin(); (!loaded) && k != _craftInventoryTile->getInventory()->end(); ++k)
-					{
-						if ((*k)->getRules()->getType() == (*j)->getAmmoItem() && (*k)->getSlot() == ground
-						&& item->setAmmoItem((*k)) == 0)
-						{
-							_save->getItems()->push_back(*k);
-							(*k)->setSlot(righthand);
-							loaded = true;
-							// note: soldier is not owner of the ammo, we are using this fact when saving equipments
-						}
-					}
-				}
-				// only place the weapon onto the soldier when it's loaded with its layout-ammo (if any)
-				if (loaded)
-				{
-					item->moveToOwner((*i));
-					item->setSlot(_game->getMod()->getInventory((*j)->getSlot(), true));
-					item->setSlotX((*j)->getSlotX());
-					item->setSlotY((*j)->getSlotY());
-					if (Options::includePrimeStateInSavedLayout &&
-						(item->getRules()->getBattleType() == BT_GRENADE ||
-						item->getRules()->getBattleType() == BT_PROXIMITYGRENADE))
-					{
-						item->setFuseTimer((*j)->getFuseTimer());
-					}
-					_save->getItems()->push_back(item);
-					return true;
+					BattleItem *clip = clips.back();
+					clips.pop_back();
+					_save->getItems()->push_back(clip);
+					clip->setSlot(_rightHand);
+					loaded = true;
+					// note: soldier is not owner of the ammo, we are using this fact when saving equipments
 				}
 			}
 		}
+		// only place the weapon onto the soldier when it's loaded with its layout-ammo (if any)
+		if (loaded)
+		{
+			item->moveToOwner(unit);
+			item->setSlot(_game->getMod()->getInventory(layout->getSlot(), true));
+			item->setSlotX(layout->getSlotX());
+			item->setSlotY(layout->getSlotY());
+			if (Options::includePrimeStateInSavedLayout &&
+				(item->getRules()->getBattleType() == BT_GRENADE ||
+				item->getRules()->getBattleType() == BT_PROXIMITYGRENADE))
+			{
+				item->setFuseTimer(layout->getFuseTimer());
+			}
+			_save->getItems()->push_back(item);
+			slots->second.erase(j);
+			return true;
+		}
+		++j;
 	}
 	return false;
 }
@@ -1561,20 +1601,18 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 {
 	int sizex, sizey, sizez;
 	int x = xoff, y = yoff, z = 0;
-	char size[3];
-	unsigned char value[4];
 	std::ostringstream filename;
 	filename << "MAPS/" << mapblock->getName() << ".MAP";
 	unsigned int terrainObjectID;
 
-	// Load file
-	std::ifstream mapFile (FileMap::getFilePath(filename.str()).c_str(), std::ios::in| std::ios::binary);
-	if (!mapFile)
+	// The block keeps the file around for the next map that uses it
+	const std::vector<char> &mapFile = mapblock->getMapData();
+	if (mapFile.size() < 3)
 	{
-		throw Exception(filename.str() + " not found");
+		throw Exception("Invalid MAP file: " + filename.str());
 	}
 
-	mapFile.read((char*)&size, sizeof(size));
+	const char *size = &mapFile[0];
 	sizey = (int)size[0];
 	sizex = (int)size[1];
 	sizez = (int)size[2];
@@ -1623,8 +1661,9 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 		throw Exception("Something is wrong in your map definitions, craft/ufo map is too tall?");
 	}
 
-	while (mapFile.read((char*)&value, sizeof(value)))
+	for (size_t offset = 3; offset + 4 <= mapFile.size(); offset += 4)
 	{
+		const char *value = &mapFile[offset];
 		for (int part = O_FLOOR; part <= O_OBJECT; ++part)
 		{
 			terrainObjectID = ((unsigned char)value[part]);
@@ -1658,13 +1697,6 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 		}
 	}
 
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid MAP file: " + filename.str());
-	}
-
-	mapFile.close();
-
 	if (_generateFuel)
 	{
 		// if one of the mapBlocks has an items array defined, don't deploy fuel algorithmically
@@ -1693,22 +1725,18 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
  */
 void BattlescapeGenerator::loadRMP(MapBlock *mapblock, int xoff, int yoff, int segment)
 {
-	unsigned char value[24];
 	std::ostringstream filename;
 	filename << "ROUTES/" << mapblock->getName() << ".RMP";
 
-	// Load file
-	std::ifstream mapFile (FileMap::getFilePath(filename.str()).c_str(), std::ios::in| std::ios::binary);
-	if (!mapFile)
-	{
-		throw Exception(filename.str() + " not found");
-	}
+	// The block keeps the file around for the next map that uses it
+	const std::vector<char> &routeFile = mapblock->getRouteData();
 
 	size_t nodeOffset = _save->getNodes()->size();
 	std::vector<int> badNodes;
 	int nodesAdded = 0;
-	while (mapFile.read((char*)&value, sizeof(value)))
+	for (size_t offset = 0; offset + 24 <= routeFile.size(); offset += 24)
 	{
+		const unsigned char *value = (const unsigned char*)&routeFile[offset];
 		int pos_x = value[1];
 		int pos_y = value[0];
 		int pos_z = value[2];
@@ -1775,13 +1803,6 @@ void BattlescapeGenerator::loadRMP(MapBlock *mapblock, int xoff, int yoff, int s
 			nodeCounter--;
 		}
 	}
-
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid RMP file: " + filename.str());
-	}
-
-	mapFile.close();
 }
 
 /**
@@ -2980,6 +3001,76 @@ void BattlescapeGenerator::setTerrain(RuleTerrain *terrain)
 	_terrain = terrain;
 }
 
+/**
+ * Starts loading the terrain data for the battle a craft
+ * is headed for in the background. The terrain is picked
+ * at random once the craft lands, so every terrain run()
+ * could pick is fetched, along with the UFO and craft maps.
+ * @param mod Pointer to the mod.
+ * @param craft Pointer to the craft on its way.
+ * @param texture Texture of the landing site, if any.
+ */
+void BattlescapeGenerator::prefetchTerrain(Mod *mod, Craft *craft, Texture *texture)
+{
+	Target *target = craft->getDestination();
+	Ufo *ufo = dynamic_cast<Ufo*>(target);
+	MissionSite *site = dynamic_cast<MissionSite*>(target);
+	AlienBase *base = dynamic_cast<AlienBase*>(target);
+	const AlienDeployment *ruleDeploy = 0;
+	if (ufo != 0)
+		ruleDeploy = mod->getDeployment(ufo->getRules()->getType());
+	else if (site != 0)
+		ruleDeploy = site->getDeployment();
+	else if (base != 0)
+		ruleDeploy = base->getDeployment();
+	if (ruleDeploy == 0)
+	{
+		return;
+	}
+
+	std::vector<RuleTerrain*> terrains;
+	std::vector<std::string> deployTerrains = ruleDeploy->getTerrains();
+	if (texture == 0 || texture->getTerrain()->empty() || !deployTerrains.empty())
+	{
+		if (deployTerrains.empty() && !mod->getTerrainList().empty())
+		{
+			deployTerrains.push_back(mod->getTerrainList().front());
+		}
+		for (std::vector<std::string>::const_iterator i = deployTerrains.begin(); i != deployTerrains.end(); ++i)
+		{
+			terrains.push_back(mod->getTerrain(*i));
+		}
+	}
+	else
+	{
+		// same criteria as Texture::getRandomTerrain, without rolling the dice
+		for (std::vector<TerrainCriteria>::const_iterator i = texture->getTerrain()->begin(); i != texture->getTerrain()->end(); ++i)
+		{
+			if (i->weight > 0 &&
+				target->getLongitude() >= i->lonMin && target->getLongitude() < i->lonMax &&
+				target->getLatitude() >= i->latMin && target->getLatitude() < i->latMax)
+			{
+				terrains.push_back(mod->getTerrain(i->name));
+			}
+		}
+	}
+	if (ufo != 0)
+	{
+		terrains.push_back(ufo->getRules()->getBattlescapeTerrainData());
+	}
+	terrains.push_back(craft->getRules()->getBattlescapeTerrainData());
+
+	for (std::vector<RuleTerrain*>::const_iterator i = terrains.begin(); i != terrains.end(); ++i)
+	{
+		if (*i == 0)
+			continue;
+		for (std::vector<MapDataSet*>::iterator j = (*i)->getMapDataSets()->begin(); j != (*i)->getMapDataSets()->end(); ++j)
+		{
+			(*j)->prefetchData(mod->getMCDPatch((*j)->getName()));
+		}
+	}
+}
+
 
 /**
  * Sets up the objectives for the map.
@@ -18,6 +18,9 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <vector>
+#include <list>
+#include <map>
+#include <string>
 #include "../Mod/RuleTerrain.h"
 #include "../Mod/MapScript.h"
 
@@ -43,6 +46,7 @@ class MissionSite;
 class AlienBase;
 class BattleUnit;
 class Texture;
+class EquipmentLayoutItem;
 
 /**
  * A utility class that generates the initial battlescape data. Taking into account mission type, craft and ufo involved, terrain type,...
@@ -75,6 +79,9 @@ private:
 	std::vector< std::vector<bool> > _landingzone;
 	std::vector< std::vector<int> > _segments, _drillMap;
 	MapBlock *_dummy;
+	std::map<std::string, std::list<std::pair<BattleUnit*, EquipmentLayoutItem*> > > _layoutSlots;
+	std::map<std::string, std::vector<BattleItem*> > _layoutAmmo;
+	RuleInventory *_ground, *_rightHand;
 
 	/// sets the map size and associated vars
 	void init(bool resetTerrain);
@@ -88,6 +95,8 @@ private:
 	BattleUnit *addAlien(Unit *rules, int alienRank, bool outside);
 	/// Adds a civlian to the game.
 	BattleUnit *addCivilian(Unit *rules);
+	/// Indexes the equipment layouts and the craft's items by type.
+	void indexLayouts();
 	/// Places an item on a soldier based on equipment layout.
 	bool placeItemByLayout(BattleItem *item);
 	/// Adds an item to a unit and the game.
@@ -172,6 +181,8 @@ public:
 	// Autoequip a set of units
 	static void autoEquip(std::vector<BattleUnit*> units, Mod *mod, SavedBattleGame *addToSave, std::vector<BattleItem*> *craftInv,
 		RuleInventory *groundRuleInv, int worldShade, bool allowAutoLoadout, bool overrideEquipmentLayout);
+	/// Prefetches the terrains a craft may land on.
+	static void prefetchTerrain(Mod *mod, Craft *craft, Texture *texture);
 };
 
 }
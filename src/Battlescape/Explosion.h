@@ -17,7 +17,9 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <cstddef>
 #include "Position.h"
+#include "../Engine/ObjectPool.h"
 
 namespace OpenXcom
 {
@@ -40,6 +42,7 @@ public:
 	Explosion(Position _position, int startFrame, int frameDelay = 0, bool big = false, bool hit = false);
 	/// Cleans up the Explosion.
 	~Explosion();
+	OXC_POOLED_OBJECT(Explosion)
 	/// Moves the Explosion on one frame.
 	bool animate();
 	/// Gets the current position in voxel space.
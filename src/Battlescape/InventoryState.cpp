@@ -260,7 +260,7 @@ InventoryState::~InventoryState()
 		Tile *inventoryTile = _battleGame->getSelectedUnit()->getTile();
 		_battleGame->getTileEngine()->applyGravity(inventoryTile);
 		_battleGame->getTileEngine()->calculateTerrainLighting(); // dropping/picking up flares
-		_battleGame->getTileEngine()->recalculateFOV();
+		_battleGame->getTileEngine()->recalculateFOV(true); // only the light changed
 	}
 	else
 	{
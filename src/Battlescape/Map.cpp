@@ -33,6 +33,7 @@
 #include "../Engine/Palette.h"
 #include "../Engine/Game.h"
 #include "../Engine/Screen.h"
+#include "../Engine/Profiler.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Tile.h"
 #include "../Savegame/BattleUnit.h"
@@ -486,6 +487,7 @@ void Map::drawUnit(Surface *surface, Tile *unitTile, Tile *currTile, Position cu
  */
 void Map::drawTerrain(Surface *surface)
 {
+	PROFILE_SCOPE("Map::drawTerrain");
 	int frameNumber = 0;
 	Surface *tmpSurface;
 	Tile *tile;
@@ -55,33 +55,46 @@ MiniMapView::MiniMapView(int w, int h, int x, int y, Game * game, Camera * camer
 }
 
 /**
- * Draws the minimap.
+ * Deletes the cached terrain.
  */
-void MiniMapView::draw()
+MiniMapView::~MiniMapView()
 {
-	int _startX = _camera->getCenterPosition().x - ((getWidth() / CELL_WIDTH) / 2);
-	int _startY = _camera->getCenterPosition().y - ((getHeight() / CELL_HEIGHT) / 2);
+	for (std::vector<Surface*>::iterator i = _terrain.begin(); i != _terrain.end(); ++i)
+	{
+		delete *i;
+	}
+}
 
-	InteractiveSurface::draw();
-	if (!_set)
+/**
+ * Gets the terrain of the whole map as seen from a level, with every
+ * level below it drawn underneath. It's drawn the first time the level
+ * is shown; the battle is paused while the minimap is open, so the
+ * tiles can't change afterwards and scrolling only has to blit it.
+ * @param level Highest level drawn.
+ * @return Surface with one cell per tile, transparent where there's no terrain.
+ */
+Surface *MiniMapView::getTerrain(int level)
+{
+	if ((int)_terrain.size() <= level)
 	{
-		return;
+		_terrain.resize(level + 1, 0);
 	}
-	drawRect(0, 0, getWidth(), getHeight(), 15);
-	this->lock();
-	for (int lvl = 0; lvl <= _camera->getCenterPosition().z; lvl++)
+	if (_terrain[level] != 0)
+	{
+		return _terrain[level];
+	}
+
+	Surface *terrain = new Surface(_battleGame->getMapSizeX() * CELL_WIDTH, _battleGame->getMapSizeY() * CELL_HEIGHT);
+	terrain->lock();
+	for (int lvl = 0; lvl <= level; lvl++)
 	{
-		int py = _startY;
-		for (int y = Surface::getY(); y < getHeight() + Surface::getY(); y += CELL_HEIGHT)
+		for (int py = 0; py < _battleGame->getMapSizeY(); py++)
 		{
-			int px = _startX;
-			for (int x = Surface::getX(); x < getWidth() + Surface::getX(); x += CELL_WIDTH)
+			for (int px = 0; px < _battleGame->getMapSizeX(); px++)
 			{
-				Position p(px, py, lvl);
-				Tile *t = _battleGame->getTile(p);
+				Tile *t = _battleGame->getTile(Position(px, py, lvl));
 				if (!t)
 				{
-					px++;
 					continue;
 				}
 				for (int i = O_FLOOR; i <= O_OBJECT; i++)
@@ -99,39 +112,101 @@ void MiniMapView::draw()
 								shade = t->getShade();
 								if (shade > 7) shade = 7; //vanilla
 							}
-							s->blitNShade(this, x, y, shade);
+							s->blitNShade(terrain, px * CELL_WIDTH, py * CELL_HEIGHT, shade);
 						}
 					}
 				}
-				// alive units
-				if (t->getUnit() && t->getUnit()->getVisible())
+			}
+		}
+	}
+	terrain->unlock();
+	_terrain[level] = terrain;
+	return terrain;
+}
+
+/**
+ * Gets where the cell of a map position is drawn on the minimap.
+ * Cells start at the surface offset and only as many as fit are drawn.
+ * @param pos Map position.
+ * @param startX First map column shown.
+ * @param startY First map row shown.
+ * @param x Receives the X position of the cell.
+ * @param y Receives the Y position of the cell.
+ * @return True if the cell is in view.
+ */
+bool MiniMapView::getCellPosition(Position pos, int startX, int startY, int &x, int &y) const
+{
+	x = Surface::getX() + (pos.x - startX) * CELL_WIDTH;
+	y = Surface::getY() + (pos.y - startY) * CELL_HEIGHT;
+	return pos.x >= startX && pos.y >= startY && x < getWidth() + Surface::getX() && y < getHeight() + Surface::getY();
+}
+
+/**
+ * Draws the minimap: the cached terrain, then the units
+ * and items on top of it.
+ */
+void MiniMapView::draw()
+{
+	int _startX = _camera->getCenterPosition().x - ((getWidth() / CELL_WIDTH) / 2);
+	int _startY = _camera->getCenterPosition().y - ((getHeight() / CELL_HEIGHT) / 2);
+	int level = _camera->getCenterPosition().z;
+
+	InteractiveSurface::draw();
+	if (!_set)
+	{
+		return;
+	}
+	drawRect(0, 0, getWidth(), getHeight(), 15);
+	this->lock();
+	int columns = (getWidth() + CELL_WIDTH - 1) / CELL_WIDTH;
+	int rows = (getHeight() + CELL_HEIGHT - 1) / CELL_HEIGHT;
+	GraphSubset range(std::make_pair(Surface::getX(), Surface::getX() + columns * CELL_WIDTH), std::make_pair(Surface::getY(), Surface::getY() + rows * CELL_HEIGHT));
+	getTerrain(level)->blitNShade(this, Surface::getX() - _startX * CELL_WIDTH, Surface::getY() - _startY * CELL_HEIGHT, 0, range);
+
+	int x, y;
+	// alive units
+	for (std::vector<BattleUnit*>::iterator i = _battleGame->getUnits()->begin(); i != _battleGame->getUnits()->end(); ++i)
+	{
+		BattleUnit *unit = *i;
+		if (!unit->getVisible())
+		{
+			continue;
+		}
+		int size = unit->getArmor()->getSize();
+		for (int ux = 0; ux < size; ux++)
+		{
+			for (int uy = 0; uy < size; uy++)
+			{
+				Tile *t = _battleGame->getTile(unit->getPosition() + Position(ux, uy, 0));
+				if (!t || t->getUnit() != unit || t->getPosition().z > level || !getCellPosition(t->getPosition(), _startX, _startY, x, y))
 				{
-					int frame = t->getUnit()->getMiniMapSpriteIndex();
-					int size = t->getUnit()->getArmor()->getSize();
-					frame += (t->getPosition().y - t->getUnit()->getPosition().y) * size;
-					frame += t->getPosition().x - t->getUnit()->getPosition().x;
-					frame += _frame * size * size;
-					Surface * s = _set->getFrame(frame);
-					if (size > 1 && t->getUnit()->getFaction() == FACTION_NEUTRAL)
-					{
-						s->blitNShade(this, x, y, 0, false, Pathfinding::red);
-					}
-					else
-					{
-						s->blitNShade(this, x, y, 0);
-					}
+					continue;
 				}
-				// perhaps (at least one) item on this tile?
-				if (t->isDiscovered(2) && !t->getInventory()->empty())
+				int frame = unit->getMiniMapSpriteIndex();
+				frame += uy * size;
+				frame += ux;
+				frame += _frame * size * size;
+				Surface * s = _set->getFrame(frame);
+				if (size > 1 && unit->getFaction() == FACTION_NEUTRAL)
+				{
+					s->blitNShade(this, x, y, 0, false, Pathfinding::red);
+				}
+				else
 				{
-					int frame = 9 + _frame;
-					Surface * s = _set->getFrame(frame);
 					s->blitNShade(this, x, y, 0);
 				}
-
-				px++;
 			}
-			py++;
+		}
+	}
+	// perhaps (at least one) item on this tile?
+	for (std::vector<BattleItem*>::iterator i = _battleGame->getItems()->begin(); i != _battleGame->getItems()->end(); ++i)
+	{
+		Tile *t = (*i)->getTile();
+		if (t && t->isDiscovered(2) && t->getPosition().z <= level && getCellPosition(t->getPosition(), _startX, _startY, x, y))
+		{
+			int frame = 9 + _frame;
+			Surface * s = _set->getFrame(frame);
+			s->blitNShade(this, x, y, 0);
 		}
 	}
 	this->unlock();
@@ -17,6 +17,7 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <vector>
 #include "../Engine/InteractiveSurface.h"
 #include "Position.h"
 
@@ -47,6 +48,11 @@ class MiniMapView : public InteractiveSurface
 	Uint32 _mouseScrollingStartTime;
 	int _totalMouseMoveX, _totalMouseMoveY;
 	bool _mouseMovedOverThreshold;
+	std::vector<Surface*> _terrain;
+	/// Gets the terrain of the whole map up to a level.
+	Surface *getTerrain(int level);
+	/// Gets where a map position is drawn, if it's in view.
+	bool getCellPosition(Position pos, int startX, int startY, int &x, int &y) const;
 	/// Handles pressing on the MiniMap.
 	void mousePress(Action *action, State *state);
 	/// Handles clicking on the MiniMap.
@@ -58,6 +64,8 @@ class MiniMapView : public InteractiveSurface
 public:
 	/// Creates the MiniMapView.
 	MiniMapView(int w, int h, int x, int y, Game * game, Camera * camera, SavedBattleGame * battleGame);
+	/// Cleans up the MiniMapView.
+	~MiniMapView();
 	/// Draws the minimap.
 	void draw();
 	/// Changes the displayed minimap level.
@@ -19,6 +19,7 @@
  */
 #include <SDL_types.h>
 #include <algorithm>
+#include "../Engine/ObjectPool.h"
 
 namespace OpenXcom
 {
@@ -33,6 +34,7 @@ public:
 	Particle(float xOffset, float yOffset, float density, Uint8 color, Uint8 opacity);
 	/// Destroy a particle.
 	~Particle();
+	OXC_POOLED_OBJECT(Particle)
 	/// Animate a particle.
 	bool animate();
 	/// Get the size value.
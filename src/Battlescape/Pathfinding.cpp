@@ -25,6 +25,7 @@
 #include "../Mod/Armor.h"
 #include "../Savegame/BattleUnit.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "BattlescapeGame.h"
 
 namespace OpenXcom
@@ -79,6 +80,7 @@ PathfindingNode *Pathfinding::getNode(Position pos)
  */
 void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *target, int maxTUCost)
 {
+	PROFILE_SCOPE("Pathfinding::calculate");
 	_totalTUCost = 0;
 	_path.clear();
 	// i'm DONE with these out of bounds errors.
@@ -634,7 +636,7 @@ bool Pathfinding::isBlocked(Tile *tile, const int part, BattleUnit *missileTarge
 				if (_unit->getFaction() == FACTION_PLAYER && unit->getVisible()) return true;		// player know all visible units
 				if (_unit->getFaction() == unit->getFaction()) return true;
 				if (_unit->getFaction() == FACTION_HOSTILE &&
-					std::find(_unit->getUnitsSpottedThisTurn().begin(), _unit->getUnitsSpottedThisTurn().end(), unit) != _unit->getUnitsSpottedThisTurn().end()) return true;
+					_unit->hasSpottedUnit(unit)) return true;
 			}
 		}
 		else if (tile->hasNoFloor(0) && _movementType != MT_FLY) // this whole section is devoted to making large units not take part in any kind of falling behaviour
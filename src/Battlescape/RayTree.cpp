@@ -0,0 +1,254 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "RayTree.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace OpenXcom
+{
+
+/**
+ * Traces a ray to every target and merges the rays
+ * into a tree rooted at the eye.
+ * @param targets Target offsets relative to the eye.
+ */
+RayTree::RayTree(const std::vector<Position> &targets)
+{
+	std::vector<Position> offsets(1, Position(0, 0, 0));
+	std::vector<std::vector<int> > children(1);
+	std::vector<int> ends(1, -1);
+	std::vector<Position> line;
+	for (size_t t = 0; t < targets.size(); ++t)
+	{
+		line.clear();
+		traceLine(targets[t], line);
+		int node = 0;
+		// the first tile of every ray is the eye itself
+		for (size_t i = 1; i < line.size(); ++i)
+		{
+			int next = -1;
+			for (std::vector<int>::const_iterator c = children[node].begin(); c != children[node].end(); ++c)
+			{
+				if (offsets[*c] == line[i])
+				{
+					next = *c;
+					break;
+				}
+			}
+			if (next == -1)
+			{
+				next = (int)offsets.size();
+				offsets.push_back(line[i]);
+				children.push_back(std::vector<int>());
+				ends.push_back(-1);
+				children[node].push_back(next);
+			}
+			node = next;
+		}
+		ends[node] = (int)t;
+	}
+
+	_nodes.reserve(offsets.size());
+	_targets.reserve(targets.size());
+	flatten(0, -1, 0, offsets, children, ends);
+	for (std::vector<RayNode>::iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+	{
+		for (int t = i->firstTarget; t != i->endTarget; ++t)
+		{
+			const Position &target = _targets[t];
+			if (t == i->firstTarget)
+			{
+				i->minTarget = i->maxTarget = target;
+			}
+			i->minTarget = Position(std::min(i->minTarget.x, target.x), std::min(i->minTarget.y, target.y), std::min(i->minTarget.z, target.z));
+			i->maxTarget = Position(std::max(i->maxTarget.x, target.x), std::max(i->maxTarget.y, target.y), std::max(i->maxTarget.z, target.z));
+		}
+	}
+
+	_lookup.reserve(_nodes.size());
+	for (int i = 0; i < size(); ++i)
+	{
+		_lookup.push_back(std::make_pair(getKey(_nodes[i].offset), i));
+	}
+	std::sort(_lookup.begin(), _lookup.end());
+}
+
+/**
+ *
+ */
+RayTree::~RayTree()
+{
+}
+
+/**
+ * Appends a node and then its children, keeping
+ * the targets of every subtree next to each other.
+ * @param node Node being stored.
+ * @param parent Stored index of its parent.
+ * @param depth Number of tiles before it on its rays.
+ * @param offsets Offsets of the unsorted nodes.
+ * @param children Children of the unsorted nodes.
+ * @param targets Target reached at each unsorted node, or -1.
+ */
+void RayTree::flatten(int node, int parent, int depth, const std::vector<Position> &offsets, const std::vector<std::vector<int> > &children, const std::vector<int> &targets)
+{
+	int index = (int)_nodes.size();
+	RayNode ray;
+	ray.offset = offsets[node];
+	ray.parent = parent;
+	ray.depth = depth;
+	ray.firstTarget = (int)_targets.size();
+	_nodes.push_back(ray);
+	if (targets[node] != -1)
+	{
+		_targets.push_back(offsets[node]);
+	}
+	for (std::vector<int>::const_iterator i = children[node].begin(); i != children[node].end(); ++i)
+	{
+		flatten(*i, index, depth + 1, offsets, children, targets);
+	}
+	_nodes[index].end = (int)_nodes.size();
+	_nodes[index].endTarget = (int)_targets.size();
+}
+
+/**
+ * Packs an offset into a key, offsets are well within a byte per axis.
+ * @param offset Offset relative to the eye.
+ * @return Key.
+ */
+int RayTree::getKey(const Position &offset)
+{
+	return ((offset.x + 128) << 16) | ((offset.y + 128) << 8) | (offset.z + 128);
+}
+
+/**
+ * Finds the nodes at an offset, there can be several
+ * when rays pass through the same tile from different tiles.
+ * @param offset Offset relative to the eye.
+ * @param nodes Receives the node indices.
+ */
+void RayTree::getNodesAt(const Position &offset, std::vector<int> &nodes) const
+{
+	if (offset.x < -128 || offset.x > 127 || offset.y < -128 || offset.y > 127 || offset.z < -128 || offset.z > 127)
+	{
+		return;
+	}
+	std::vector<std::pair<int, int> >::const_iterator i = std::lower_bound(_lookup.begin(), _lookup.end(), std::make_pair(getKey(offset), -1));
+	for (; i != _lookup.end() && i->first == getKey(offset); ++i)
+	{
+		nodes.push_back(i->second);
+	}
+}
+
+/**
+ * Counts the rays through a node whose target
+ * lies within some bounds, eg. inside the map.
+ * @param node Node index.
+ * @param min Lowest target offset allowed.
+ * @param max Highest target offset allowed.
+ * @return Number of rays.
+ */
+int RayTree::countTargets(int node, const Position &min, const Position &max) const
+{
+	const RayNode &ray = _nodes[node];
+	if (ray.maxTarget.x < min.x || ray.maxTarget.y < min.y || ray.maxTarget.z < min.z ||
+		ray.minTarget.x > max.x || ray.minTarget.y > max.y || ray.minTarget.z > max.z)
+	{
+		return 0;
+	}
+	if (ray.minTarget.x >= min.x && ray.minTarget.y >= min.y && ray.minTarget.z >= min.z &&
+		ray.maxTarget.x <= max.x && ray.maxTarget.y <= max.y && ray.maxTarget.z <= max.z)
+	{
+		return ray.endTarget - ray.firstTarget;
+	}
+	int count = 0;
+	for (int i = ray.firstTarget; i != ray.endTarget; ++i)
+	{
+		const Position &target = _targets[i];
+		if (target.x >= min.x && target.y >= min.y && target.z >= min.z &&
+			target.x <= max.x && target.y <= max.y && target.z <= max.z)
+		{
+			count++;
+		}
+	}
+	return count;
+}
+
+/**
+ * Traces the tiles from the eye to a target with the same
+ * 3D bresenham steps as TileEngine::calculateLine, so the
+ * tree sees exactly what the tile visibility check saw.
+ * @param target Target offset relative to the eye.
+ * @param line Receives the tiles of the ray, eye first.
+ */
+void RayTree::traceLine(const Position &target, std::vector<Position> &line)
+{
+	int x0 = 0, x1 = target.x;
+	int y0 = 0, y1 = target.y;
+	int z0 = 0, z1 = target.z;
+
+	bool swap_xy = abs(y1 - y0) > abs(x1 - x0);
+	if (swap_xy)
+	{
+		std::swap(x0, y0);
+		std::swap(x1, y1);
+	}
+	bool swap_xz = abs(z1 - z0) > abs(x1 - x0);
+	if (swap_xz)
+	{
+		std::swap(x0, z0);
+		std::swap(x1, z1);
+	}
+
+	int delta_x = abs(x1 - x0);
+	int delta_y = abs(y1 - y0);
+	int delta_z = abs(z1 - z0);
+	int drift_xy = (delta_x / 2);
+	int drift_xz = (delta_x / 2);
+	int step_x = x0 > x1 ? -1 : 1;
+	int step_y = y0 > y1 ? -1 : 1;
+	int step_z = z0 > z1 ? -1 : 1;
+
+	int y = y0;
+	int z = z0;
+	for (int x = x0;; x += step_x)
+	{
+		int cx = x, cy = y, cz = z;
+		if (swap_xz) std::swap(cx, cz);
+		if (swap_xy) std::swap(cx, cy);
+		line.push_back(Position(cx, cy, cz));
+
+		if (x == x1) break;
+
+		drift_xy = drift_xy - delta_y;
+		drift_xz = drift_xz - delta_z;
+		if (drift_xy < 0)
+		{
+			y = y + step_y;
+			drift_xy = drift_xy + delta_x;
+		}
+		if (drift_xz < 0)
+		{
+			z = z + step_z;
+			drift_xz = drift_xz + delta_x;
+		}
+	}
+}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include "Position.h"
+
+namespace OpenXcom
+{
+
+/// How far the rays through a node get.
+enum RayStep { RAY_OPEN, RAY_LAST, RAY_BLOCKED };
+
+/**
+ * A tile on one or more rays, with the rays
+ * continuing past it stored right after it.
+ */
+struct RayNode
+{
+	Position offset;
+	int parent, depth;
+	/// One past the last node of this subtree.
+	int end;
+	/// Range of the targets reached through this node.
+	int firstTarget, endTarget;
+	/// Bounding box of the targets reached through this node.
+	Position minTarget, maxTarget;
+};
+
+/**
+ * Tile-space rays from an eye to a set of target offsets,
+ * merged into a tree so rays sharing their first tiles
+ * share their nodes. Nodes are stored depth-first, so a
+ * whole subtree can be skipped once its root is blocked.
+ */
+class RayTree
+{
+private:
+	std::vector<RayNode> _nodes;
+	std::vector<Position> _targets;
+	/// Node indices sorted by their packed offset.
+	std::vector<std::pair<int, int> > _lookup;
+	/// Packs an offset into a sortable key.
+	static int getKey(const Position &offset);
+	/// Stores a subtree in depth-first order.
+	void flatten(int node, int parent, int depth, const std::vector<Position> &offsets, const std::vector<std::vector<int> > &children, const std::vector<int> &targets);
+public:
+	/// Builds the rays to a set of target offsets.
+	RayTree(const std::vector<Position> &targets);
+	/// Cleans up the ray tree.
+	~RayTree();
+	/// Gets the number of nodes.
+	int size() const { return (int)_nodes.size(); }
+	/// Gets a node.
+	const RayNode &getNode(int node) const { return _nodes[node]; }
+	/// Gets the indices of the nodes at an offset.
+	void getNodesAt(const Position &offset, std::vector<int> &nodes) const;
+	/// Counts the targets reached through a node within some bounds.
+	int countTargets(int node, const Position &min, const Position &max) const;
+	/// Gets the tiles of a ray, as traced by TileEngine::calculateLine.
+	static void traceLine(const Position &target, std::vector<Position> &line);
+};
+
+}
@@ -17,10 +17,12 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <assert.h>
+#include <algorithm>
 #include <climits>
 #include <set>
 #include "TileEngine.h"
 #include <SDL.h>
+#include <SDL_thread.h>
 #include "AIModule.h"
 #include "Map.h"
 #include "Camera.h"
@@ -38,7 +40,9 @@
 #include "../Mod/Mod.h"
 #include "../Mod/Armor.h"
 #include "Pathfinding.h"
+#include "RayTree.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "ProjectileFlyBState.h"
 #include "MeleeAttackBState.h"
 #include "../fmath.h"
@@ -48,6 +52,61 @@ namespace OpenXcom
 
 const int TileEngine::heightFromCenter[11] = {0,-2,+2,-4,+4,-6,+6,-8,+8,-12,+12};
 
+namespace
+{
+
+const int fireLightPower = 15; // amount of light a fire generates
+/// Maps with fewer tiles than this are lit on one thread.
+const int PARALLEL_LIGHTING_TILES = 8192;
+const int LIGHTING_THREADS = 4;
+
+/**
+ * Gathers the terrain lights of a tile: lit floors and objects, fire and flares.
+ * @param tile Tile to check.
+ * @param lights Receives the position and power of each light.
+ */
+void gatherLightSources(Tile *tile, std::vector<std::pair<Position, int> > &lights)
+{
+	// only floors and objects can light up
+	if (tile->getMapData(O_FLOOR)
+		&& tile->getMapData(O_FLOOR)->getLightSource())
+	{
+		lights.push_back(std::make_pair(tile->getPosition(), tile->getMapData(O_FLOOR)->getLightSource()));
+	}
+	if (tile->getMapData(O_OBJECT)
+		&& tile->getMapData(O_OBJECT)->getLightSource())
+	{
+		lights.push_back(std::make_pair(tile->getPosition(), tile->getMapData(O_OBJECT)->getLightSource()));
+	}
+
+	// fires
+	if (tile->getFire())
+	{
+		lights.push_back(std::make_pair(tile->getPosition(), fireLightPower));
+	}
+
+	for (std::vector<BattleItem*>::iterator it = tile->getInventory()->begin(); it != tile->getInventory()->end(); ++it)
+	{
+		if ((*it)->getRules()->getBattleType() == BT_FLARE)
+		{
+			lights.push_back(std::make_pair(tile->getPosition(), (*it)->getRules()->getPower()));
+		}
+	}
+}
+
+}
+
+/**
+ * Part of the map lit by one thread.
+ */
+struct TileEngine::LightingJob
+{
+	TileEngine *engine;
+	int begin, end;
+	bool terrain;
+	std::vector<std::pair<Position, int> > lights;
+};
+
 /**
  * Sets up a TileEngine.
  * @param save Pointer to SavedBattleGame object.
@@ -63,7 +122,10 @@ TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) :
  */
 TileEngine::~TileEngine()
 {
-
+	for (std::vector<RayTree*>::iterator i = _rayTrees.begin(); i != _rayTrees.end(); ++i)
+	{
+		delete *i;
+	}
 }
 
 /**
@@ -71,13 +133,104 @@ TileEngine::~TileEngine()
   */
 void TileEngine::calculateSunShading()
 {
-	const int layer = 0; // Ambient lighting layer.
+	PROFILE_SCOPE("TileEngine::calculateSunShading");
+	std::vector<std::pair<Position, int> > lights;
+	lightColumns(false, lights);
+}
 
-	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+/**
+ * Calculates all the lighting of a new or loaded battle at once: sun
+ * shading, terrain and unit lights. Walking the map once for the sun
+ * also resets the terrain lights and finds where they are.
+ */
+void TileEngine::calculateLighting()
+{
+	PROFILE_SCOPE("TileEngine::calculateLighting");
+	const int layer = 1; // Static lighting layer.
+	std::vector<std::pair<Position, int> > lights;
+	lightColumns(true, lights);
+	for (std::vector<std::pair<Position, int> >::const_iterator i = lights.begin(); i != lights.end(); ++i)
 	{
-		_save->getTiles()[i]->resetLight(layer);
-		calculateSunShading(_save->getTiles()[i]);
+		addLight(i->first, i->second, layer);
 	}
+	calculateUnitLighting();
+}
+
+/**
+ * Shades the map by columns from the top down, which every column
+ * can do on its own, so big maps are split over threads.
+ * @param terrain Also reset the terrain lights and gather them?
+ * @param lights Receives the terrain lights.
+ */
+void TileEngine::lightColumns(bool terrain, std::vector<std::pair<Position, int> > &lights)
+{
+	int columns = _save->getMapSizeX() * _save->getMapSizeY();
+	int threads = _save->getMapSizeXYZ() < PARALLEL_LIGHTING_TILES ? 1 : LIGHTING_THREADS;
+	std::vector<LightingJob> jobs(threads);
+	std::vector<SDL_Thread*> handles(threads, (SDL_Thread*)0);
+	for (int i = 0; i < threads; ++i)
+	{
+		jobs[i].engine = this;
+		jobs[i].begin = columns * i / threads;
+		jobs[i].end = columns * (i + 1) / threads;
+		jobs[i].terrain = terrain;
+		if (i != 0)
+		{
+			handles[i] = SDL_CreateThread(lightColumns, &jobs[i]);
+		}
+	}
+	lightColumns(&jobs[0]);
+	for (int i = 0; i < threads; ++i)
+	{
+		if (handles[i] != 0)
+		{
+			SDL_WaitThread(handles[i], 0);
+		}
+		else if (i != 0)
+		{
+			// couldn't start the thread, do it here instead
+			lightColumns(&jobs[i]);
+		}
+		lights.insert(lights.end(), jobs[i].lights.begin(), jobs[i].lights.end());
+	}
+}
+
+/**
+ * Thread function shading a range of map columns. Sun comes from above,
+ * so walking down a column sums up what blocks it on the way.
+ * @param data Pointer to the LightingJob.
+ * @return Always 0.
+ */
+int TileEngine::lightColumns(void *data)
+{
+	LightingJob *job = (LightingJob*)data;
+	SavedBattleGame *save = job->engine->_save;
+	const int power = 15 - save->getGlobalShade();
+	// At night/dusk sun isn't dropping shades blocked by roofs
+	const bool roofs = save->getGlobalShade() <= 4;
+	for (int column = job->begin; column < job->end; ++column)
+	{
+		int x = column % save->getMapSizeX();
+		int y = column / save->getMapSizeX();
+		int block = 0;
+		for (int z = save->getMapSizeZ() - 1; z >= 0; --z)
+		{
+			Tile *tile = save->getTile(Position(x, y, z));
+			tile->resetLight(0);
+			tile->addLight(block > 0 ? power - 2 : power, 0);
+			if (roofs)
+			{
+				block += job->engine->blockage(tile, O_FLOOR, DT_NONE);
+				block += job->engine->blockage(tile, O_OBJECT, DT_NONE, Pathfinding::DIR_DOWN);
+			}
+			if (job->terrain)
+			{
+				tile->resetLight(1);
+				gatherLightSources(tile, job->lights);
+			}
+		}
+	}
+	return 0;
 }
 
 /**
@@ -115,8 +268,8 @@ void TileEngine::calculateSunShading(Tile *tile)
   */
 void TileEngine::calculateTerrainLighting()
 {
+	PROFILE_SCOPE("TileEngine::calculateTerrainLighting");
 	const int layer = 1; // Static lighting layer.
-	const int fireLightPower = 15; // amount of light a fire generates
 
 	// reset all light to 0 first
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
@@ -125,36 +278,15 @@ void TileEngine::calculateTerrainLighting()
 	}
 
 	// add lighting of terrain
+	std::vector<std::pair<Position, int> > lights;
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
 	{
-		// only floors and objects can light up
-		if (_save->getTiles()[i]->getMapData(O_FLOOR)
-			&& _save->getTiles()[i]->getMapData(O_FLOOR)->getLightSource())
-		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(O_FLOOR)->getLightSource(), layer);
-		}
-		if (_save->getTiles()[i]->getMapData(O_OBJECT)
-			&& _save->getTiles()[i]->getMapData(O_OBJECT)->getLightSource())
-		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(O_OBJECT)->getLightSource(), layer);
-		}
-
-		// fires
-		if (_save->getTiles()[i]->getFire())
-		{
-			addLight(_save->getTiles()[i]->getPosition(), fireLightPower, layer);
-		}
-
-		for (std::vector<BattleItem*>::iterator it = _save->getTiles()[i]->getInventory()->begin(); it != _save->getTiles()[i]->getInventory()->end(); ++it)
-		{
-			if ((*it)->getRules()->getBattleType() == BT_FLARE)
-			{
-				addLight(_save->getTiles()[i]->getPosition(), (*it)->getRules()->getPower(), layer);
-			}
-		}
-
+		gatherLightSources(_save->getTiles()[i], lights);
+	}
+	for (std::vector<std::pair<Position, int> >::const_iterator i = lights.begin(); i != lights.end(); ++i)
+	{
+		addLight(i->first, i->second, layer);
 	}
-
 }
 
 /**
@@ -162,9 +294,9 @@ void TileEngine::calculateTerrainLighting()
   */
 void TileEngine::calculateUnitLighting()
 {
+	PROFILE_SCOPE("TileEngine::calculateUnitLighting");
 	const int layer = 2; // Dynamic lighting layer.
 	const int personalLightPower = 15; // amount of light a unit generates
-	const int fireLightPower = 15; // amount of light a fire generates
 
 	// reset all light to 0 first
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
@@ -226,40 +358,50 @@ void TileEngine::addLight(Position center, int power, int layer)
  * @return True when new aliens are spotted.
  */
 bool TileEngine::calculateFOV(BattleUnit *unit)
+{
+	PROFILE_SCOPE("TileEngine::calculateFOV");
+	bool spotted = calculateUnitsInFOV(unit);
+	calculateTilesInFOV(unit);
+	return spotted;
+}
+
+/**
+ * Gets the direction a unit is looking at.
+ * @param unit Unit to check.
+ * @return Direction.
+ */
+int TileEngine::getViewDirection(BattleUnit *unit) const
+{
+	if (Options::strafe && (unit->getTurretType() > -1)) {
+		return unit->getTurretDirection();
+	}
+	return unit->getDirection();
+}
+
+/**
+ * Checks which units a unit sees, without touching the tiles it discovers.
+ * @param unit Unit to check line of sight of.
+ * @return True when new aliens are spotted.
+ */
+bool TileEngine::calculateUnitsInFOV(BattleUnit *unit)
 {
 	size_t oldNumVisibleUnits = unit->getUnitsSpottedThisTurn().size();
 	Position center = unit->getPosition();
 	Position test;
-	int direction;
-	bool swap;
-	std::vector<Position> _trajectory;
-	if (Options::strafe && (unit->getTurretType() > -1)) {
-		direction = unit->getTurretDirection();
-	}
-	else
-	{
-		direction = unit->getDirection();
-	}
-	swap = (direction==0 || direction==4);
+	int direction = getViewDirection(unit);
+	bool swap = (direction==0 || direction==4);
 	int signX[8] = { +1, +1, +1, +1, -1, -1, -1, -1 };
 	int signY[8] = { -1, -1, -1, +1, +1, +1, -1, -1 };
 	int y1, y2;
 
 	unit->clearVisibleUnits();
-	unit->clearVisibleTiles();
 
 	if (unit->isOut())
-		return false;
-	Position pos = unit->getPosition();
-
-	if ((unit->getHeight() + unit->getFloatHeight() + -_save->getTile(unit->getPosition())->getTerrainLevel()) >= 24 + 4)
 	{
-		Tile *tileAbove = _save->getTile(pos + Position(0,0,1));
-		if (tileAbove && tileAbove->hasNoFloor(0))
-		{
-			++pos.z;
-		}
+		unit->clearVisibleTiles();
+		return false;
 	}
+	unit->beginVisibleTiles();
 	for (int x = 0; x <= MAX_VIEW_DISTANCE; ++x)
 	{
 		if (direction%2)
@@ -289,14 +431,19 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 						{
 							if (unit->getFaction() == FACTION_PLAYER)
 							{
-								visibleUnit->getTile()->setVisible(+1);
+								// a hostile's tile goes into our visible tiles below, which counts it
+								// for as long as we see it, a +1 here would never be taken back
+								if (visibleUnit->getFaction() != FACTION_HOSTILE)
+								{
+									visibleUnit->getTile()->setVisible(+1);
+								}
 								visibleUnit->setVisible(true);
 							}
 							if ((visibleUnit->getFaction() == FACTION_HOSTILE && unit->getFaction() == FACTION_PLAYER)
 								|| (visibleUnit->getFaction() != FACTION_HOSTILE && unit->getFaction() == FACTION_HOSTILE))
 							{
 								unit->addToVisibleUnits(visibleUnit);
-								unit->addToVisibleTiles(visibleUnit->getTile());
+								unit->addToVisibleTiles(visibleUnit->getTile(), _save->getTileIndex(visibleUnit->getTile()->getPosition()));
 
 								if (unit->getFaction() == FACTION_HOSTILE && visibleUnit->getFaction() != FACTION_HOSTILE)
 								{
@@ -304,44 +451,14 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 								}
 							}
 						}
-
-						if (unit->getFaction() == FACTION_PLAYER)
-						{
-							// this sets tiles to discovered if they are in LOS - tile visibility is not calculated in voxelspace but in tilespace
-							// large units have "4 pair of eyes"
-							int size = unit->getArmor()->getSize();
-							for (int xo = 0; xo < size; xo++)
-							{
-								for (int yo = 0; yo < size; yo++)
-								{
-									Position poso = pos + Position(xo,yo,0);
-									_trajectory.clear();
-									int tst = calculateLine(poso, test, true, &_trajectory, unit, false);
-									size_t tsize = _trajectory.size();
-									if (tst>127) --tsize; //last tile is blocked thus must be cropped
-									for (size_t i = 0; i < tsize; i++)
-									{
-										Position posi = _trajectory.at(i);
-										//mark every tile of line as visible (as in original)
-										//this is needed because of bresenham narrow stroke.
-										_save->getTile(posi)->setVisible(+1);
-										_save->getTile(posi)->setDiscovered(true, 2);
-										// walls to the east or south of a visible tile, we see that too
-										Tile* t = _save->getTile(Position(posi.x + 1, posi.y, posi.z));
-										if (t) t->setDiscovered(true, 0);
-										t = _save->getTile(Position(posi.x, posi.y + 1, posi.z));
-										if (t) t->setDiscovered(true, 1);
-									}
-
-								}
-							}
-						}
 					}
 				}
 			}
 		}
 	}
 
+	unit->endVisibleTiles();
+
 	// we only react when there are at least the same amount of visible units as before AND the checksum is different
 	// this way we stop if there are the same amount of visible units, but a different unit is seen
 	// or we stop if there are more visible units seen
@@ -354,6 +471,206 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 
 }
 
+/**
+ * Discovers the tiles a player unit sees. When only some tiles changed,
+ * just the rays passing through or next to them are cast again.
+ * @param unit Unit to check line of sight of.
+ * @param changedTiles Tiles whose terrain changed, or 0 to cast every ray.
+ */
+void TileEngine::calculateTilesInFOV(BattleUnit *unit, const std::vector<Position> *changedTiles)
+{
+	if (unit->isOut() || unit->getFaction() != FACTION_PLAYER)
+	{
+		return;
+	}
+	int direction = getViewDirection(unit);
+	Position pos = unit->getPosition();
+
+	if ((unit->getHeight() + unit->getFloatHeight() + -_save->getTile(unit->getPosition())->getTerrainLevel()) >= 24 + 4)
+	{
+		Tile *tileAbove = _save->getTile(pos + Position(0,0,1));
+		if (tileAbove && tileAbove->hasNoFloor(0))
+		{
+			++pos.z;
+		}
+	}
+
+	// this sets tiles to discovered if they are in LOS - tile visibility is not calculated in voxelspace but in tilespace
+	// large units have "4 pair of eyes"
+	int size = unit->getArmor()->getSize();
+	std::vector<int> nodes;
+	for (int xo = 0; xo < size; xo++)
+	{
+		for (int yo = 0; yo < size; yo++)
+		{
+			const RayTree *rays = getRayTree(direction, xo, yo);
+			Position eye = pos + Position(xo,yo,0);
+			if (changedTiles == 0)
+			{
+				discoverTiles(rays, eye, 0, rays->size());
+				continue;
+			}
+
+			// a tile also changes the blockage of steps between its neighbours
+			nodes.clear();
+			for (std::vector<Position>::const_iterator i = changedTiles->begin(); i != changedTiles->end(); ++i)
+			{
+				for (int x = -1; x <= 1; ++x)
+				{
+					for (int y = -1; y <= 1; ++y)
+					{
+						for (int z = -1; z <= 1; ++z)
+						{
+							rays->getNodesAt(*i + Position(x, y, z) - eye, nodes);
+						}
+					}
+				}
+			}
+			std::sort(nodes.begin(), nodes.end());
+			Position min = Position(0, 0, 0) - eye;
+			Position max = Position(_save->getMapSizeX() - 1, _save->getMapSizeY() - 1, _save->getMapSizeZ() - 1) - eye;
+			int end = 0;
+			for (std::vector<int>::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
+			{
+				// skip nodes already cast again as part of an earlier subtree, or only leading off the map
+				if (*i < end || rays->countTargets(*i, min, max) == 0 || !isRayOpen(rays, eye, rays->getNode(*i).parent))
+				{
+					continue;
+				}
+				end = rays->getNode(*i).end;
+				discoverTiles(rays, eye, *i, end);
+			}
+		}
+	}
+}
+
+/**
+ * Gets the rays from one of a unit's eyes to every tile it can
+ * look at when facing a direction, building them on first use.
+ * @param direction Direction the unit is facing.
+ * @param eyeX Eye offset from the unit position, for large units.
+ * @param eyeY Eye offset from the unit position, for large units.
+ * @return Tree of rays from the eye.
+ */
+const RayTree *TileEngine::getRayTree(int direction, int eyeX, int eyeY)
+{
+	size_t index = direction * 4 + eyeX * 2 + eyeY;
+	if (_rayTrees.empty())
+	{
+		_rayTrees.resize(8 * 4, 0);
+	}
+	if (_rayTrees[index] == 0)
+	{
+		// same view wedge as calculateFOV, at every height the eye could be looking at
+		bool swap = (direction==0 || direction==4);
+		int signX[8] = { +1, +1, +1, +1, -1, -1, -1, -1 };
+		int signY[8] = { -1, -1, -1, +1, +1, +1, -1, -1 };
+		std::vector<Position> targets;
+		for (int x = 0; x <= MAX_VIEW_DISTANCE; ++x)
+		{
+			int y1 = (direction%2) ? 0 : -x;
+			int y2 = (direction%2) ? MAX_VIEW_DISTANCE : x;
+			for (int y = y1; y <= y2; ++y)
+			{
+				if (x*x + y*y <= MAX_VIEW_DISTANCE_SQR)
+				{
+					for (int z = 1 - _save->getMapSizeZ(); z < _save->getMapSizeZ(); ++z)
+					{
+						targets.push_back(Position(signX[direction]*(swap?y:x) - eyeX, signY[direction]*(swap?x:y) - eyeY, z));
+					}
+				}
+			}
+		}
+		_rayTrees[index] = new RayTree(targets);
+	}
+	return _rayTrees[index];
+}
+
+/**
+ * Checks how far the rays through a node get, like
+ * calculateLine does in tile space for each step.
+ * @param rays Rays from the eye.
+ * @param eye Position of the eye.
+ * @param node Node to check.
+ * @return Whether the rays see the node and carry on past it.
+ */
+RayStep TileEngine::castRay(const RayTree *rays, Position eye, int node)
+{
+	const RayNode &ray = rays->getNode(node);
+	Tile *tile = _save->getTile(eye + ray.offset);
+	Tile *last = ray.parent == -1 ? tile : _save->getTile(eye + rays->getNode(ray.parent).offset);
+	int vertical = verticalBlockage(last, tile, DT_NONE);
+	int horizontal = horizontalBlockage(last, tile, DT_NONE, ray.depth < 2);
+	if (horizontal == -1)
+	{
+		// We hit a big wall, it is seen but nothing past it
+		return vertical > 127 ? RAY_BLOCKED : RAY_LAST;
+	}
+	return horizontal + vertical > 127 ? RAY_BLOCKED : RAY_OPEN;
+}
+
+/**
+ * Checks if the rays through a node get past it and
+ * every node before it.
+ * @param rays Rays from the eye.
+ * @param eye Position of the eye.
+ * @param node Node to check, -1 for none.
+ * @return True if the rays carry on past the node.
+ */
+bool TileEngine::isRayOpen(const RayTree *rays, Position eye, int node)
+{
+	for (; node != -1; node = rays->getNode(node).parent)
+	{
+		if (castRay(rays, eye, node) != RAY_OPEN)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Marks the tiles along a tree of rays as visible and discovered,
+ * like calculateLine would in tile space for each ray on its own.
+ * Each node is only checked once for all the rays through it,
+ * and a blocked node cuts off every ray past it.
+ * @param rays Rays from the eye.
+ * @param eye Position of the eye.
+ * @param first First node to cast, the rays must reach it.
+ * @param last One past the last node to cast.
+ */
+void TileEngine::discoverTiles(const RayTree *rays, Position eye, int first, int last)
+{
+	// rays to targets off the map aren't cast at all
+	Position min = Position(0, 0, 0) - eye;
+	Position max = Position(_save->getMapSizeX() - 1, _save->getMapSizeY() - 1, _save->getMapSizeZ() - 1) - eye;
+	for (int i = first; i < last;)
+	{
+		const RayNode &node = rays->getNode(i);
+		int count = rays->countTargets(i, min, max);
+		RayStep step = count == 0 ? RAY_BLOCKED : castRay(rays, eye, i);
+		if (step == RAY_BLOCKED)
+		{
+			i = node.end;
+			continue;
+		}
+
+		//mark every tile of line as visible (as in original)
+		//this is needed because of bresenham narrow stroke.
+		Tile *tile = _save->getTile(eye + node.offset);
+		tile->setVisible(count);
+		tile->setDiscovered(true, 2);
+		// walls to the east or south of a visible tile, we see that too
+		Position pos = tile->getPosition();
+		Tile* t = _save->getTile(Position(pos.x + 1, pos.y, pos.z));
+		if (t) t->setDiscovered(true, 0);
+		t = _save->getTile(Position(pos.x, pos.y + 1, pos.z));
+		if (t) t->setDiscovered(true, 1);
+
+		i = step == RAY_LAST ? node.end : i + 1;
+	}
+}
+
 /**
  * Gets the origin voxel of a unit's eyesight (from just one eye or something? Why is it x+7??
  * @param currentUnit The watcher.
@@ -415,7 +732,6 @@ bool TileEngine::visible(BattleUnit *currentUnit, Tile *tile)
 	// for large units origin voxel is in the middle
 
 	Position scanVoxel;
-	std::vector<Position> _trajectory;
 	unitSeen = canTargetUnit(&originVoxel, tile, &scanVoxel, currentUnit, false);
 
 	if (unitSeen)
@@ -460,8 +776,6 @@ bool TileEngine::visible(BattleUnit *currentUnit, Tile *tile)
 int TileEngine::checkVoxelExposure(Position *originVoxel, Tile *tile, BattleUnit *excludeUnit, BattleUnit *excludeAllBut)
 {
 	Position targetVoxel = Position((tile->getPosition().x * 16) + 7, (tile->getPosition().y * 16) + 8, tile->getPosition().z * 24);
-	Position scanVoxel;
-	std::vector<Position> _trajectory;
 	BattleUnit *otherUnit = tile->getUnit();
 	if (otherUnit == 0) return 0; //no unit in this tile, even if it elevated and appearing in it.
 	if (otherUnit == excludeUnit) return 0; //skip self
@@ -500,27 +814,26 @@ int TileEngine::checkVoxelExposure(Position *originVoxel, Tile *tile, BattleUnit
 	// scan ray from top to bottom  plus different parts of target cylinder
 	int total=0;
 	int visible=0;
+	_lines.clear();
 	for (int i = heightRange; i >=0; i-=2)
 	{
 		++total;
-		scanVoxel.z=targetMinHeight+i;
 		for (int j = 0; j < 3; ++j)
 		{
-			scanVoxel.x=targetVoxel.x + sliceTargets[j*2];
-			scanVoxel.y=targetVoxel.y + sliceTargets[j*2+1];
-			_trajectory.clear();
-			int test = calculateLine(*originVoxel, scanVoxel, false, &_trajectory, excludeUnit, true, false, excludeAllBut);
-			if (test == V_UNIT)
-			{
-				//voxel of hit must be inside of scanned box
-				if (_trajectory.at(0).x/16 == scanVoxel.x/16 &&
-					_trajectory.at(0).y/16 == scanVoxel.y/16 &&
-					_trajectory.at(0).z >= targetMinHeight &&
-					_trajectory.at(0).z <= targetMaxHeight)
-				{
-					++visible;
-				}
-			}
+			_lines.push_back(LineOfFire(Position(targetVoxel.x + sliceTargets[j*2], targetVoxel.y + sliceTargets[j*2+1], targetMinHeight+i)));
+		}
+	}
+	calculateLines(*originVoxel, _lines, 0, excludeUnit, excludeAllBut);
+	for (std::vector<LineOfFire>::const_iterator i = _lines.begin(); i != _lines.end(); ++i)
+	{
+		//voxel of hit must be inside of scanned box
+		if (i->result == V_UNIT &&
+			i->impact.x/16 == i->target.x/16 &&
+			i->impact.y/16 == i->target.y/16 &&
+			i->impact.z >= targetMinHeight &&
+			i->impact.z <= targetMaxHeight)
+		{
+			++visible;
 		}
 	}
 	return (visible*100)/total;
@@ -539,8 +852,6 @@ int TileEngine::checkVoxelExposure(Position *originVoxel, Tile *tile, BattleUnit
 bool TileEngine::canTargetUnit(Position *originVoxel, Tile *tile, Position *scanVoxel, BattleUnit *excludeUnit, bool rememberObstacles, BattleUnit *potentialUnit)
 {
 	Position targetVoxel = Position((tile->getPosition().x * 16) + 7, (tile->getPosition().y * 16) + 8, tile->getPosition().z * 24);
-	std::vector<Position> _trajectory;
-	bool hypothetical = potentialUnit != 0;
 	if (potentialUnit == 0)
 	{
 		potentialUnit = tile->getUnit();
@@ -589,42 +900,46 @@ bool TileEngine::canTargetUnit(Position *originVoxel, Tile *tile, Position *scan
 	if (heightRange<=0) heightRange=0;
 
 	// scan ray from top to bottom  plus different parts of target cylinder
+	_lines.clear();
 	for (int i = 0; i <= heightRange; ++i)
 	{
-		scanVoxel->z=targetCenterHeight+heightFromCenter[i];
 		for (int j = 0; j < 5; ++j)
 		{
 			if (i < (heightRange-1) && j>2) break; //skip unnecessary checks
-			scanVoxel->x=targetVoxel.x + sliceTargets[j*2];
-			scanVoxel->y=targetVoxel.y + sliceTargets[j*2+1];
-			_trajectory.clear();
-			int test = calculateLine(*originVoxel, *scanVoxel, false, &_trajectory, excludeUnit, true, false);
-			if (test == V_UNIT)
+			_lines.push_back(LineOfFire(Position(targetVoxel.x + sliceTargets[j*2], targetVoxel.y + sliceTargets[j*2+1], targetCenterHeight+heightFromCenter[i])));
+		}
+	}
+	// trace up to the next line hitting a unit, then see if it's the one we're after
+	size_t traced = 0;
+	for (size_t i = 0; i < _lines.size(); ++i)
+	{
+		if (i == traced)
+		{
+			traced = calculateLines(*originVoxel, _lines, i, excludeUnit, 0, V_UNIT) + 1;
+		}
+		const LineOfFire &line = _lines[i];
+		*scanVoxel = line.target;
+		if (line.result == V_UNIT)
+		{
+			for (int x = 0; x <= targetSize; ++x)
 			{
-				for (int x = 0; x <= targetSize; ++x)
+				for (int y = 0; y <= targetSize; ++y)
 				{
-					for (int y = 0; y <= targetSize; ++y)
+					//voxel of hit must be inside of scanned box
+					if (line.impact.x/16 == (line.target.x/16) + x + xOffset &&
+						line.impact.y/16 == (line.target.y/16) + y + yOffset &&
+						line.impact.z >= targetMinHeight &&
+						line.impact.z <= targetMaxHeight)
 					{
-						//voxel of hit must be inside of scanned box
-						if (_trajectory.at(0).x/16 == (scanVoxel->x/16) + x + xOffset &&
-							_trajectory.at(0).y/16 == (scanVoxel->y/16) + y + yOffset &&
-							_trajectory.at(0).z >= targetMinHeight &&
-							_trajectory.at(0).z <= targetMaxHeight)
-						{
-							return true;
-						}
+						return true;
 					}
 				}
 			}
-			else if (test == V_EMPTY && hypothetical && !_trajectory.empty())
-			{
-				return true;
-			}
-			if (rememberObstacles && _trajectory.size()>0)
-			{
-				Tile *tileObstacle = _save->getTile(Position(_trajectory.at(0).x / 16, _trajectory.at(0).y / 16, _trajectory.at(0).z / 24));
-				if (tileObstacle) tileObstacle->setObstacle(test);
-			}
+		}
+		if (rememberObstacles && line.result != V_EMPTY)
+		{
+			Tile *tileObstacle = _save->getTile(line.impact / Position(16, 16, 24));
+			if (tileObstacle) tileObstacle->setObstacle(line.result);
 		}
 	}
 	return false;
@@ -649,7 +964,6 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
 	static int northWallSpiral[14] = {7,0, 9,0, 6,0, 11,0, 4,0, 13,0, 2,0};
 
 	Position targetVoxel = Position((tile->getPosition().x * 16), (tile->getPosition().y * 16), tile->getPosition().z * 24);
-	std::vector<Position> _trajectory;
 
 	int *spiralArray;
 	int spiralCount;
@@ -775,48 +1089,125 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
 	if (rangeZ>10) rangeZ = 10; //as above, clamping height range to prevent buffer overflow
 	int centerZ = (maxZ + minZ)/2;
 
+	_lines.clear();
 	for (int j = 0; j <= rangeZ; ++j)
 	{
-		scanVoxel->z = targetVoxel.z + centerZ + heightFromCenter[j];
 		for (int i = 0; i < spiralCount; ++i)
 		{
-			scanVoxel->x = targetVoxel.x + spiralArray[i*2];
-			scanVoxel->y = targetVoxel.y + spiralArray[i*2+1];
-			_trajectory.clear();
-			int test = calculateLine(*originVoxel, *scanVoxel, false, &_trajectory, excludeUnit, true);
-			if (test == part && !dummy) //bingo
-			{
-				if (_trajectory.at(0).x/16 == scanVoxel->x/16 &&
-					_trajectory.at(0).y/16 == scanVoxel->y/16 &&
-					_trajectory.at(0).z/24 == scanVoxel->z/24)
-				{
-					return true;
-				}
-			}
-			if (rememberObstacles && _trajectory.size()>0)
+			_lines.push_back(LineOfFire(Position(targetVoxel.x + spiralArray[i*2], targetVoxel.y + spiralArray[i*2+1], targetVoxel.z + centerZ + heightFromCenter[j])));
+		}
+	}
+	// trace up to the next line hitting the part, then see if it hit this tile
+	size_t traced = 0;
+	for (size_t i = 0; i < _lines.size(); ++i)
+	{
+		if (i == traced)
+		{
+			traced = calculateLines(*originVoxel, _lines, i, excludeUnit, 0, dummy ? V_EMPTY : part) + 1;
+		}
+		const LineOfFire &line = _lines[i];
+		*scanVoxel = line.target;
+		if (line.result == part && !dummy) //bingo
+		{
+			if (line.impact / Position(16, 16, 24) == line.target / Position(16, 16, 24))
 			{
-				Tile *tileObstacle = _save->getTile(Position(_trajectory.at(0).x / 16, _trajectory.at(0).y / 16, _trajectory.at(0).z / 24));
-				if (tileObstacle) tileObstacle->setObstacle(test);
+				return true;
 			}
 		}
+		if (rememberObstacles && line.result != V_EMPTY)
+		{
+			Tile *tileObstacle = _save->getTile(line.impact / Position(16, 16, 24));
+			if (tileObstacle) tileObstacle->setObstacle(line.result);
+		}
 	}
 	return false;
 }
 
 /**
  * Calculates line of sight of a soldiers within range of the Position
- * (used when terrain has changed, which can reveal new parts of terrain or units).
- * @param position Position of the changed terrain.
+ * (used when a unit moved or changed, which can reveal new units).
+ * The unit standing there also looks around again in full.
+ * @param position Position of the change.
  */
 void TileEngine::calculateFOV(Position position)
 {
+	invalidateLight(position);
+	updateFOV();
+	Tile *tile = _save->getTile(position);
+	if (tile && tile->getUnit())
+	{
+		calculateTilesInFOV(tile->getUnit());
+	}
+}
+
+/**
+ * Queues a tile whose terrain changed, eg. by an explosion or a door.
+ * Only the rays passing through or next to it are cast again.
+ * @param position Position of the changed tile.
+ */
+void TileEngine::invalidateTile(Position position)
+{
+	_changedTiles.push_back(position);
+}
+
+/**
+ * Queues a change that can reveal or hide units but leaves the
+ * terrain alone, eg. light. Units near it only check who they see.
+ * @param position Position of the change.
+ */
+void TileEngine::invalidateLight(Position position)
+{
+	_changedLights.push_back(position);
+}
+
+/**
+ * Updates the line of sight of every unit near the queued changes
+ * in a single pass, then clears the queues.
+ */
+void TileEngine::updateFOV()
+{
+	PROFILE_SCOPE("TileEngine::updateFOV");
+	if (_changedTiles.empty() && _changedLights.empty())
+	{
+		return;
+	}
+	std::vector<Position> changedTiles;
 	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
 	{
-		if (distanceSq(position, (*i)->getPosition()) <= MAX_VIEW_DISTANCE_SQR)
+		if ((*i)->getTile() == 0)
 		{
-			calculateFOV(*i);
+			continue;
+		}
+		// rays reach one tile past the view distance when checking neighbours
+		changedTiles.clear();
+		for (std::vector<Position>::const_iterator j = _changedTiles.begin(); j != _changedTiles.end(); ++j)
+		{
+			if (distanceSq(*j, (*i)->getPosition()) <= (MAX_VIEW_DISTANCE + 1) * (MAX_VIEW_DISTANCE + 1))
+			{
+				changedTiles.push_back(*j);
+			}
+		}
+		bool lightChanged = false;
+		for (std::vector<Position>::const_iterator j = _changedLights.begin(); j != _changedLights.end() && !lightChanged; ++j)
+		{
+			lightChanged = distanceSq(*j, (*i)->getPosition()) <= MAX_VIEW_DISTANCE_SQR;
+		}
+		if (changedTiles.empty() && !lightChanged)
+		{
+			continue;
+		}
+		calculateUnitsInFOV(*i);
+		if (changedTiles.size() > MAX_CHANGED_TILES)
+		{
+			calculateTilesInFOV(*i);
+		}
+		else if (!changedTiles.empty())
+		{
+			calculateTilesInFOV(*i, &changedTiles);
 		}
 	}
+	_changedTiles.clear();
+	_changedLights.clear();
 }
 
 /**
@@ -1191,7 +1582,12 @@ BattleUnit *TileEngine::hit(Position center, int power, ItemDamageType type, Bat
 	applyGravity(tile);
 	calculateSunShading(); // roofs could have been destroyed
 	calculateTerrainLighting(); // fires could have been started
-	calculateFOV(center / Position(16,16,24));
+	if (part >= V_FLOOR && part <= V_OBJECT)
+	{
+		invalidateTile(tile->getPosition());
+	}
+	invalidateLight(center / Position(16,16,24));
+	updateFOV();
 	return bu;
 }
 
@@ -1356,6 +1752,7 @@ void TileEngine::explode(Position center, int power, ItemDamageType type, int ma
 							{
 								dest->setFire(0);
 								dest->setSmoke(RNG::generate(7, 15));
+								_save->trackFireAndSmoke(dest);
 							}
 							break;
 
@@ -1366,6 +1763,7 @@ void TileEngine::explode(Position center, int power, ItemDamageType type, int ma
 								{
 									dest->setFire(dest->getFuel() + 1);
 									dest->setSmoke(Clamp(15 - (dest->getFlammability() / 10), 1, 12));
+									_save->trackFireAndSmoke(dest);
 								}
 								if (bu)
 								{
@@ -1466,12 +1864,14 @@ void TileEngine::explode(Position center, int power, ItemDamageType type, int ma
 			Tile *j = _save->getTile((*i)->getPosition() + Position(0,0,1));
 			if (j)
 				applyGravity(j);
+			invalidateTile((*i)->getPosition());
 		}
 	}
 
 	calculateSunShading(); // roofs could have been destroyed
 	calculateTerrainLighting(); // fires could have been started
-	calculateFOV(center / Position(16,16,24));
+	invalidateLight(center / Position(16,16,24));
+	updateFOV();
 }
 
 /**
@@ -1571,6 +1971,7 @@ bool TileEngine::detonate(Tile* tile)
 			{
 				tiles[i]->setFire(fuel);
 				tiles[i]->setSmoke(Clamp(15 - (fireProof / 10), 1, 12));
+				_save->trackFireAndSmoke(tiles[i]);
 			}
 		}
 		// add some smoke if tile was destroyed and not set on fire
@@ -1587,6 +1988,7 @@ bool TileEngine::detonate(Tile* tile)
 				if (smoke > tiles[i]->getSmoke())
 				{
 					tiles[i]->setSmoke(Clamp(smoke, 0, 15));
+					_save->trackFireAndSmoke(tiles[i]);
 				}
 			}
 		}
@@ -2093,6 +2495,10 @@ int TileEngine::unitOpensDoor(BattleUnit *unit, bool rClick, int dir)
 					if (door != -1)
 					{
 						part = i->second;
+						if (door == 0 || door == 1)
+						{
+							invalidateTile(tile->getPosition());
+						}
 						if (door == 1)
 						{
 							checkAdjacentDoors(unit->getPosition() + Position(x,y,z) + i->first, i->second);
@@ -2125,13 +2531,8 @@ int TileEngine::unitOpensDoor(BattleUnit *unit, bool rClick, int dir)
 		{
 			if (unit->spendTimeUnits(TUCost))
 			{
-				calculateFOV(unit->getPosition());
-				// look from the other side (may be need check reaction fire?)
-				std::vector<BattleUnit*> *vunits = unit->getVisibleUnits();
-				for (size_t i = 0; i < vunits->size(); ++i)
-				{
-					calculateFOV(vunits->at(i));
-				}
+				// everyone near the door looks through it, including from the other side
+				updateFOV();
 			}
 			else return 4;
 		}
@@ -2158,6 +2559,7 @@ void TileEngine::checkAdjacentDoors(const Position& pos, TilePart part)
 		if (tile && tile->getMapData(part) && tile->getMapData(part)->isUFODoor())
 		{
 			tile->openDoor(part);
+			invalidateTile(tile->getPosition());
 		}
 		else break;
 	}
@@ -2168,6 +2570,7 @@ void TileEngine::checkAdjacentDoors(const Position& pos, TilePart part)
 		if (tile && tile->getMapData(part) && tile->getMapData(part)->isUFODoor())
 		{
 			tile->openDoor(part);
+			invalidateTile(tile->getPosition());
 		}
 		else break;
 	}
@@ -2216,6 +2619,7 @@ int TileEngine::closeUfoDoors()
  */
 int TileEngine::calculateLine(Position origin, Position target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, bool doVoxelCheck, bool onlyVisible, BattleUnit *excludeAllBut)
 {
+	PROFILE_SCOPE("TileEngine::calculateLine");
 	int x, x0, x1, delta_x, step_x;
 	int y, y0, y1, delta_y, step_y;
 	int z, z0, z1, delta_z, step_z;
@@ -2381,8 +2785,81 @@ int TileEngine::calculateLine(Position origin, Position target, bool storeTrajec
 	return V_EMPTY;
 }
 
+/**
+ * Traces lines of fire from one origin to several targets, in order,
+ * until one of them hits a given kind of voxel. A line aimed at the same
+ * voxel as the one before it gets its result without being traced again.
+ * @param origin Origin in voxelspace.
+ * @param lines Lines to trace, gets what each line hit and where.
+ * @param first Index of the first line to trace.
+ * @param excludeUnit Excludes this unit in the collision detection.
+ * @param excludeAllBut [Optional] The only unit to be considered for ray hits.
+ * @param stopAt Stop after a line hitting this, V_EMPTY to trace all of them.
+ * @return Index of the line that hit stopAt, or the number of lines.
+ */
+size_t TileEngine::calculateLines(Position origin, std::vector<LineOfFire> &lines, size_t first, BattleUnit *excludeUnit, BattleUnit *excludeAllBut, int stopAt)
+{
+	for (size_t i = first; i < lines.size(); ++i)
+	{
+		LineOfFire &line = lines[i];
+		if (i > first && lines[i - 1].target == line.target)
+		{
+			line.result = lines[i - 1].result;
+			line.impact = lines[i - 1].impact;
+		}
+		else
+		{
+			_trajectory.clear();
+			line.result = calculateLine(origin, line.target, false, &_trajectory, excludeUnit, true, false, excludeAllBut);
+			line.impact = _trajectory.empty() ? Position(-1, -1, -1) : _trajectory.front();
+		}
+		if (line.result != V_EMPTY && line.result == stopAt)
+		{
+			return i;
+		}
+	}
+	return lines.size();
+}
+
+/**
+ * Checks if a line between two voxels can't hit anything, that is every
+ * tile it can pass through is on the map, empty and has no unit in it or
+ * sticking up into it from below. Any voxel check on the line would come
+ * back empty, so it can be skipped.
+ * @param origin Origin in voxelspace.
+ * @param target Target in voxelspace.
+ * @return True if the line is clear.
+ */
+bool TileEngine::isLineClear(Position origin, Position target)
+{
+	if (origin.x < 0 || origin.y < 0 || origin.z < 0 || target.x < 0 || target.y < 0 || target.z < 0)
+	{
+		return false;
+	}
+	Position from = origin / Position(16, 16, 24);
+	Position to = target / Position(16, 16, 24);
+	for (int z = std::min(from.z, to.z); z <= std::max(from.z, to.z); ++z)
+	{
+		for (int y = std::min(from.y, to.y); y <= std::max(from.y, to.y); ++y)
+		{
+			for (int x = std::min(from.x, to.x); x <= std::max(from.x, to.x); ++x)
+			{
+				Tile *tile = _save->getTile(Position(x, y, z));
+				Tile *tileBelow = _save->getTile(Position(x, y, z - 1));
+				if (!tile || !tile->isVoid() || tile->getUnit() || (tileBelow && tileBelow->getUnit()))
+				{
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
 /**
  * Calculates a parabola trajectory, used for throwing items.
+ * Without storing the trajectory, the arc is only traced voxel by voxel
+ * where it comes close to the terrain or a unit.
  * @param origin Origin in voxelspace.
  * @param target Target in voxelspace.
  * @param storeTrajectory True will store the whole trajectory - otherwise it just stores the last position.
@@ -2433,6 +2910,13 @@ int TileEngine::calculateParabola(Position origin, Position target, bool storeTr
 			//remove end point of previus trajectory part, becasue next one will add this point again
 			trajectory->pop_back();
 		}
+		else if (isLineClear(lastPosition, nextPosition))
+		{
+			//nothing to hit up here, follow the arc until it gets close to the terrain or a unit
+			lastPosition = nextPosition;
+			++i;
+			continue;
+		}
 		result = calculateLine(lastPosition, nextPosition, storeTrajectory, storeTrajectory ? trajectory : 0, excludeUnit);
 		if (result != V_EMPTY)
 		{
@@ -2935,19 +3419,29 @@ bool TileEngine::validateThrow(BattleAction &action, Position originVoxel, Posit
 		return false;
 	}
 
-	std::vector<Position> trajectory;
-	// thows should be around 10 tiles far, make one allocation that fit 99% cases with some margin
-	trajectory.resize(16*20);
 	// we try 8 different curvatures to try and reach our goal.
 	int test = V_OUTOFBOUNDS;
 	while (!foundCurve && curvature < 5.0)
 	{
-		trajectory.clear();
-		test = calculateParabola(originVoxel, targetVoxel, true, &trajectory, action.actor, curvature, Position(0,0,0));
+		// the point of impact is enough to rule out most curves, the whole arc is only needed to see where the item lands
+		_trajectory.clear();
+		test = calculateParabola(originVoxel, targetVoxel, false, &_trajectory, action.actor, curvature, Position(0,0,0));
+		bool nearTarget = false;
+		if (!_trajectory.empty())
+		{
+			// the item lands a couple of voxels before the point of impact, so at most one tile off
+			Position impact = _trajectory.back() / Position(16, 16, 24);
+			nearTarget = abs(impact.x - targetPos.x) <= 1 && abs(impact.y - targetPos.y) <= 1 && abs(impact.z - targetPos.z) <= 1;
+		}
+		if (forced || test == V_EMPTY || (test != V_OUTOFBOUNDS && nearTarget))
+		{
+			_trajectory.clear();
+			test = calculateParabola(originVoxel, targetVoxel, true, &_trajectory, action.actor, curvature, Position(0,0,0));
+		}
 		//position that item hit
-		Position hitPos = (trajectory.back() + Position(0,0,1)) / Position(16, 16, 24);
+		Position hitPos = (_trajectory.back() + Position(0,0,1)) / Position(16, 16, 24);
 		//position where item will land
-		Position tilePos = Projectile::getPositionFromEnd(trajectory, Projectile::ItemDropVoxelOffset) / Position(16, 16, 24);
+		Position tilePos = Projectile::getPositionFromEnd(_trajectory, Projectile::ItemDropVoxelOffset) / Position(16, 16, 24);
 		if (forced || (test != V_OUTOFBOUNDS && tilePos == targetPos))
 		{
 			if (voxelType)
@@ -2983,14 +3477,22 @@ bool TileEngine::validateThrow(BattleAction &action, Position originVoxel, Posit
 
 /**
  * Recalculates FOV of all units in-game.
+ * @param lightOnly Only check which units are seen, the terrain didn't change.
  */
-void TileEngine::recalculateFOV()
+void TileEngine::recalculateFOV(bool lightOnly)
 {
 	for (std::vector<BattleUnit*>::iterator bu = _save->getUnits()->begin(); bu != _save->getUnits()->end(); ++bu)
 	{
 		if ((*bu)->getTile() != 0)
 		{
-			calculateFOV(*bu);
+			if (lightOnly)
+			{
+				calculateUnitsInFOV(*bu);
+			}
+			else
+			{
+				calculateFOV(*bu);
+			}
 		}
 	}
 }
@@ -3124,7 +3626,7 @@ void TileEngine::setDangerZone(const Position& pos, int radius, BattleUnit *unit
 		return;
 	}
 	// set the epicenter as dangerous
-	tile->setDangerous(true);
+	_save->addDangerousTile(tile);
 	Position originVoxel = (pos * Position(16,16,24)) + Position(8,8,12 + -tile->getTerrainLevel());
 	Position targetVoxel;
 	for (int x = -radius; x != radius; ++x)
@@ -3141,16 +3643,16 @@ void TileEngine::setDangerZone(const Position& pos, int radius, BattleUnit *unit
 					if (tile)
 					{
 						targetVoxel = ((pos + Position(x,y,0)) * Position(16,16,24)) + Position(8,8,12 + -tile->getTerrainLevel());
-						std::vector<Position> trajectory;
 						// we'll trace a line here, ignoring all units, to check if the explosion will reach this point
 						// granted this won't properly account for explosions tearing through walls, but then we can't really
 						// know that kind of information before the fact, so let's have the AI assume that the wall (or tree)
 						// is enough to protect them.
-						if (calculateLine(originVoxel, targetVoxel, false, &trajectory, unit, true, false, unit) == V_EMPTY)
+						_trajectory.clear();
+						if (calculateLine(originVoxel, targetVoxel, false, &_trajectory, unit, true, false, unit) == V_EMPTY)
 						{
-							if (trajectory.size() && (trajectory.back() / Position(16,16,24)) == pos + Position(x,y,0))
+							if (_trajectory.size() && (_trajectory.back() / Position(16,16,24)) == pos + Position(x,y,0))
 							{
-								tile->setDangerous(true);
+								_save->addDangerousTile(tile);
 							}
 						}
 					}
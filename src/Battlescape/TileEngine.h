@@ -19,6 +19,7 @@
  */
 #include <vector>
 #include "Position.h"
+#include "RayTree.h"
 #include "../Mod/RuleItem.h"
 #include "../Mod/MapData.h"
 #include <SDL.h>
@@ -31,6 +32,17 @@ class BattleUnit;
 class BattleItem;
 class Tile;
 struct BattleAction;
+
+/**
+ * A line of fire traced by TileEngine::calculateLines.
+ */
+struct LineOfFire
+{
+	Position target, impact;
+	int result;
+	LineOfFire(Position target) : target(target), impact(-1, -1, -1), result(V_EMPTY) { }
+};
+
 /**
  * A utility class that modifies tile properties on a battlescape map. This includes lighting, destruction, smoke, fire, fog of war.
  * Note that this function does not handle any sounds or animations.
@@ -41,15 +53,44 @@ private:
 	static const int MAX_VIEW_DISTANCE = 20;
 	static const int MAX_VIEW_DISTANCE_SQR = MAX_VIEW_DISTANCE * MAX_VIEW_DISTANCE;
 	static const int MAX_VOXEL_VIEW_DISTANCE = MAX_VIEW_DISTANCE * 16;
+	/// Beyond this many changed tiles near a unit, all its rays are cast again.
+	static const size_t MAX_CHANGED_TILES = 64;
 	SavedBattleGame *_save;
 	std::vector<Uint16> *_voxelData;
 	static const int heightFromCenter[11];
+	struct LightingJob;
+	/// Shades the map and optionally gathers its terrain lights.
+	void lightColumns(bool terrain, std::vector<std::pair<Position, int> > &lights);
+	/// Shades a range of map columns.
+	static int lightColumns(void *data);
 	void addLight(Position center, int power, int layer);
 	int blockage(Tile *tile, const TilePart part, ItemDamageType type, int direction = -1, bool checkingFromOrigin = false);
 	bool _personalLighting;
 	Tile *_cacheTile;
 	Tile *_cacheTileBelow;
 	Position _cacheTilePos;
+	/// Scratch trajectory, reused by every trace that only looks at it locally.
+	std::vector<Position> _trajectory;
+	/// Scratch lines of fire, reused by the targeting checks.
+	std::vector<LineOfFire> _lines;
+	/// Checks if nothing between two voxels can be hit.
+	bool isLineClear(Position origin, Position target);
+	std::vector<RayTree*> _rayTrees;
+	/// Gets the rays from an eye to the tiles a unit can look at.
+	const RayTree *getRayTree(int direction, int eyeX, int eyeY);
+	std::vector<Position> _changedTiles, _changedLights;
+	/// Discovers the tiles seen along part of a tree of rays.
+	void discoverTiles(const RayTree *rays, Position eye, int first, int last);
+	/// Checks how far the rays through a node get.
+	RayStep castRay(const RayTree *rays, Position eye, int node);
+	/// Checks if the rays through a node and every node before it are open.
+	bool isRayOpen(const RayTree *rays, Position eye, int node);
+	/// Gets the direction a unit is looking at.
+	int getViewDirection(BattleUnit *unit) const;
+	/// Checks which units a unit sees.
+	bool calculateUnitsInFOV(BattleUnit *unit);
+	/// Discovers the tiles a unit sees, optionally only around some changed tiles.
+	void calculateTilesInFOV(BattleUnit *unit, const std::vector<Position> *changedTiles = 0);
 public:
 	static const int MAX_DARKNESS_TO_SEE_UNITS = 9;
 	/// Creates a new TileEngine class.
@@ -64,8 +105,16 @@ public:
 	bool calculateFOV(BattleUnit *unit);
 	/// Calculates the field of view within range of a certain position.
 	void calculateFOV(Position position);
+	/// Queues a tile whose terrain changed for the next FOV update.
+	void invalidateTile(Position position);
+	/// Queues a light change for the next FOV update.
+	void invalidateLight(Position position);
+	/// Updates the FOV of the units near the queued changes.
+	void updateFOV();
 	/// Checks reaction fire.
 	bool checkReactionFire(BattleUnit *unit);
+	/// Calculates all lighting of the battlescape.
+	void calculateLighting();
 	/// Recalculates lighting of the battlescape for terrain.
 	void calculateTerrainLighting();
 	/// Recalculates lighting of the battlescape for units.
@@ -82,6 +131,8 @@ public:
 	int closeUfoDoors();
 	/// Calculates a line trajectory.
 	int calculateLine(Position origin, Position target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, bool doVoxelCheck = true, bool onlyVisible = false, BattleUnit *excludeAllBut = 0);
+	/// Traces lines of fire from one origin to several targets.
+	size_t calculateLines(Position origin, std::vector<LineOfFire> &lines, size_t first, BattleUnit *excludeUnit, BattleUnit *excludeAllBut = 0, int stopAt = V_EMPTY);
 	/// Calculates a parabola trajectory.
 	int calculateParabola(Position origin, Position target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, double curvature, const Position delta);
 	/// Gets the origin voxel of a unit's eyesight.
@@ -135,7 +186,7 @@ public:
 	/// Tries to perform a reaction snap shot to this location.
 	bool tryReaction(BattleUnit *unit, BattleUnit *target, int attackType);
 	/// Recalculates FOV of all units in-game.
-	void recalculateFOV();
+	void recalculateFOV(bool lightOnly = false);
 	/// Get direction to a certain point
 	int getDirectionTo(Position origin, Position target) const;
 	/// determine the origin voxel of a given action.
@@ -35,6 +35,7 @@
 #include "InfoboxOKState.h"
 #include "InfoboxState.h"
 #include "../Savegame/Node.h"
+#include "../Savegame/NodeIndex.h"
 
 namespace OpenXcom
 {
@@ -99,12 +100,12 @@ UnitDieBState::UnitDieBState(BattlescapeGame *parent, BattleUnit *unit, ItemDama
 
 	if (!_parent->getSave()->isBeforeGame() && _unit->getFaction() == FACTION_HOSTILE)
 	{
-		std::vector<Node *> *nodes = _parent->getSave()->getNodes();
-		if (!nodes) return; // this better not happen.
+		std::vector<Node *> nodes;
+		_parent->getSave()->getNodeIndex()->getNodesInRange(_unit->getPosition(), 1, nodes);
 
-		for (std::vector<Node*>::iterator  n = nodes->begin(); n != nodes->end(); ++n)
+		for (std::vector<Node*>::iterator  n = nodes.begin(); n != nodes.end(); ++n)
 		{
-			if (!(*n)->isDummy() && _parent->getSave()->getTileEngine()->distanceSq((*n)->getPosition(), _unit->getPosition()) < 4)
+			if (_parent->getSave()->getTileEngine()->distanceSq((*n)->getPosition(), _unit->getPosition()) < 4)
 			{
 				(*n)->setType((*n)->getType() | Node::TYPE_DANGEROUS);
 			}
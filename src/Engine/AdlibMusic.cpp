@@ -34,13 +34,17 @@ namespace OpenXcom
 int AdlibMusic::delay = 0;
 int AdlibMusic::rate = 0;
 std::map<int, int> AdlibMusic::delayRates;
+int AdlibMusic::_tracks = 0;
+const AdlibMusic *AdlibMusic::_current = 0;
 
 /**
- * Initializes a new music track.
+ * Initializes a new music track. The OPL chips are
+ * shared by all tracks and created with the first one.
  * @param volume Music volume modifier (1.0 = 100%).
  */
 AdlibMusic::AdlibMusic(float volume) : Music(), _data(0), _size(0), _volume(volume)
 {
+	_tracks++;
 	rate = Options::audioSampleRate;
 	if (!opl[0])
 	{
@@ -64,20 +68,29 @@ AdlibMusic::AdlibMusic(float volume) : Music(), _data(0), _size(0), _volume(volu
 }
 
 /**
- * Deletes the loaded music content.
+ * Deletes the loaded music content, stopping it first if
+ * the player is still set up with it. The OPL chips are
+ * only destroyed along with the last track.
  */
 AdlibMusic::~AdlibMusic()
 {
-	if (opl[0])
+	if (_current == this)
 	{
 		stop();
-		OPLDestroy(opl[0]);
-		opl[0] = 0;
+		_current = 0;
 	}
-	if (opl[1])
+	if (--_tracks == 0)
 	{
-		OPLDestroy(opl[1]);
-		opl[1] = 0;
+		if (opl[0])
+		{
+			OPLDestroy(opl[0]);
+			opl[0] = 0;
+		}
+		if (opl[1])
+		{
+			OPLDestroy(opl[1]);
+			opl[1] = 0;
+		}
 	}
 	delete[] _data;
 }
@@ -125,6 +138,7 @@ void AdlibMusic::play(int) const
 	{
 		stop();
 		func_setup_music((unsigned char*)_data, _size);
+		_current = this;
 		func_set_music_volume(127 * _volume);
 		Mix_HookMusic(player, (void*)this);
 	}
@@ -37,6 +37,10 @@ private:
 	float _volume;
 	static int delay, rate;
 	static std::map<int, int> delayRates;
+	/// Number of tracks sharing the OPL chips.
+	static int _tracks;
+	/// Track last set up in the player.
+	static const AdlibMusic *_current;
 public:
 	/// Creates a blank music track.
 	AdlibMusic(float volume = 1.0f);
@@ -64,8 +64,12 @@
 #include <cstdio>
 #include <cstdlib>
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/param.h>
 #include <sys/types.h>
+#ifndef __MORPHOS__
+#include <sys/mman.h>
+#endif
 #include <pwd.h>
 #include <execinfo.h>
 #include <cxxabi.h>
@@ -549,6 +553,72 @@ bool deleteFile(const std::string &path)
 #endif
 }
 
+/**
+ * Maps a whole file into memory for reading, so it's
+ * paged in as it's read instead of loaded up front.
+ * @param path Full path to file.
+ * @param size Returns the size of the file in bytes.
+ * @return Pointer to the file contents, or NULL if the file
+ * couldn't be mapped (use regular file reading instead).
+ */
+void *mapFile(const std::string &path, size_t *size)
+{
+	*size = 0;
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return 0;
+	LARGE_INTEGER fileSize;
+	void *data = 0;
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0 && fileSize.HighPart == 0)
+	{
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping != NULL)
+		{
+			// the view keeps the mapping alive by itself
+			data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(file);
+	if (data != 0)
+		*size = fileSize.LowPart;
+	return data;
+#elif __MORPHOS__
+	return 0;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return 0;
+	struct stat info;
+	void *data = 0;
+	if (fstat(fd, &info) == 0 && info.st_size > 0)
+	{
+		data = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED)
+			data = 0;
+	}
+	close(fd);
+	if (data != 0)
+		*size = info.st_size;
+	return data;
+#endif
+}
+
+/**
+ * Unmaps a file mapped with mapFile.
+ * @param data Pointer to the file contents.
+ * @param size Size of the file in bytes.
+ */
+void unmapFile(void *data, size_t size)
+{
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+#elif !defined(__MORPHOS__)
+	munmap(data, size);
+#endif
+}
+
 /**
  * Returns only the filename from a specified path.
  * @param path Full path.
@@ -67,6 +67,10 @@ namespace CrossPlatform
 	bool fileExists(const std::string &path);
 	/// Deletes the specified file.
 	bool deleteFile(const std::string &path);
+	/// Maps a file into memory for reading.
+	void *mapFile(const std::string &path, size_t *size);
+	/// Unmaps a file mapped into memory.
+	void unmapFile(void *data, size_t size);
 	/// Gets the pathless filename of a file.
 	std::string baseFilename(const std::string &path);
 	/// Sanitizes the characters in a filename.
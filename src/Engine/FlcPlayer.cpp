@@ -32,6 +32,7 @@
 #include <SDL_mixer.h>
 #include <fstream>
 #include "Logger.h"
+#include "CrossPlatform.h"
 #include "Screen.h"
 #include "Surface.h"
 #include "Options.h"
@@ -79,9 +80,18 @@ enum PlayingState
 	SKIPPED
 };
 
-FlcPlayer::FlcPlayer() : _fileBuf(0), _mainScreen(0), _realScreen(0), _game(0)
+FlcPlayer::FlcPlayer() : _fileBuf(0), _fileSize(0), _fileMapped(false), _mainScreen(0), _realScreen(0), _decodingFrame(0), _canvas(0), _showFrame(0),
+	_decoder(0), _framesFree(0), _framesReady(0), _decoderStop(false), _game(0)
 {
 	_volume = Game::volumeExponent(Options::musicVolume);
+	_audioData.samples = 0;
+	_audioData.capacity = 0;
+	_audioData.readPos = 0;
+	_audioData.writePos = 0;
+	for (int i = 0; i < FRAME_BUFFERS; ++i)
+	{
+		_frames[i].pixels = 0;
+	}
 }
 
 FlcPlayer::~FlcPlayer()
@@ -90,7 +100,7 @@ FlcPlayer::~FlcPlayer()
 }
 
 /**
- * Initialize data structures needed buy the player and read the whole file into memory
+ * Initialize data structures needed buy the player and map the file into memory
  * @param filename Video file name
  * @param frameCallback Function to call each video frame
  * @param game Pointer to the Game instance
@@ -117,25 +127,29 @@ bool FlcPlayer::init(const char *filename, void(*frameCallBack)(), Game *game, b
 	_frameCount = 0;
 	_audioFrameData = 0;
 	_hasAudio = false;
-	_audioData.loadingBuffer = 0;
-	_audioData.playingBuffer = 0;
 
-	std::ifstream file;
-	file.open(filename, std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
-	if (!file.is_open())
+	// Frames are paged in as they're decoded, so playback starts right away
+	size_t size = 0;
+	_fileBuf = (Uint8*)CrossPlatform::mapFile(filename, &size);
+	_fileMapped = (_fileBuf != 0);
+	if (!_fileMapped)
 	{
-		Log(LOG_ERROR) << "Could not open FLI/FLC file: " << filename;
-		return false;
-	}
+		std::ifstream file;
+		file.open(filename, std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+		if (!file.is_open())
+		{
+			Log(LOG_ERROR) << "Could not open FLI/FLC file: " << filename;
+			return false;
+		}
 
-	std::streamoff size = file.tellg();
-	file.seekg(0, std::ifstream::beg);
+		size = file.tellg();
+		file.seekg(0, std::ifstream::beg);
 
-	// TODO: substitute with a cross-platform memory mapped file?
-	_fileBuf = new Uint8[size];
+		_fileBuf = new Uint8[size];
+		file.read((char *)_fileBuf, size);
+		file.close();
+	}
 	_fileSize = size;
-	file.read((char *)_fileBuf, size);
-	file.close();
 
 	_audioFrameData = _fileBuf + 128;
 
@@ -150,6 +164,13 @@ bool FlcPlayer::init(const char *filename, void(*frameCallBack)(), Game *game, b
 		_screenDepth = 8;
 
 		Log(LOG_INFO) << "Playing flx, " << _screenWidth << "x" << _screenHeight << ", " << _headerFrames << " frames";
+
+		_canvas = new Uint8[_screenWidth * _screenHeight]();
+		for (int i = 0; i < FRAME_BUFFERS; ++i)
+		{
+			_frames[i].pixels = new Uint8[_screenWidth * _screenHeight];
+		}
+		memset(_palette, 0, sizeof(_palette));
 	}
 	else
 	{
@@ -180,6 +201,8 @@ bool FlcPlayer::init(const char *filename, void(*frameCallBack)(), Game *game, b
 
 void FlcPlayer::deInit()
 {
+	stopDecoder();
+
 	if (_mainScreen != 0 && _realScreen != 0)
 	{
 		if (_mainScreen != _realScreen->getSurface()->getSurface())
@@ -190,11 +213,22 @@ void FlcPlayer::deInit()
 
 	if (_fileBuf != 0)
 	{
-		delete[] _fileBuf;
+		if (_fileMapped)
+			CrossPlatform::unmapFile(_fileBuf, _fileSize);
+		else
+			delete[] _fileBuf;
 		_fileBuf = 0;
 
 		deInitAudio();
 	}
+
+	delete[] _canvas;
+	_canvas = 0;
+	for (int i = 0; i < FRAME_BUFFERS; ++i)
+	{
+		delete[] _frames[i].pixels;
+		_frames[i].pixels = 0;
+	}
 }
 
 /**
@@ -213,6 +247,8 @@ void FlcPlayer::play(bool skipLastFrame)
 	_videoFrameData = _fileBuf + 128;
 	_audioFrameData = _videoFrameData;
 
+	startDecoder();
+
 	while (!shouldQuit())
 	{
 		if (_frameCallBack)
@@ -227,6 +263,79 @@ void FlcPlayer::play(bool skipLastFrame)
 			SDLPolling();
 	}
 
+	stopDecoder();
+}
+
+/**
+ * Starts decoding video frames ahead of time on a separate
+ * thread. If the thread can't be started, each frame is
+ * decoded right before it's shown instead.
+ */
+void FlcPlayer::startDecoder()
+{
+	_showFrame = 0;
+	_decoderStop = false;
+	_framesFree = SDL_CreateSemaphore(FRAME_BUFFERS);
+	_framesReady = SDL_CreateSemaphore(0);
+	if (_framesFree != 0 && _framesReady != 0)
+	{
+		_decoder = SDL_CreateThread(decoderThread, this);
+	}
+	if (_decoder == 0)
+	{
+		Log(LOG_WARNING) << "Could not start the video decoder thread";
+	}
+}
+
+/**
+ * Stops the decoder thread, dropping any frames left.
+ */
+void FlcPlayer::stopDecoder()
+{
+	if (_decoder != 0)
+	{
+		_decoderStop = true;
+		SDL_SemPost(_framesFree);
+		SDL_WaitThread(_decoder, 0);
+		_decoder = 0;
+	}
+	if (_framesFree != 0)
+	{
+		SDL_DestroySemaphore(_framesFree);
+		_framesFree = 0;
+	}
+	if (_framesReady != 0)
+	{
+		SDL_DestroySemaphore(_framesReady);
+		_framesReady = 0;
+	}
+}
+
+/**
+ * Decoder thread, keeps the frame buffers filled
+ * with the upcoming frames until the video ends.
+ * @param player Pointer to the player.
+ * @return Always 0.
+ */
+int FlcPlayer::decoderThread(void *player)
+{
+	FlcPlayer *flc = (FlcPlayer*)player;
+	int next = 0;
+	while (true)
+	{
+		SDL_SemWait(flc->_framesFree);
+		if (flc->_decoderStop)
+			break;
+
+		VideoFrame *frame = &flc->_frames[next];
+		flc->decodeFrame(frame);
+		next = (next + 1) % FRAME_BUFFERS;
+		SDL_SemPost(flc->_framesReady);
+
+		if (!frame->valid || frame->last)
+			break;
+	}
+	return 0;
 }
 
 void FlcPlayer::delay(Uint32 milliseconds)
@@ -290,13 +399,17 @@ void FlcPlayer::readFileHeader()
 
 bool FlcPlayer::isValidFrame(Uint8 *frameHeader, Uint32 &frameSize, Uint16 &frameType)
 {
+	// the file is mapped, reading past the end isn't safe
+	if (frameHeader + 6 > _fileBuf + _fileSize)
+		return false;
+
 	readU32(frameSize, frameHeader);
 	readU16(frameType, frameHeader + 4);
 
 	return (frameType == FRAME_TYPE || frameType == AUDIO_CHUNK || frameType == PREFIX_CHUNK);
 }
 
-void FlcPlayer::decodeAudio(int frames)
+bool FlcPlayer::decodeAudio(int frames)
 {
 
 	int audioFramesFound = 0;
@@ -320,9 +433,9 @@ void FlcPlayer::decodeAudio(int frames)
 
 				readU16(sampleRate, _audioFrameData + 8);
 
-				_chunkData = _audioFrameData + 16;
-
-				playAudioFrame(sampleRate);
+				// The queue is full, try again once it's played some more
+				if (!playAudioFrame(sampleRate, _audioFrameData + 16))
+					return false;
 
 				_audioFrameData += _audioFrameSize + 16;
 
@@ -331,58 +444,137 @@ void FlcPlayer::decodeAudio(int frames)
 				break;
 		}
 	}
+	return audioFramesFound == frames;
 }
 
 void FlcPlayer::decodeVideo(bool skipLastFrame)
 {
-	bool videoFrameFound = false;
+	VideoFrame *frame;
+	if (_decoder != 0)
+	{
+		SDL_SemWait(_framesReady);
+		frame = &_frames[_showFrame];
+		_showFrame = (_showFrame + 1) % FRAME_BUFFERS;
+	}
+	else
+	{
+		frame = &_frames[0];
+		decodeFrame(frame);
+	}
 
-	while (!videoFrameFound)
+	if (!frame->valid)
 	{
-		if (!isValidFrame(_videoFrameData, _videoFrameSize, _videoFrameType))
+		_playingState = FINISHED;
+	}
+	else
+	{
+		Uint32 delay;
+
+		if (_headerType == FLI_TYPE)
 		{
+			delay = frame->delayOverride > 0 ? frame->delayOverride : _headerSpeed * (1000.0 / 70.0);
+		}
+		else if (_useInternalAudio && !_frameCallBack) // this means TFTD videos are playing
+		{
+			delay = _videoDelay;
+		}
+		else
+		{
+			delay = _headerSpeed;
+		}
+
+		waitForNextFrame(delay);
+
+		// If this frame is the last one, don't play it
+		if (frame->last)
 			_playingState = FINISHED;
-			break;
+
+		if(!shouldQuit() || !skipLastFrame)
+			playVideoFrame(frame);
+	}
+
+	if (_decoder != 0)
+		SDL_SemPost(_framesFree);
+}
+
+/**
+ * Decodes the next video frame into the canvas, which
+ * keeps the picture between frames, and copies the
+ * result to the frame buffer. Runs on the decoder thread.
+ * @param frame Frame buffer to fill.
+ */
+void FlcPlayer::decodeFrame(VideoFrame *frame)
+{
+	_decodingFrame = frame;
+	frame->firstColor = 256;
+	frame->lastColor = -1;
+	frame->valid = false;
+	frame->last = false;
+
+	while (true)
+	{
+		if (!isValidFrame(_videoFrameData, _videoFrameSize, _videoFrameType))
+		{
+			return;
 		}
 
 		switch (_videoFrameType)
 		{
 		case FRAME_TYPE:
-
-			Uint32 delay;
-
 			readU16(_frameChunks, _videoFrameData + 6);
-			readU16(_delayOverride, _videoFrameData + 8);
-
-			if (_headerType == FLI_TYPE)
-			{
-				delay = _delayOverride > 0 ? _delayOverride : _headerSpeed * (1000.0 / 70.0);
-			}
-			else if (_useInternalAudio && !_frameCallBack) // this means TFTD videos are playing
-			{
-				delay = _videoDelay;
-			}
-			else
-			{
-				delay = _headerSpeed;
-			}
-
-			waitForNextFrame(delay);
+			readU16(frame->delayOverride, _videoFrameData + 8);
 
 			// Skip the frame header, we are not interested in the rest
 			_chunkData = _videoFrameData + 16;
 
 			_videoFrameData += _videoFrameSize;
-			// If this frame is the last one, don't play it
-			if(isEndOfFile(_videoFrameData))
-				_playingState = FINISHED;
+			frame->last = isEndOfFile(_videoFrameData);
+			frame->valid = true;
+
+			for (int i = 0; i < _frameChunks; ++i)
+			{
+				readU32(_chunkSize, _chunkData);
+				readU16(_chunkType, _chunkData + 4);
 
-			if(!shouldQuit() || !skipLastFrame)
-				playVideoFrame();
+				switch (_chunkType)
+				{
+					case COLOR_256:
+						color256();
+						break;
+					case FLI_SS2:
+						fliSS2();
+						break;
+					case COLOR_64:
+						color64();
+						break;
+					case FLI_LC:
+						fliLC();
+						break;
+					case BLACK:
+						black();
+						break;
+					case FLI_BRUN:
+						fliBRun();
+						break;
+					case FLI_COPY:
+						fliCopy();
+						break;
+					case 18:
+						break;
+					default:
+						Log(LOG_WARNING) << "Ieek an non implemented chunk type:" << _chunkType;
+						break;
+				}
 
-			videoFrameFound = true;
+				_chunkData += _chunkSize;
+			}
 
-			break;
+			memcpy(frame->pixels, _canvas, _screenWidth * _screenHeight);
+			if (frame->firstColor <= frame->lastColor)
+			{
+				std::copy(_palette + frame->firstColor, _palette + frame->lastColor + 1, frame->colors + frame->firstColor);
+			}
+			return;
 		case AUDIO_CHUNK:
 			_videoFrameData += _videoFrameSize + 16;
 			break;
@@ -395,49 +587,31 @@ void FlcPlayer::decodeVideo(bool skipLastFrame)
 	}
 }
 
-void FlcPlayer::playVideoFrame()
+/**
+ * Shows a decoded frame on the screen.
+ * @param frame Frame buffer to show.
+ */
+void FlcPlayer::playVideoFrame(VideoFrame *frame)
 {
 	++_frameCount;
+	if (frame->firstColor <= frame->lastColor)
+	{
+		int count = frame->lastColor - frame->firstColor + 1;
+		if (_mainScreen != _realScreen->getSurface()->getSurface())
+			SDL_SetColors(_mainScreen, frame->colors + frame->firstColor, frame->firstColor, count);
+		_realScreen->setPalette(frame->colors + frame->firstColor, frame->firstColor, count, true);
+	}
+
 	if (SDL_LockSurface(_mainScreen) < 0)
 		return;
-	int chunkCount = _frameChunks;
 
-	for (int i = 0; i < chunkCount; ++i)
+	Uint8 *pDst = (Uint8*)_mainScreen->pixels + _offset;
+	const Uint8 *pSrc = frame->pixels;
+	for (int y = 0; y < _screenHeight; ++y)
 	{
-		readU32(_chunkSize, _chunkData);
-		readU16(_chunkType, _chunkData + 4);
-
-		switch (_chunkType)
-		{
-			case COLOR_256:
-				color256();
-				break;
-			case FLI_SS2:
-				fliSS2();
-				break;
-			case COLOR_64:
-				color64();
-				break;
-			case FLI_LC:
-				fliLC();
-				break;
-			case BLACK:
-				black();
-				break;
-			case FLI_BRUN:
-				fliBRun();
-				break;
-			case FLI_COPY:
-				fliCopy();
-				break;
-			case 18:
-				break;
-			default:
-				Log(LOG_WARNING) << "Ieek an non implemented chunk type:" << _chunkType;
-				break;
-		}
-
-		_chunkData += _chunkSize;
+		memcpy(pDst, pSrc, _screenWidth);
+		pDst += _mainScreen->pitch;
+		pSrc += _screenWidth;
 	}
 
 	SDL_UnlockSurface(_mainScreen);
@@ -450,7 +624,7 @@ void FlcPlayer::playVideoFrame()
 	_realScreen->flip();
 }
 
-void FlcPlayer::playAudioFrame(Uint16 sampleRate)
+bool FlcPlayer::playAudioFrame(Uint16 sampleRate, const Uint8 *samples)
 {
 	/* TFTD audio header (10 bytes)
 	* Uint16 unknown1 - always 0
@@ -474,30 +648,43 @@ void FlcPlayer::playAudioFrame(Uint16 sampleRate)
 			assert(sampleRate == _audioData.sampleRate);
 		}
 
-		SDL_SemWait(_audioData.sharedLock);
-		AudioBuffer *loadingBuff = _audioData.loadingBuffer;
-		assert(loadingBuff->currSamplePos == 0);
-		int newSize = (_audioFrameSize + loadingBuff->sampleCount )*2;
-		if (newSize > loadingBuff->sampleBufSize)
-		{
-			/* If the sample count has changed, we need to reallocate (Handles initial state
-			* of '0' sample count too, as realloc(NULL, size) == malloc(size) */
-			loadingBuff->samples = (Sint16*)realloc(loadingBuff->samples, newSize);
-			loadingBuff->sampleBufSize = newSize;
-		}
+		/* No audio to play it on, or a chunk that would never fit */
+		if (_audioData.samples == 0 || _audioFrameSize > _audioData.capacity)
+			return true;
+
+		Uint32 readPos = _audioData.readPos;
+		Uint32 writePos = _audioData.writePos;
+		if (_audioData.capacity - (writePos - readPos) < _audioFrameSize)
+			return false;
 
-		for (unsigned int i = 0; i < _audioFrameSize; i++)
+		Uint32 mask = _audioData.capacity - 1;
+		for (Uint32 i = 0; i < _audioFrameSize; i++)
 		{
-			loadingBuff->samples[loadingBuff->sampleCount + i] = (float)((_chunkData[i]) -128) * 240 * _volume;
+			_audioData.samples[(writePos + i) & mask] = (float)((samples[i]) -128) * 240 * _volume;
 		}
-		loadingBuff->sampleCount += _audioFrameSize;
-
-		SDL_SemPost(_audioData.sharedLock);
+		_audioData.writePos = writePos + _audioFrameSize;
 	}
 	else
 	{
 		_audioData.sampleRate = sampleRate; // this is used to keep the framerate correct
 	}
+	return true;
+}
+
+/**
+ * Applies a packet of colors to the palette being decoded
+ * and marks them as changed by the current frame.
+ * @param first First color index.
+ * @param count Number of colors.
+ */
+void FlcPlayer::setColors(int first, int count)
+{
+	count = std::min(count, 256 - first);
+	if (count <= 0)
+		return;
+	std::copy(_colors, _colors + count, _palette + first);
+	_decodingFrame->firstColor = std::min(_decodingFrame->firstColor, first);
+	_decodingFrame->lastColor = std::max(_decodingFrame->lastColor, first + count - 1);
 }
 
 void FlcPlayer::color256()
@@ -527,9 +714,7 @@ void FlcPlayer::color256()
 			_colors[i].b = *(pSrc++);
 		}
 
-		if (_mainScreen != _realScreen->getSurface()->getSurface())
-			SDL_SetColors(_mainScreen, _colors, numColorsSkip, numColors);
-		_realScreen->setPalette(_colors, numColorsSkip, numColors, true);
+		setColors(numColorsSkip, numColors);
 
 		if (numColorPackets >= 1)
 		{
@@ -549,7 +734,7 @@ void FlcPlayer::fliSS2()
 	Uint8 lastByte = 0;
 
 	pSrc = _chunkData + 6;
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = _canvas;
 	readU16(lines, pSrc);
 
 	pSrc += 2;
@@ -561,7 +746,7 @@ void FlcPlayer::fliSS2()
 
 		if ((count & MASK) == SKIP_LINES)
 		{
-			pDst += (-count)*_mainScreen->pitch;
+			pDst += (-count)*_screenWidth;
 			++lines;
 			continue;
 		}
@@ -610,9 +795,9 @@ void FlcPlayer::fliSS2()
 			if (setLastByte)
 			{
 				setLastByte = false;
-				*(pDst + _mainScreen->pitch - 1) = lastByte;
+				*(pDst + _screenWidth - 1) = lastByte;
 			}
-			pDst += _mainScreen->pitch;
+			pDst += _screenWidth;
 		}
 	}
 }
@@ -625,7 +810,7 @@ void FlcPlayer::fliBRun()
 
 	heightCount = _headerHeight;
 	pSrc = _chunkData + 6; // Skip chunk header
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = _canvas;
 
 	while (heightCount--)
 	{
@@ -657,7 +842,7 @@ void FlcPlayer::fliBRun()
 				}
 			}
 		}
-		pDst += _mainScreen->pitch;
+		pDst += _screenWidth;
 	}
 }
 
@@ -672,11 +857,11 @@ void FlcPlayer::fliLC()
 	int packetsCount;
 
 	pSrc = _chunkData + 6;
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = _canvas;
 
 	readU16(tmp, pSrc);
 	pSrc += 2;
-	pDst += tmp*_mainScreen->pitch;
+	pDst += tmp*_screenWidth;
 	readU16(lines, pSrc);
 	pSrc += 2;
 
@@ -711,7 +896,7 @@ void FlcPlayer::fliLC()
 				}
 			}
 		}
-		pDst += _mainScreen->pitch;
+		pDst += _screenWidth;
 	}
 }
 
@@ -742,9 +927,7 @@ void FlcPlayer::color64()
 			_colors[i].b = *(pSrc++) << 2;
 		}
 
-		if (_mainScreen != _realScreen->getSurface()->getSurface())
-			SDL_SetColors(_mainScreen, _colors, NumColorsSkip, NumColors);
-		_realScreen->setPalette(_colors, NumColorsSkip, NumColors, true);
+		setColors(NumColorsSkip, NumColors);
 	}
 }
 
@@ -753,13 +936,13 @@ void FlcPlayer::fliCopy()
 	Uint8 *pSrc, *pDst;
 	int Lines = _screenHeight;
 	pSrc = _chunkData + 6;
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = _canvas;
 
 	while (Lines--)
 	{
 		memcpy(pDst, pSrc, _screenWidth);
 		pSrc += _screenWidth;
-		pDst += _mainScreen->pitch;
+		pDst += _screenWidth;
 	}
 }
 
@@ -767,12 +950,12 @@ void FlcPlayer::black()
 {
 	Uint8 *pDst;
 	int Lines = _screenHeight;
-	pDst = (Uint8*)_mainScreen->pixels + _offset;
+	pDst = _canvas;
 
 	while (Lines-- > 0)
 	{
-		memset(pDst, 0, _screenHeight);
-		pDst += _mainScreen->pitch;
+		memset(pDst, 0, _screenWidth);
+		pDst += _screenWidth;
 	}
 }
 
@@ -780,35 +963,22 @@ void FlcPlayer::audioCallback(void *userData, Uint8 *stream, int len)
 {
 	AudioData *audio = (AudioData*)userData;
 
-	AudioBuffer *playBuff = audio->playingBuffer;
+	Sint16 *samples = (Sint16*)stream;
+	Uint32 wanted = len / 2;
+	Uint32 readPos = audio->readPos;
+	Uint32 count = std::min(wanted, audio->writePos - readPos);
+	Uint32 mask = audio->capacity - 1;
 
-	while (len > 0)
+	for (Uint32 i = 0; i < count; ++i)
 	{
-		if (playBuff->sampleCount > 0)
-		{
-			int bytesToCopy = std::min(len, playBuff->sampleCount * 2);
-			memcpy(stream, playBuff->samples + playBuff->currSamplePos, bytesToCopy);
-
-			playBuff->currSamplePos += bytesToCopy / 2;
-			playBuff->sampleCount -= bytesToCopy / 2;
-			len -= bytesToCopy;
-
-			assert(playBuff->sampleCount >= 0);
-		}
+		samples[i] = audio->samples[(readPos + i) & mask];
+	}
+	audio->readPos = readPos + count;
 
-		if (len > 0)
-		{
-			/* Need to swap buffers */
-			playBuff->currSamplePos = 0;
-			SDL_SemWait(audio->sharedLock);
-			AudioBuffer *tempBuff = playBuff;
-			audio->playingBuffer = playBuff = audio->loadingBuffer;
-			audio->loadingBuffer = tempBuff;
-			SDL_SemPost(audio->sharedLock);
-
-			if (playBuff->sampleCount == 0)
-				break;
-		}
+	/* Ran dry, play silence until more is decoded */
+	if (count < wanted)
+	{
+		memset(samples + count, 0, (wanted - count) * 2);
 	}
 }
 
@@ -828,20 +998,16 @@ void FlcPlayer::initAudio(Uint16 format, Uint8 channels)
 			return;
 		}
 
-		/* Start runnable */
-		_audioData.sharedLock = SDL_CreateSemaphore(1);
-
-		_audioData.loadingBuffer = new AudioBuffer();
-		_audioData.loadingBuffer->currSamplePos = 0;
-		_audioData.loadingBuffer->sampleCount = 0;
-		_audioData.loadingBuffer->samples = (Sint16 *)malloc(_audioFrameSize * 2);
-		_audioData.loadingBuffer->sampleBufSize = _audioFrameSize * 2;
-
-		_audioData.playingBuffer = new AudioBuffer();
-		_audioData.playingBuffer->currSamplePos = 0;
-		_audioData.playingBuffer->sampleCount = 0;
-		_audioData.playingBuffer->samples = (Sint16 *)malloc(_audioFrameSize * 2);
-		_audioData.playingBuffer->sampleBufSize = _audioFrameSize * 2;
+		/* Room for at least a second of audio, and a few chunks */
+		Uint32 capacity = 1;
+		while (capacity < (Uint32)_audioData.sampleRate || capacity < _audioFrameSize * 4)
+		{
+			capacity <<= 1;
+		}
+		_audioData.samples = new Sint16[capacity];
+		_audioData.capacity = capacity;
+		_audioData.readPos = 0;
+		_audioData.writePos = 0;
 
 		Mix_HookMusic(FlcPlayer::audioCallback, &_audioData);
 	}
@@ -855,23 +1021,10 @@ void FlcPlayer::deInitAudio()
 		Mix_CloseAudio();
 		_game->initAudio();
 	}
-	else if(_audioData.sharedLock)
-		SDL_DestroySemaphore(_audioData.sharedLock);
-
-	if (_audioData.loadingBuffer)
-	{
-		free(_audioData.loadingBuffer->samples);
-		delete _audioData.loadingBuffer;
-		_audioData.loadingBuffer = 0;
-	}
-
-	if (_audioData.playingBuffer)
-	{
-		free(_audioData.playingBuffer->samples);
-		delete _audioData.playingBuffer;
-		_audioData.playingBuffer = 0;
-	}
 
+	delete[] _audioData.samples;
+	_audioData.samples = 0;
+	_audioData.capacity = 0;
 }
 
 void FlcPlayer::stop()
@@ -918,9 +1071,8 @@ void FlcPlayer::waitForNextFrame(Uint32 delay)
 	{
 		while (currentTick < newTick)
 		{
-			while ((newTick - currentTick) > 10 && !isEndOfFile(_audioFrameData))
+			while ((newTick - currentTick) > 10 && !isEndOfFile(_audioFrameData) && decodeAudio(1))
 			{
-				decodeAudio(1);
 				currentTick = SDL_GetTicks();
 			}
 			SDL_Delay(1);
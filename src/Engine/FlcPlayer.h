@@ -22,7 +22,9 @@
 /*
  * Based on http://www.libsdl.org/projects/flxplay/
  */
+#include <atomic>
 #include <SDL.h>
+#include <SDL_thread.h>
 
 namespace OpenXcom
 {
@@ -36,6 +38,7 @@ private:
 
 	Uint8 *_fileBuf;
 	Uint32 _fileSize;
+	bool _fileMapped;
 	Uint8 *_videoFrameData;
 	Uint8 *_chunkData;
 	Uint8 *_audioFrameData;
@@ -71,26 +74,41 @@ private:
 	int _videoDelay;
 	double _volume;
 
-	typedef struct AudioBuffer
-	{
-		Sint16 *samples;
-		int sampleCount;
-		int sampleBufSize;
-		int currSamplePos;
-	}AudioBuffer;
-
-
+	/* Single producer, single consumer ring of samples,
+	 * the positions only ever grow and wrap around the
+	 * power of two capacity */
 	typedef struct AudioData
 	{
 		int sampleRate;
-		AudioBuffer *loadingBuffer;
-		AudioBuffer *playingBuffer;
-		SDL_sem *sharedLock;
-
+		Sint16 *samples;
+		Uint32 capacity;
+		std::atomic<Uint32> readPos;
+		std::atomic<Uint32> writePos;
 	}AudioData;
 
 	AudioData _audioData;
 
+	/* A decoded frame waiting to be shown, with the
+	 * palette range it changed (none if first > last) */
+	typedef struct VideoFrame
+	{
+		Uint8 *pixels;
+		SDL_Color colors[256];
+		int firstColor, lastColor;
+		Uint16 delayOverride;
+		bool valid, last;
+	}VideoFrame;
+
+	static const int FRAME_BUFFERS = 3;
+	VideoFrame _frames[FRAME_BUFFERS];
+	VideoFrame *_decodingFrame;
+	Uint8 *_canvas;
+	SDL_Color _palette[256];
+	int _showFrame;
+	SDL_Thread *_decoder;
+	SDL_sem *_framesFree, *_framesReady;
+	std::atomic<bool> _decoderStop;
+
 	Game *_game;
 
 	void readU16(Uint16 &dst, const Uint8 *const src);
@@ -101,12 +119,17 @@ private:
 
 	bool isValidFrame(Uint8 *frameHeader, Uint32 &frameSize, Uint16 &frameType);
 	void decodeVideo(bool skipLastFrame);
-	void decodeAudio(int frames);
+	void decodeFrame(VideoFrame *frame);
+	void startDecoder();
+	void stopDecoder();
+	static int decoderThread(void *player);
+	bool decodeAudio(int frames);
 	void waitForNextFrame(Uint32 delay);
 	void SDLPolling();
 	bool shouldQuit();
 
-	void playVideoFrame();
+	void playVideoFrame(VideoFrame *frame);
+	void setColors(int first, int count);
 	void color256();
 	void fliBRun();
 	void fliCopy();
@@ -115,7 +138,7 @@ private:
 	void color64();
 	void black();
 
-	void playAudioFrame(Uint16 sampleRate);
+	bool playAudioFrame(Uint16 sampleRate, const Uint8 *samples);
 	void initAudio(Uint16 format, Uint8 channels);
 	void deInitAudio();
 
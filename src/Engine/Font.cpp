@@ -25,6 +25,17 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Number of codepoints stored per page of the glyph table.
+const UCode GLYPH_PAGE_BITS = 8;
+const UCode GLYPH_PAGE_SIZE = 1 << GLYPH_PAGE_BITS;
+/// Used when the font doesn't even have a question mark.
+const FontGlyph NO_GLYPH = { 0, { 0, 0, 0, 0 } };
+
+}
+
 /**
  * Initializes the font with a blank surface.
  */
@@ -118,7 +129,7 @@ void Font::init(size_t index, const UString &str)
 			rect.y = startY;
 			rect.w = image->width;
 			rect.h = image->height;
-			_chars[str[i]] = std::make_pair(index, rect);
+			setGlyph(str[i], index, rect);
 		}
 	}
 	else
@@ -156,12 +167,60 @@ void Font::init(size_t index, const UString &str)
 			rect.w = right - left + 1;
 			rect.h = image->height;
 
-			_chars[str[i]] = std::make_pair(index, rect);
+			setGlyph(str[i], index, rect);
 		}
 	}
 	surface->unlock();
 }
 
+/**
+ * Stores where a character is in the font's images. The glyphs are
+ * kept in pages of consecutive codepoints so looking one up
+ * is just indexing instead of a search.
+ * @param c Character to store.
+ * @param index The index of the surface with the character.
+ * @param rect Position and size of the character in the surface.
+ */
+void Font::setGlyph(UCode c, size_t index, const SDL_Rect &rect)
+{
+	size_t page = c >> GLYPH_PAGE_BITS;
+	if (page >= _glyphs.size())
+	{
+		_glyphs.resize(page + 1);
+	}
+	if (_glyphs[page].empty())
+	{
+		FontGlyph missing;
+		missing.image = -1;
+		missing.rect.x = missing.rect.y = 0;
+		missing.rect.w = missing.rect.h = 0;
+		_glyphs[page].resize(GLYPH_PAGE_SIZE, missing);
+	}
+	FontGlyph &glyph = _glyphs[page][c & (GLYPH_PAGE_SIZE - 1)];
+	glyph.image = index;
+	glyph.rect = rect;
+}
+
+/**
+ * Returns where a character is in the font's images, falling
+ * back to a question mark for characters the font doesn't have.
+ * @param c Character to look up.
+ * @return Pointer to the glyph.
+ */
+const FontGlyph *Font::getGlyph(UCode c) const
+{
+	size_t page = c >> GLYPH_PAGE_BITS;
+	if (page < _glyphs.size() && !_glyphs[page].empty())
+	{
+		const FontGlyph *glyph = &_glyphs[page][c & (GLYPH_PAGE_SIZE - 1)];
+		if (glyph->image != -1)
+			return glyph;
+	}
+	if (c != '?')
+		return getGlyph('?');
+	return &NO_GLYPH;
+}
+
 /**
  * Returns a particular character from the set stored in the font.
  * @param c Character to use for size/position.
@@ -170,10 +229,9 @@ void Font::init(size_t index, const UString &str)
  */
 Surface *Font::getChar(UCode c)
 {
-	if (_chars.find(c) == _chars.end())
-		c = '?';
-	Surface *surface = _images[_chars[c].first].surface;
-	*surface->getCrop() = _chars[c].second;
+	const FontGlyph *glyph = getGlyph(c);
+	Surface *surface = _images[glyph->image].surface;
+	*surface->getCrop() = glyph->rect;
 	return surface;
 }
 
@@ -216,12 +274,10 @@ SDL_Rect Font::getCharSize(UCode c)
 	SDL_Rect size = { 0, 0, 0, 0 };
 	if (Unicode::isPrintable(c))
 	{
-		if (_chars.find(c) == _chars.end())
-			c = '?';
-
-		FontImage *image = &_images[_chars[c].first];
-		size.w = _chars[c].second.w + image->spacing;
-		size.h = _chars[c].second.h + image->spacing;
+		const FontGlyph *glyph = getGlyph(c);
+		const FontImage *image = &_images[glyph->image];
+		size.w = glyph->rect.w + image->spacing;
+		size.h = glyph->rect.h + image->spacing;
 	}
 	else
 	{
@@ -17,9 +17,7 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <map>
 #include <vector>
-#include <utility>
 #include <string>
 #include <SDL.h>
 #include <yaml-cpp/yaml.h>
@@ -37,6 +35,12 @@ struct FontImage
 	Surface *surface;
 };
 
+struct FontGlyph
+{
+	int image;
+	SDL_Rect rect;
+};
+
 /**
  * Takes care of loading and storing each character in a sprite font.
  * Sprite fonts consist of a set of characters split in fixed-size regions.
@@ -47,10 +51,14 @@ class Font
 {
 private:
 	std::vector<FontImage> _images;
-	std::map< UCode, std::pair<size_t, SDL_Rect> > _chars;
+	std::vector< std::vector<FontGlyph> > _glyphs;
 	bool _monospace;
 	/// Determines the size and position of each character in the font.
 	void init(size_t index, const UString &str);
+	/// Stores the position of a character in the font.
+	void setGlyph(UCode c, size_t index, const SDL_Rect &rect);
+	/// Gets the stored position of a character in the font.
+	const FontGlyph *getGlyph(UCode c) const;
 public:
 
 	/// Creates a blank font.
@@ -38,6 +38,9 @@
 #include "Options.h"
 #include "CrossPlatform.h"
 #include "FileMap.h"
+#include "ObjectPool.h"
+#include "Profiler.h"
+#include "Timer.h"
 #include "Unicode.h"
 #include "../Menu/TestState.h"
 
@@ -45,13 +48,14 @@ namespace OpenXcom
 {
 
 const double Game::VOLUME_GRADIENT = 10.0;
+const unsigned int Game::LOGIC_STEP = 4;
 
 /**
  * Starts up SDL with all the subsystems and SDL_mixer for audio processing,
  * creates the display screen and sets up the cursor.
  * @param title Title of the game window.
  */
-Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0), _mod(0), _quit(false), _init(false), _mouseActive(true), _timeUntilNextFrame(0)
+Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0), _mod(0), _quit(false), _init(false), _mouseActive(true), _timeOfLastFrame(0), _timeOfNextLogic(0)
 {
 	Options::reload = false;
 	Options::mute = false;
@@ -105,7 +109,6 @@ Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0
 	// Create blank language
 	_lang = new Language();
 
-	_timeOfLastFrame = 0;
 }
 
 /**
@@ -130,6 +133,8 @@ Game::~Game()
 	delete _screen;
 	delete _fpsCounter;
 
+	ObjectPool::logStatistics(LOG_VERBOSE);
+
 	Mix_CloseAudio();
 
 	SDL_Quit();
@@ -179,6 +184,7 @@ void Game::run()
 		// Process events
 		while (SDL_PollEvent(&_event))
 		{
+			PROFILE_SCOPE("Game::event");
 			if (CrossPlatform::isQuitShortcut(_event))
 				_event.type = SDL_QUIT;
 			switch (_event.type)
@@ -288,43 +294,67 @@ void Game::run()
 			}
 		}
 		
+		// Process logic in fixed steps, decoupled from rendering
+		if (runningState != PAUSED)
+		{
+			Uint32 now = SDL_GetTicks();
+			if (_timeOfNextLogic == 0)
+			{
+				_timeOfNextLogic = now;
+			}
+			// Fell too far behind, drop the backlog instead of trying to catch up forever
+			if (now > _timeOfNextLogic && now - _timeOfNextLogic > LOGIC_STEP * (Timer::maxFrameSkip + 1))
+			{
+				_timeOfNextLogic = now;
+			}
+			for (int i = 0; i <= Timer::maxFrameSkip && now >= _timeOfNextLogic; ++i)
+			{
+				_timeOfNextLogic += LOGIC_STEP;
+				PROFILE_SCOPE("Game::think");
+				_states.back()->think();
+				_fpsCounter->think();
+				if (!_init)
+				{
+					// States stack was changed, initialize the new state first
+					break;
+				}
+			}
+		}
+
 		// Process rendering
+		int frameDelay = 0;
 		if (runningState != PAUSED)
 		{
-			// Process logic
-			_states.back()->think();
-			_fpsCounter->think();
 			if (Options::FPS > 0 && !(Options::useOpenGL && Options::vSyncForOpenGL))
 			{
 				// Update our FPS delay time based on the time of the last draw.
 				int fps = SDL_GetAppState() & SDL_APPINPUTFOCUS ? Options::FPS : Options::FPSInactive;
-
-				_timeUntilNextFrame = (1000.0f / fps) - (SDL_GetTicks() - _timeOfLastFrame);
-			}
-			else
-			{
-				_timeUntilNextFrame = 0;
+				frameDelay = (1000 + fps - 1) / fps;
 			}
 
-			if (_init && _timeUntilNextFrame <= 0)
+			if (_init && SDL_GetTicks() - _timeOfLastFrame >= (Uint32)frameDelay)
 			{
 				// make a note of when this frame update occurred.
 				_timeOfLastFrame = SDL_GetTicks();
 				_fpsCounter->addFrame();
-				_screen->clear();
-				std::list<State*>::iterator i = _states.end();
-				do
 				{
-					--i;
-				}
-				while (i != _states.begin() && !(*i)->isScreen());
+					PROFILE_SCOPE("Game::blit");
+					_screen->clear();
+					std::list<State*>::iterator i = _states.end();
+					do
+					{
+						--i;
+					}
+					while (i != _states.begin() && !(*i)->isScreen());
 
-				for (; i != _states.end(); ++i)
-				{
-					(*i)->blit();
+					for (; i != _states.end(); ++i)
+					{
+						(*i)->blit();
+					}
+					_fpsCounter->blit(_screen->getSurface());
+					_cursor->blit(_screen->getSurface());
 				}
-				_fpsCounter->blit(_screen->getSurface());
-				_cursor->blit(_screen->getSurface());
+				PROFILE_SCOPE("Game::flip");
 				_screen->flip();
 			}
 		}
@@ -332,8 +362,30 @@ void Game::run()
 		// Save on CPU
 		switch (runningState)
 		{
-			case RUNNING: 
-				SDL_Delay(1); //Save CPU from going 100%
+			case RUNNING:
+				if (frameDelay == 0)
+				{
+					SDL_Delay(1); //Save CPU from going 100%
+				}
+				else if (_init)
+				{
+					// Sleep until something is due: the next logic step, a timer or a frame.
+					Uint32 now = SDL_GetTicks();
+					Uint32 wait = _timeOfNextLogic > now ? _timeOfNextLogic - now : 0;
+					Uint32 frame = _timeOfLastFrame + frameDelay;
+					wait = std::min(wait, frame > now ? frame - now : 0);
+					Uint32 timer = Timer::getTimeUntilNextTimer(wait);
+					if (timer < wait)
+					{
+						// A timer is due before the next step, think as soon as it is
+						wait = timer;
+						_timeOfNextLogic = now + wait;
+					}
+					if (wait > 0)
+					{
+						SDL_Delay(wait);
+					}
+				}
 				break;
 			case SLOWED: case PAUSED:
 				SDL_Delay(100); break; //More slowing down.
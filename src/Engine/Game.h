@@ -51,9 +51,9 @@ private:
 	bool _quit, _init;
 	FpsCounter *_fpsCounter;
 	bool _mouseActive;
-	unsigned int _timeOfLastFrame;
-	int _timeUntilNextFrame;
+	unsigned int _timeOfLastFrame, _timeOfNextLogic;
 	static const double VOLUME_GRADIENT;
+	static const unsigned int LOGIC_STEP;
 
 public:
 	/// Creates a new game and initializes SDL.
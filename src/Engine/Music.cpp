@@ -35,13 +35,16 @@ Music::Music() : _music(0)
 }
 
 /**
- * Deletes the loaded music content.
+ * Deletes the loaded music content. SDL_mixer halts
+ * the track if it's playing, other tracks play on.
  */
 Music::~Music()
 {
 #ifndef __NO_MUSIC
-	stop();
-	Mix_FreeMusic(_music);
+	if (_music != 0)
+	{
+		Mix_FreeMusic(_music);
+	}
 #endif
 }
 
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ObjectPool.h"
+#include <algorithm>
+#include <new>
+
+namespace OpenXcom
+{
+
+/**
+ * Creates an empty pool. Memory is only reserved
+ * once the first object is allocated.
+ * @param name Name shown in the statistics.
+ * @param objectSize Size of the pooled objects.
+ * @param chunkObjects Number of objects reserved at a time.
+ */
+ObjectPool::ObjectPool(const std::string &name, size_t objectSize, size_t chunkObjects) : _name(name), _objectSize(objectSize), _slotSize(0), _chunkObjects(chunkObjects), _free(0), _used(0), _peak(0), _allocations(0), _fallbacks(0)
+{
+	// Every slot must hold a free list link and keep the objects aligned.
+	const size_t align = sizeof(std::max_align_t) < 16 ? sizeof(std::max_align_t) : 16;
+	_slotSize = std::max(objectSize, sizeof(void*));
+	_slotSize = (_slotSize + align - 1) / align * align;
+	getPools().push_back(this);
+}
+
+/**
+ * Frees all the chunks of the pool.
+ */
+ObjectPool::~ObjectPool()
+{
+	for (std::vector<char*>::iterator i = _chunks.begin(); i != _chunks.end(); ++i)
+	{
+		::operator delete(*i);
+	}
+	std::vector<ObjectPool*> &pools = getPools();
+	pools.erase(std::remove(pools.begin(), pools.end(), this), pools.end());
+}
+
+/**
+ * Returns the list of pools currently alive,
+ * used to report their statistics.
+ * @return List of pools.
+ */
+std::vector<ObjectPool*> &ObjectPool::getPools()
+{
+	static std::vector<ObjectPool*> pools;
+	return pools;
+}
+
+/**
+ * Reserves a new chunk of slots and threads
+ * them all into the free list.
+ */
+void ObjectPool::grow()
+{
+	char *chunk = static_cast<char*>(::operator new(_slotSize * _chunkObjects));
+	_chunks.push_back(chunk);
+	for (size_t i = _chunkObjects; i > 0; --i)
+	{
+		void *slot = chunk + (i - 1) * _slotSize;
+		*static_cast<void**>(slot) = _free;
+		_free = slot;
+	}
+}
+
+/**
+ * Takes a free slot from the pool, reserving more
+ * if needed. Objects of a different size (eg. derived
+ * classes) are passed on to the global allocator.
+ * @param size Size of the object.
+ * @return Pointer to the object's memory.
+ */
+void *ObjectPool::allocate(size_t size)
+{
+	if (size != _objectSize)
+	{
+		_fallbacks++;
+		return ::operator new(size);
+	}
+	if (_free == 0)
+	{
+		grow();
+	}
+	void *slot = _free;
+	_free = *static_cast<void**>(slot);
+	_used++;
+	_allocations++;
+	_peak = std::max(_peak, _used);
+	return slot;
+}
+
+/**
+ * Puts the slot of a destroyed object back on the free list.
+ * @param p Pointer to the object's memory.
+ * @param size Size of the object.
+ */
+void ObjectPool::deallocate(void *p, size_t size)
+{
+	if (p == 0)
+	{
+		return;
+	}
+	if (size != _objectSize)
+	{
+		::operator delete(p);
+		return;
+	}
+	*static_cast<void**>(p) = _free;
+	_free = p;
+	_used--;
+}
+
+/**
+ * Returns the name of the pool.
+ * @return Pool name.
+ */
+const std::string &ObjectPool::getName() const
+{
+	return _name;
+}
+
+/**
+ * Returns the number of slots reserved by the pool.
+ * @return Number of slots.
+ */
+size_t ObjectPool::getCapacity() const
+{
+	return _chunks.size() * _chunkObjects;
+}
+
+/**
+ * Returns the number of slots currently holding objects.
+ * @return Number of slots.
+ */
+size_t ObjectPool::getUsed() const
+{
+	return _used;
+}
+
+/**
+ * Returns the highest number of slots that
+ * were holding objects at the same time.
+ * @return Number of slots.
+ */
+size_t ObjectPool::getPeak() const
+{
+	return _peak;
+}
+
+/**
+ * Returns the total number of objects
+ * ever allocated from the pool.
+ * @return Number of allocations.
+ */
+size_t ObjectPool::getAllocations() const
+{
+	return _allocations;
+}
+
+/**
+ * Returns the number of objects that didn't match
+ * the pool's size and went to the global allocator.
+ * @return Number of allocations.
+ */
+size_t ObjectPool::getFallbacks() const
+{
+	return _fallbacks;
+}
+
+/**
+ * Logs the usage of every pool that has been used.
+ * @param level Severity level to log at.
+ */
+void ObjectPool::logStatistics(SeverityLevel level)
+{
+	std::vector<ObjectPool*> &pools = getPools();
+	for (std::vector<ObjectPool*>::const_iterator i = pools.begin(); i != pools.end(); ++i)
+	{
+		if ((*i)->_allocations == 0 && (*i)->_fallbacks == 0)
+		{
+			continue;
+		}
+		Log(level) << "Pool " << (*i)->_name << ": " << (*i)->_used << " in use, " << (*i)->_peak << " peak, " << (*i)->getCapacity() << " reserved, " << (*i)->_allocations << " allocations, " << (*i)->_fallbacks << " unpooled";
+	}
+}
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Logger.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Fixed-size allocator for high-churn game objects.
+ * Hands out slots carved from large chunks and keeps freed
+ * slots on a free list, so objects that are created and
+ * destroyed all the time (projectiles, particles, items...)
+ * don't fragment the heap. Classes opt in with OXC_POOLED_OBJECT.
+ * @note Not thread-safe, pooled objects belong to the game thread.
+ */
+class ObjectPool
+{
+private:
+	std::string _name;
+	size_t _objectSize, _slotSize, _chunkObjects;
+	std::vector<char*> _chunks;
+	void *_free;
+	size_t _used, _peak, _allocations, _fallbacks;
+
+	/// Gets the list of all existing pools.
+	static std::vector<ObjectPool*> &getPools();
+	/// Adds a new chunk of slots to the free list.
+	void grow();
+public:
+	/// Creates a pool for objects of the specified size.
+	ObjectPool(const std::string &name, size_t objectSize, size_t chunkObjects = 64);
+	/// Cleans up the pool.
+	~ObjectPool();
+	/// Allocates memory for an object.
+	void *allocate(size_t size);
+	/// Releases the memory of an object.
+	void deallocate(void *p, size_t size);
+	/// Gets the pool's name.
+	const std::string &getName() const;
+	/// Gets the number of slots the pool has reserved.
+	size_t getCapacity() const;
+	/// Gets the number of slots currently in use.
+	size_t getUsed() const;
+	/// Gets the highest number of slots ever in use.
+	size_t getPeak() const;
+	/// Gets the number of allocations served by the pool.
+	size_t getAllocations() const;
+	/// Gets the number of allocations that bypassed the pool.
+	size_t getFallbacks() const;
+	/// Logs the statistics of every pool.
+	static void logStatistics(SeverityLevel level);
+};
+
+/**
+ * Makes a class allocate its objects from its own ObjectPool, named
+ * after the class. Goes in the public section of the class, existing
+ * new/delete calls then use the pool without any other changes.
+ * Derived classes must not be pooled this way, the slots only fit
+ * the class itself.
+ */
+#define OXC_POOLED_OBJECT(Class) \
+	static ObjectPool &getObjectPool() { static ObjectPool pool(#Class, sizeof(Class)); return pool; } \
+	static void *operator new(size_t size) { return getObjectPool().allocate(size); } \
+	static void operator delete(void *p, size_t size) { getObjectPool().deallocate(p, size); }
+
+}
@@ -53,6 +53,9 @@ std::map<std::string, std::string> _commandLine;
 std::vector<OptionInfo> _info;
 std::map<std::string, ModInfo> _modInfos;
 std::string _masterMod;
+std::string _benchmarkSave;
+int _benchmarkMonths = 1;
+Uint64 _benchmarkSeed = 1;
 
 /**
  * Sets up the options by creating their OptionInfo metadata.
@@ -385,6 +388,20 @@ void loadArgs(int argc, char *argv[])
 				{
 					_masterMod = argv[i];
 				}
+				else if (argname == "benchmark")
+				{
+					_benchmarkSave = argv[i];
+				}
+				else if (argname == "benchmarkmonths")
+				{
+					std::istringstream ss(argv[i]);
+					ss >> _benchmarkMonths;
+				}
+				else if (argname == "benchmarkseed")
+				{
+					std::istringstream ss(argv[i]);
+					ss >> _benchmarkSeed;
+				}
 				else
 				{
 					//save this command line option for now, we will apply it later
@@ -417,6 +434,12 @@ bool showHelp(int argc, char *argv[])
 	help << "        use PATH as the default Config Folder instead of auto-detecting" << std::endl << std::endl;
 	help << "-master MOD" << std::endl;
 	help << "        set MOD to the current master mod (eg. -master xcom2)" << std::endl << std::endl;
+	help << "-benchmark FILE" << std::endl;
+	help << "        run the geoscape of save FILE headless and report its throughput" << std::endl << std::endl;
+	help << "-benchmarkMonths N" << std::endl;
+	help << "        simulate N months of campaign time when benchmarking (default 1)" << std::endl << std::endl;
+	help << "-benchmarkSeed N" << std::endl;
+	help << "        use N as the random seed when benchmarking (default 1)" << std::endl << std::endl;
 	help << "-KEY VALUE" << std::endl;
 	help << "        override option KEY with VALUE (eg. -displayWidth 640)" << std::endl << std::endl;
 	help << "-help" << std::endl;
@@ -1111,6 +1134,36 @@ std::string getMasterUserFolder()
 	return _userFolder + _masterMod + CrossPlatform::PATH_SEPARATOR;
 }
 
+/**
+ * Returns the save to run the headless campaign
+ * benchmark on, if one was requested.
+ * @return Save filename, empty if not benchmarking.
+ */
+std::string getBenchmarkSave()
+{
+	return _benchmarkSave;
+}
+
+/**
+ * Returns how many months the headless campaign
+ * benchmark should simulate.
+ * @return Number of months.
+ */
+int getBenchmarkMonths()
+{
+	return _benchmarkMonths;
+}
+
+/**
+ * Returns the random seed the headless campaign
+ * benchmark should use, so runs are reproducible.
+ * @return RNG seed.
+ */
+Uint64 getBenchmarkSeed()
+{
+	return _benchmarkSeed;
+}
+
 /**
  * Returns the game's list of all available option information.
  * @return List of OptionInfo's.
@@ -87,6 +87,12 @@ namespace Options
 	std::string getConfigFolder();
 	/// Gets the game's master mod user folder.
 	std::string getMasterUserFolder();
+	/// Gets the save to run the campaign benchmark on.
+	std::string getBenchmarkSave();
+	/// Gets the number of months to benchmark.
+	int getBenchmarkMonths();
+	/// Gets the campaign benchmark RNG seed.
+	Uint64 getBenchmarkSeed();
 	/// Gets the game's options.
 	const std::vector<OptionInfo> &getOptionInfo();
 	/// Sets the game's data, user and config folders.
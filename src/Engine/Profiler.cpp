@@ -0,0 +1,272 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Profiler.h"
+#ifdef OXC_PROFILER
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include "Logger.h"
+
+namespace
+{
+
+/// Heap allocations made by any thread.
+std::atomic<size_t> allocations(0);
+
+}
+
+/**
+ * Counts every heap allocation so the overlay can show
+ * how much each scope allocates.
+ * @param size Size in bytes.
+ * @return Allocated memory.
+ */
+void *operator new(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (size == 0)
+	{
+		size = 1;
+	}
+	while (true)
+	{
+		void *p = std::malloc(size);
+		if (p != 0)
+		{
+			return p;
+		}
+		std::new_handler handler = std::get_new_handler();
+		if (handler == 0)
+		{
+			throw std::bad_alloc();
+		}
+		handler();
+	}
+}
+
+/**
+ * Frees memory allocated by the counting operator new.
+ * @param p Allocated memory.
+ */
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Timings of a scope since the last roll over.
+struct ProfilerTotal
+{
+	const char *name;
+	double time, peak;
+	size_t calls, allocations;
+};
+
+/// A single measured call, as saved in the trace.
+struct TraceEvent
+{
+	size_t entry;
+	double start, duration;
+};
+
+/// Traces are capped so a forgotten capture can't eat all the memory.
+const size_t MAX_TRACE_EVENTS = 1 << 20;
+
+std::vector<ProfilerTotal> totals;
+std::vector<ProfilerEntry> entries;
+size_t frames = 0;
+std::vector<TraceEvent> trace;
+bool tracing = false;
+double traceStart = 0.0;
+
+/**
+ * Sorts entries slowest first.
+ */
+bool slowerEntry(const ProfilerEntry &a, const ProfilerEntry &b)
+{
+	return a.time > b.time;
+}
+
+}
+
+/**
+ * Starts the clock for a scope.
+ * @param entry Entry returned by getEntry.
+ */
+Profiler::Probe::Probe(size_t entry) : _entry(entry), _start(now()), _allocations(getAllocations())
+{
+}
+
+/**
+ * Records the time elapsed since the probe was created.
+ */
+Profiler::Probe::~Probe()
+{
+	double duration = now() - _start;
+	ProfilerTotal &total = totals[_entry];
+	total.time += duration;
+	total.peak = std::max(total.peak, duration);
+	total.calls++;
+	total.allocations += getAllocations() - _allocations;
+	if (tracing && trace.size() < MAX_TRACE_EVENTS)
+	{
+		TraceEvent event = { _entry, _start - traceStart, duration };
+		trace.push_back(event);
+	}
+}
+
+/**
+ * Looks up the entry a scope records into. Probes
+ * cache it so this only runs once per scope.
+ * @param name Scope name, must outlive the profiler.
+ * @return Entry index.
+ */
+size_t Profiler::getEntry(const char *name)
+{
+	for (size_t i = 0; i < totals.size(); ++i)
+	{
+		if (strcmp(totals[i].name, name) == 0)
+		{
+			return i;
+		}
+	}
+	ProfilerTotal total = { name, 0.0, 0.0, 0, 0 };
+	totals.push_back(total);
+	return totals.size() - 1;
+}
+
+/**
+ * Counts a rendered frame, timings are averaged per frame.
+ */
+void Profiler::addFrame()
+{
+	frames++;
+}
+
+/**
+ * Turns the totals collected since the last call into
+ * per-frame averages and starts collecting anew.
+ */
+void Profiler::rollOver()
+{
+	double perFrame = 1.0 / std::max(frames, (size_t)1);
+	entries.clear();
+	for (std::vector<ProfilerTotal>::iterator i = totals.begin(); i != totals.end(); ++i)
+	{
+		if (i->calls != 0)
+		{
+			ProfilerEntry entry = { i->name, i->time * 1000.0 * perFrame, i->peak * 1000.0, i->calls * perFrame, i->allocations * perFrame };
+			entries.push_back(entry);
+		}
+		i->time = i->peak = 0.0;
+		i->calls = i->allocations = 0;
+	}
+	std::sort(entries.begin(), entries.end(), slowerEntry);
+	frames = 0;
+}
+
+/**
+ * Gets the timings averaged by the last roll over,
+ * in milliseconds per frame.
+ * @return List of entries, slowest first.
+ */
+const std::vector<ProfilerEntry> &Profiler::getEntries()
+{
+	return entries;
+}
+
+/**
+ * Starts recording every measured call into a trace.
+ */
+void Profiler::startTrace()
+{
+	trace.clear();
+	traceStart = now();
+	tracing = true;
+	Log(LOG_INFO) << "Profiler trace started";
+}
+
+/**
+ * Stops recording and saves the trace in the Chrome
+ * trace event format, viewable in chrome://tracing.
+ * @param filename Full path of the trace file.
+ */
+void Profiler::stopTrace(const std::string &filename)
+{
+	tracing = false;
+	std::ofstream out(filename.c_str());
+	if (!out)
+	{
+		Log(LOG_WARNING) << "Failed to save " << filename;
+		return;
+	}
+	out << "{\"traceEvents\":[";
+	for (std::vector<TraceEvent>::const_iterator i = trace.begin(); i != trace.end(); ++i)
+	{
+		if (i != trace.begin())
+		{
+			out << ",";
+		}
+		out << "\n{\"name\":\"" << totals[i->entry].name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1";
+		out << ",\"ts\":" << (long long)(i->start * 1000000.0) << ",\"dur\":" << (long long)(i->duration * 1000000.0) << "}";
+	}
+	out << "\n]}\n";
+	Log(LOG_INFO) << "Profiler trace saved to " << filename << " (" << trace.size() << " events)";
+	trace.clear();
+}
+
+/**
+ * Checks if measured calls are being recorded.
+ * @return True while a trace is running.
+ */
+bool Profiler::isTracing()
+{
+	return tracing;
+}
+
+/**
+ * Gets the number of heap allocations made so far by
+ * every thread, so other threads can leak into a scope.
+ * @return Number of allocations.
+ */
+size_t Profiler::getAllocations()
+{
+	return allocations.load(std::memory_order_relaxed);
+}
+
+/**
+ * Gets a high resolution timestamp for measurements.
+ * @return Time in seconds since an arbitrary point.
+ */
+double Profiler::now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+
+namespace OpenXcom
+{
+
+/**
+ * Timings of a named scope, averaged over the
+ * frames since the profiler last rolled over.
+ */
+struct ProfilerEntry
+{
+	const char *name;
+	double time, peak;
+	double calls, allocations;
+};
+
+/**
+ * Collects wall-clock timings of named scopes for the
+ * profiling overlay and records them as a Chrome trace
+ * on request. Only meant for the main thread.
+ * Only compiled in when OXC_PROFILER is defined,
+ * use PROFILE_SCOPE to place probes in the code.
+ */
+class Profiler
+{
+public:
+	/**
+	 * Measures the time spent in its scope and
+	 * records it under a profiler entry.
+	 */
+	class Probe
+	{
+	private:
+		size_t _entry;
+		double _start;
+		size_t _allocations;
+	public:
+		/// Starts measuring a scope.
+		Probe(size_t entry);
+		/// Stops measuring and records the time.
+		~Probe();
+	};
+	/// Gets the entry for a scope name, adding it if needed.
+	static size_t getEntry(const char *name);
+	/// Counts a rendered frame.
+	static void addFrame();
+	/// Averages the timings collected since the last call.
+	static void rollOver();
+	/// Gets the averaged timings, slowest first.
+	static const std::vector<ProfilerEntry> &getEntries();
+	/// Starts recording a trace.
+	static void startTrace();
+	/// Stops recording and saves the trace.
+	static void stopTrace(const std::string &filename);
+	/// Checks if a trace is being recorded.
+	static bool isTracing();
+	/// Gets the number of heap allocations so far.
+	static size_t getAllocations();
+	/// Gets the current time in seconds.
+	static double now();
+};
+
+}
+
+#ifdef OXC_PROFILER
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+/// Measures the rest of the enclosing scope under a name.
+#define PROFILE_SCOPE(name) \
+	static const size_t PROFILE_CONCAT(profileEntry, __LINE__) = OpenXcom::Profiler::getEntry(name); \
+	OpenXcom::Profiler::Probe PROFILE_CONCAT(profileProbe, __LINE__)(PROFILE_CONCAT(profileEntry, __LINE__))
+#else
+#define PROFILE_SCOPE(name)
+#endif
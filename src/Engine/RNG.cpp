@@ -62,11 +62,13 @@ uint64_t getSeed()
 
 /**
  * Changes the current seed in use by the generator.
+ * A zero state would only ever generate zeroes, so a
+ * zero seed is replaced by a fixed nonzero one.
  * @param n New seed.
  */
 void setSeed(uint64_t n)
 {
-	x = n;
+	x = (n != 0) ? n : 0x9E3779B97F4A7C15ULL;
 }
 
 /**
@@ -31,6 +31,7 @@
 #include "Options.h"
 #include "CrossPlatform.h"
 #include "FileMap.h"
+#include "Profiler.h"
 #include "Zoom.h"
 #include "Timer.h"
 #include <SDL.h>
@@ -189,6 +190,7 @@ void Screen::flip()
 {
 	if (getWidth() != _baseWidth || getHeight() != _baseHeight || useOpenGL())
 	{
+		PROFILE_SCOPE("Screen::scale");
 		Zoom::flipWithZoom(_surface->getSurface(), _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput);
 	}
 	else
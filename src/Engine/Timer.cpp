@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Timer.h"
+#include <set>
 #include "Game.h"
 #include "Options.h"
 
@@ -37,6 +38,13 @@ Uint32 slowTick()
 	return false_time >> accurate;
 }
 
+/// Timers that are currently running, so the game loop can tell when the next one is due.
+std::set<Timer*> &runningTimers()
+{
+	static std::set<Timer*> timers;
+	return timers;
+}
+
 }//namespace
 
 Uint32 Timer::gameSlowSpeed = 1;
@@ -58,6 +66,7 @@ Timer::Timer(Uint32 interval, bool frameSkipping) : _start(0), _interval(interva
  */
 Timer::~Timer()
 {
+	runningTimers().erase(this);
 }
 
 /**
@@ -67,6 +76,7 @@ void Timer::start()
 {
 	_frameSkipStart = _start = slowTick();
 	_running = true;
+	runningTimers().insert(this);
 }
 
 /**
@@ -76,6 +86,7 @@ void Timer::stop()
 {
 	_start = 0;
 	_running = false;
+	runningTimers().erase(this);
 }
 
 /**
@@ -137,6 +148,34 @@ void Timer::think(State* state, Surface* surface)
 	}
 }
 
+/**
+ * Returns how long the game loop can sleep before
+ * any running timer needs to fire again. Timers that
+ * are already overdue belong to states that aren't
+ * thinking right now, so they can't wake the loop.
+ * @param limit Longest time worth waiting, in milliseconds.
+ * @return Time in milliseconds, at most the limit.
+ */
+Uint32 Timer::getTimeUntilNextTimer(Uint32 limit)
+{
+	Sint64 now = slowTick();
+	Uint32 next = limit;
+	for (std::set<Timer*>::const_iterator i = runningTimers().begin(); i != runningTimers().end(); ++i)
+	{
+		Sint64 due = (*i)->_frameSkipStart + (*i)->_interval - now;
+		if (due > 0)
+		{
+			// slowed down game time passes slower than real time
+			Sint64 real = due * gameSlowSpeed;
+			if (real < next)
+			{
+				next = (Uint32)real;
+			}
+		}
+	}
+	return next;
+}
+
 /**
  * Changes the timer's interval to a new value.
  * @param interval Interval in milliseconds.
@@ -67,6 +67,8 @@ public:
 	void onTimer(StateHandler handler);
 	/// Hooks a surface action handler to the timer interval.
 	void onTimer(SurfaceHandler handler);
+	/// Gets the time until the next running timer is due.
+	static Uint32 getTimeUntilNextTimer(Uint32 limit);
 };
 
 }
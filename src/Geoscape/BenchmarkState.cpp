@@ -0,0 +1,164 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BenchmarkState.h"
+#include <iomanip>
+#include <sstream>
+#include <yaml-cpp/yaml.h>
+#include "GeoscapeState.h"
+#include "../Engine/Game.h"
+#include "../Engine/Exception.h"
+#include "../Engine/Logger.h"
+#include "../Engine/ObjectPool.h"
+#include "../Engine/RNG.h"
+#include "../Savegame/SavedGame.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Initializes the campaign benchmark.
+ * @param filename Name of the save file to simulate.
+ * @param months Number of months to simulate.
+ * @param seed Random seed to use for the simulation.
+ */
+BenchmarkState::BenchmarkState(const std::string &filename, int months, Uint64 seed) : _filename(filename), _months(months), _monthsLeft(months), _days(0), _seed(seed), _geoscape(0), _elapsed(0.0)
+{
+}
+
+/**
+ *
+ */
+BenchmarkState::~BenchmarkState()
+{
+	delete _geoscape;
+}
+
+/**
+ * Loads the saved game to simulate and creates a
+ * headless geoscape to run it.
+ * @return True if the campaign can be simulated.
+ */
+bool BenchmarkState::start()
+{
+	Log(LOG_INFO) << "Benchmarking " << _filename << " for " << _months << " month(s) with seed " << _seed;
+	SavedGame *save = new SavedGame();
+	try
+	{
+		save->load(_filename, _game->getMod());
+	}
+	catch (Exception &e)
+	{
+		Log(LOG_ERROR) << e.what();
+		delete save;
+		return false;
+	}
+	catch (YAML::Exception &e)
+	{
+		Log(LOG_ERROR) << e.what();
+		delete save;
+		return false;
+	}
+	_game->setSavedGame(save);
+	if (save->getEnding() != END_NONE || save->getSavedBattle() != 0 || save->getMonthsPassed() < 0)
+	{
+		Log(LOG_ERROR) << _filename << " must be saved on the geoscape of a campaign in progress.";
+		return false;
+	}
+	RNG::setSeed(_seed);
+	_geoscape = new GeoscapeState;
+	_geoscape->setHeadless(&_profile);
+	return true;
+}
+
+/**
+ * Simulates campaign days in batches of a tenth of a second,
+ * so the game loop's logic rate doesn't throttle the benchmark,
+ * until the requested months are over or the campaign ends.
+ */
+void BenchmarkState::think()
+{
+	State::think();
+	if (_geoscape == 0)
+	{
+		if (!start())
+		{
+			_game->quit();
+		}
+		return;
+	}
+
+	SavedGame *save = _game->getSavedGame();
+	double batchEnd = GeoscapeProfile::now() + 0.1;
+	while (_monthsLeft > 0 && GeoscapeProfile::now() < batchEnd)
+	{
+		int month = save->getMonthsPassed();
+		double time = GeoscapeProfile::now();
+		_geoscape->timeAdvance(12 * 5 * 6 * 2 * 24);
+		_elapsed += GeoscapeProfile::now() - time;
+		_days++;
+
+		if (save->getMonthsPassed() != month)
+		{
+			_monthsLeft--;
+			Log(LOG_INFO) << "Month " << save->getMonthsPassed() << " done, funds " << save->getFunds() << ", " << save->getUfos()->size() << " UFOs, " << save->getAlienMissions().size() << " alien missions";
+		}
+		if (save->getEnding() != END_NONE || save->getBases()->empty())
+		{
+			Log(LOG_INFO) << "Campaign ended after " << _days << " day(s)";
+			_monthsLeft = 0;
+		}
+	}
+	if (_monthsLeft <= 0)
+	{
+		report();
+		_game->quit();
+	}
+}
+
+/**
+ * Logs the throughput of the simulation
+ * and the time spent in each subsystem.
+ */
+void BenchmarkState::report() const
+{
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	ss << "Simulated " << _days << " day(s) in " << _elapsed << "s";
+	if (_elapsed > 0.0)
+	{
+		ss << " (" << _days / _elapsed << " days/s)";
+	}
+	Log(LOG_INFO) << ss.str();
+	for (int i = 0; i < GEO_SUBSYSTEMS; ++i)
+	{
+		GeoscapeSubsystem subsystem = (GeoscapeSubsystem)i;
+		std::ostringstream ss2;
+		ss2 << std::fixed << std::setprecision(2);
+		ss2 << "- " << GeoscapeProfile::getName(subsystem) << ": " << _profile.getElapsed(subsystem) * 1000.0 << "ms";
+		if (_elapsed > 0.0)
+		{
+			ss2 << " (" << _profile.getElapsed(subsystem) / _elapsed * 100.0 << "%)";
+		}
+		Log(LOG_INFO) << ss2.str();
+	}
+	Log(LOG_INFO) << "Dismissed " << _profile.getPopups() << " popup(s)";
+	ObjectPool::logStatistics(LOG_INFO);
+}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "../Engine/State.h"
+#include "GeoscapeProfile.h"
+#include <SDL.h>
+#include <string>
+
+namespace OpenXcom
+{
+
+class GeoscapeState;
+
+/**
+ * Headless campaign runner. Loads a saved game and
+ * simulates a number of months of geoscape time with
+ * a fixed random seed, then reports how fast it went.
+ * Used to benchmark and soak-test mods without anyone
+ * sitting in front of the screen.
+ */
+class BenchmarkState : public State
+{
+private:
+	std::string _filename;
+	int _months, _monthsLeft, _days;
+	Uint64 _seed;
+	GeoscapeState *_geoscape;
+	GeoscapeProfile _profile;
+	double _elapsed;
+
+	/// Loads the saved game and sets up the geoscape.
+	bool start();
+	/// Logs the benchmark results.
+	void report() const;
+public:
+	/// Creates the Benchmark state.
+	BenchmarkState(const std::string &filename, int months, Uint64 seed);
+	/// Cleans up the Benchmark state.
+	~BenchmarkState();
+	/// Simulates the next batch of days.
+	void think();
+};
+
+}
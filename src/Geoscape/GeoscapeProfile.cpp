@@ -0,0 +1,158 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GeoscapeProfile.h"
+#include <chrono>
+
+namespace OpenXcom
+{
+
+/**
+ * Starts the clock for a subsystem.
+ * @param profile Profile to record into, or 0 to do nothing.
+ * @param subsystem Subsystem being measured.
+ */
+GeoscapeProfile::Probe::Probe(GeoscapeProfile *profile, GeoscapeSubsystem subsystem) : _profile(profile), _subsystem(subsystem), _start(0.0)
+{
+	if (_profile != 0)
+	{
+		_start = now();
+	}
+}
+
+/**
+ * Records the time elapsed since the probe was created.
+ */
+GeoscapeProfile::Probe::~Probe()
+{
+	if (_profile != 0)
+	{
+		_profile->addElapsed(_subsystem, now() - _start);
+	}
+}
+
+/**
+ * Records the time spent so far in the current subsystem
+ * and starts measuring the next one.
+ * @param subsystem Subsystem being measured from now on.
+ */
+void GeoscapeProfile::Probe::switchTo(GeoscapeSubsystem subsystem)
+{
+	if (_profile != 0)
+	{
+		double time = now();
+		_profile->addElapsed(_subsystem, time - _start);
+		_start = time;
+	}
+	_subsystem = subsystem;
+}
+
+/**
+ * Initializes all the subsystem timings to zero.
+ */
+GeoscapeProfile::GeoscapeProfile() : _popups(0)
+{
+	for (int i = 0; i < GEO_SUBSYSTEMS; ++i)
+	{
+		_elapsed[i] = 0.0;
+	}
+}
+
+/**
+ *
+ */
+GeoscapeProfile::~GeoscapeProfile()
+{
+}
+
+/**
+ * Adds some time spent in a subsystem.
+ * @param subsystem Subsystem measured.
+ * @param seconds Time spent, in seconds.
+ */
+void GeoscapeProfile::addElapsed(GeoscapeSubsystem subsystem, double seconds)
+{
+	_elapsed[subsystem] += seconds;
+}
+
+/**
+ * Returns the total time spent in a subsystem.
+ * @param subsystem Subsystem measured.
+ * @return Time spent, in seconds.
+ */
+double GeoscapeProfile::getElapsed(GeoscapeSubsystem subsystem) const
+{
+	return _elapsed[subsystem];
+}
+
+/**
+ * Counts a popup that was thrown away since
+ * there is nobody to answer it.
+ */
+void GeoscapeProfile::addPopup()
+{
+	_popups++;
+}
+
+/**
+ * Returns the number of popups dismissed automatically.
+ * @return Number of popups.
+ */
+int GeoscapeProfile::getPopups() const
+{
+	return _popups;
+}
+
+/**
+ * Returns the name of a subsystem for the benchmark report.
+ * @param subsystem Subsystem measured.
+ * @return Display name.
+ */
+std::string GeoscapeProfile::getName(GeoscapeSubsystem subsystem)
+{
+	switch (subsystem)
+	{
+	case GEO_MISSIONS:
+		return "missions";
+	case GEO_UFOS:
+		return "UFOs";
+	case GEO_CRAFTS:
+		return "crafts";
+	case GEO_RESEARCH:
+		return "research";
+	case GEO_PRODUCTION:
+		return "production";
+	case GEO_FUNDING:
+		return "funding";
+	default:
+		return "";
+	}
+}
+
+/**
+ * Returns a monotonic timestamp with sub-millisecond
+ * precision, since SDL ticks are too coarse for
+ * the short geoscape steps.
+ * @return Time in seconds.
+ */
+double GeoscapeProfile::now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
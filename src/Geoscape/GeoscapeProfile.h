@@ -0,0 +1,75 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+
+namespace OpenXcom
+{
+
+/// Geoscape subsystems measured by the campaign benchmark.
+enum GeoscapeSubsystem { GEO_MISSIONS, GEO_UFOS, GEO_CRAFTS, GEO_RESEARCH, GEO_PRODUCTION, GEO_FUNDING, GEO_SUBSYSTEMS };
+
+/**
+ * Accumulates the wall-clock time spent in each
+ * geoscape subsystem while the game runs headless.
+ */
+class GeoscapeProfile
+{
+private:
+	double _elapsed[GEO_SUBSYSTEMS];
+	int _popups;
+public:
+	/**
+	 * Measures the time spent in its scope and adds it
+	 * to a profile. Does nothing without a profile, so
+	 * it can stay in the regular geoscape code paths.
+	 */
+	class Probe
+	{
+	private:
+		GeoscapeProfile *_profile;
+		GeoscapeSubsystem _subsystem;
+		double _start;
+	public:
+		/// Starts measuring a subsystem.
+		Probe(GeoscapeProfile *profile, GeoscapeSubsystem subsystem);
+		/// Stops measuring and records the time.
+		~Probe();
+		/// Records the time so far and measures another subsystem.
+		void switchTo(GeoscapeSubsystem subsystem);
+	};
+	/// Creates an empty profile.
+	GeoscapeProfile();
+	/// Cleans up the profile.
+	~GeoscapeProfile();
+	/// Adds time spent in a subsystem.
+	void addElapsed(GeoscapeSubsystem subsystem, double seconds);
+	/// Gets the total time spent in a subsystem.
+	double getElapsed(GeoscapeSubsystem subsystem) const;
+	/// Counts a popup that was dismissed automatically.
+	void addPopup();
+	/// Gets the number of popups dismissed automatically.
+	int getPopups() const;
+	/// Gets the display name of a subsystem.
+	static std::string getName(GeoscapeSubsystem subsystem);
+	/// Gets the current time in seconds.
+	static double now();
+};
+
+}
@@ -105,6 +105,7 @@
 #include "../Mod/AlienDeployment.h"
 #include "../Mod/RuleInterface.h"
 #include "../fmath.h"
+#include "GeoscapeProfile.h"
 
 namespace OpenXcom
 {
@@ -113,7 +114,7 @@ namespace OpenXcom
  * Initializes all the elements in the Geoscape screen.
  * @param game Pointer to the core game.
  */
-GeoscapeState::GeoscapeState() : _pause(false), _zoomInEffectDone(false), _zoomOutEffectDone(false), _minimizedDogfights(0)
+GeoscapeState::GeoscapeState() : _pause(false), _zoomInEffectDone(false), _zoomOutEffectDone(false), _minimizedDogfights(0), _profile(0)
 {
 	int screenWidth = Options::baseXGeoscape;
 	int screenHeight = Options::baseYGeoscape;
@@ -656,8 +657,23 @@ void GeoscapeState::timeAdvance()
 		timeSpan = 12 * 5 * 6 * 2 * 24;
 	}
 
+	timeAdvance(timeSpan);
 
-	for (int i = 0; i < timeSpan && !_pause; ++i)
+	_pause = !_dogfightsToBeStarted.empty() || _zoomInEffectTimer->isRunning() || _zoomOutEffectTimer->isRunning();
+
+	timeDisplay();
+	_globe->draw();
+}
+
+/**
+ * Advances the game time in "5 secs" cycles and calls
+ * the respective triggers, until the given number of
+ * cycles have passed or an event pauses the game.
+ * @param steps Number of 5 second cycles.
+ */
+void GeoscapeState::timeAdvance(int steps)
+{
+	for (int i = 0; i < steps && !_pause; ++i)
 	{
 		TimeTrigger trigger;
 		trigger = _game->getSavedGame()->getTime()->advance();
@@ -677,11 +693,19 @@ void GeoscapeState::timeAdvance()
 			time5Seconds();
 		}
 	}
+}
 
-	_pause = !_dogfightsToBeStarted.empty() || _zoomInEffectTimer->isRunning() || _zoomOutEffectTimer->isRunning();
-
-	timeDisplay();
-	_globe->draw();
+/**
+ * Puts the geoscape in headless mode, for the campaign
+ * benchmark. Popups are dismissed as soon as they come up,
+ * decisions get an automatic answer (crafts never land or
+ * engage and return to base instead) and the time spent in
+ * each subsystem is recorded.
+ * @param profile Profile to record the subsystem timings into.
+ */
+void GeoscapeState::setHeadless(GeoscapeProfile *profile)
+{
+	_profile = profile;
 }
 
 /**
@@ -697,15 +721,19 @@ void GeoscapeState::time5Seconds()
 	}
 	if (_game->getSavedGame()->getEnding() == END_LOSE)
 	{
-		_game->pushState(new CutsceneState(CutsceneState::LOSE_GAME));
-		if (_game->getSavedGame()->isIronman())
+		if (_profile == 0)
 		{
-			_game->pushState(new SaveGameState(OPT_GEOSCAPE, SAVE_IRONMAN, _palette));
+			_game->pushState(new CutsceneState(CutsceneState::LOSE_GAME));
+			if (_game->getSavedGame()->isIronman())
+			{
+				_game->pushState(new SaveGameState(OPT_GEOSCAPE, SAVE_IRONMAN, _palette));
+			}
 		}
 		return;
 	}
 
 	// Handle UFO logic
+	GeoscapeProfile::Probe probe(_profile, GEO_UFOS);
 	for (std::vector<Ufo*>::iterator i = _game->getSavedGame()->getUfos()->begin(); i != _game->getSavedGame()->getUfos()->end(); ++i)
 	{
 		switch ((*i)->getStatus())
@@ -738,7 +766,7 @@ void GeoscapeState::time5Seconds()
 					(*i)->setDestination(0);
 					base->setupDefenses();
 					timerReset();
-					if (!base->getDefenses()->empty())
+					if (!base->getDefenses()->empty() && _profile == 0)
 					{
 						popup(new BaseDefenseState(base, *i, this));
 					}
@@ -778,6 +806,7 @@ void GeoscapeState::time5Seconds()
 	}
 
 	// Handle craft logic
+	probe.switchTo(GEO_CRAFTS);
 	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
 	{
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end();)
@@ -817,6 +846,7 @@ void GeoscapeState::time5Seconds()
 				}
 				Craft *craft = *j;
 				j = (*i)->removeCraft(craft, false);
+				_terrainPrefetch.erase(craft->getUniqueId());
 				delete craft;
 				continue;
 			}
@@ -831,6 +861,10 @@ void GeoscapeState::time5Seconds()
 						{
 							(*j)->returnToBase();
 						}
+						else if (_profile != 0)
+						{
+							(*j)->returnToBase();
+						}
 						else
 						{
 							Waypoint *w = new Waypoint();
@@ -859,6 +893,11 @@ void GeoscapeState::time5Seconds()
 				}
 			}
 
+			if (_profile == 0)
+			{
+				prefetchTerrain(*j);
+			}
+
 			(*j)->think();
 
 			if ((*j)->reachedDestination())
@@ -879,7 +918,11 @@ void GeoscapeState::time5Seconds()
 							continue;
 						}
 						// Can we actually fight it
-						if (!(*j)->isInDogfight() && u->getSpeed() <= (*j)->getRules()->getMaxSpeed())
+						if (_profile != 0)
+						{
+							(*j)->returnToBase();
+						}
+						else if (!(*j)->isInDogfight() && u->getSpeed() <= (*j)->getRules()->getMaxSpeed())
 						{
 							DogfightState *dogfight = new DogfightState(this, (*j), u);
 							_dogfightsToBeStarted.push_back(dogfight);
@@ -909,7 +952,11 @@ void GeoscapeState::time5Seconds()
 					case Ufo::LANDED:
 					case Ufo::CRASHED:
 					case Ufo::DESTROYED: // Just before expiration
-						if ((*j)->getNumSoldiers() > 0 || (*j)->getNumVehicles() > 0)
+						if (_profile != 0)
+						{
+							(*j)->returnToBase();
+						}
+						else if ((*j)->getNumSoldiers() > 0 || (*j)->getNumVehicles() > 0)
 						{
 							if (!(*j)->isInDogfight())
 							{
@@ -934,7 +981,7 @@ void GeoscapeState::time5Seconds()
 				}
 				else if (m != 0)
 				{
-					if ((*j)->getNumSoldiers() > 0 || (*j)->getNumVehicles() > 0)
+					if (_profile == 0 && ((*j)->getNumSoldiers() > 0 || (*j)->getNumVehicles() > 0))
 					{
 						// look up polygons texture
 						int texture, shade;
@@ -955,7 +1002,7 @@ void GeoscapeState::time5Seconds()
 				{
 					if (b->isDiscovered())
 					{
-						if ((*j)->getNumSoldiers() > 0 || (*j)->getNumVehicles() > 0)
+						if (_profile == 0 && ((*j)->getNumSoldiers() > 0 || (*j)->getNumVehicles() > 0))
 						{
 							int texture, shade;
 							_globe->getPolygonTextureAndShade(b->getLongitude(), b->getLatitude(), &texture, &shade);
@@ -974,6 +1021,7 @@ void GeoscapeState::time5Seconds()
 	}
 
 	// Clean up dead UFOs and end dogfights which were minimized.
+	probe.switchTo(GEO_UFOS);
 	for (std::vector<Ufo*>::iterator i = _game->getSavedGame()->getUfos()->begin(); i != _game->getSavedGame()->getUfos()->end();)
 	{
 		if ((*i)->getStatus() == Ufo::DESTROYED)
@@ -1031,6 +1079,51 @@ void GeoscapeState::time5Seconds()
 	}
 }
 
+/**
+ * Starts loading the terrain of the site a craft is
+ * headed for in the background, so the battle is ready
+ * to go when it lands. Each destination is only
+ * prefetched once per craft. Crafts and targets are
+ * remembered by ID, since their objects may be deleted
+ * without this state ever knowing.
+ * @param craft Pointer to the craft.
+ */
+void GeoscapeState::prefetchTerrain(Craft *craft)
+{
+	Target *target = craft->getDestination();
+	Ufo *u = dynamic_cast<Ufo*>(target);
+	MissionSite *m = dynamic_cast<MissionSite*>(target);
+	AlienBase *b = dynamic_cast<AlienBase*>(target);
+	bool landing = (u != 0 && u->getDetected() && (u->getStatus() == Ufo::LANDED || u->getStatus() == Ufo::CRASHED)) ||
+		m != 0 || (b != 0 && b->isDiscovered());
+	if (!landing || (craft->getNumSoldiers() == 0 && craft->getNumVehicles() == 0))
+	{
+		_terrainPrefetch.erase(craft->getUniqueId());
+		return;
+	}
+	std::pair<std::string, int> targetId = std::make_pair(target->getType(), target->getId());
+	std::pair<std::string, int> &prefetched = _terrainPrefetch[craft->getUniqueId()];
+	if (prefetched == targetId)
+	{
+		return;
+	}
+	prefetched = targetId;
+
+	// same texture lookup as when landing
+	Texture *texture = 0;
+	if (b == 0)
+	{
+		int tex, shade;
+		_globe->getPolygonTextureAndShade(target->getLongitude(), target->getLatitude(), &tex, &shade);
+		if (m != 0 && _game->getMod()->getGlobe()->getTexture(m->getTexture()) != 0)
+		{
+			tex = m->getTexture();
+		}
+		texture = _game->getMod()->getGlobe()->getTexture(tex);
+	}
+	BattlescapeGenerator::prefetchTerrain(_game->getMod(), craft, texture);
+}
+
 /**
  * Functor that attempt to detect an XCOM base.
  */
@@ -1080,6 +1173,7 @@ struct SetRetaliationTarget: public std::unary_function<std::map<const Region *,
  */
 void GeoscapeState::time10Minutes()
 {
+	GeoscapeProfile::Probe probe(_profile, GEO_CRAFTS);
 	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
 	{
 		// Fuel consumption for XCOM craft.
@@ -1112,6 +1206,7 @@ void GeoscapeState::time10Minutes()
 			}
 		}
 	}
+	probe.switchTo(GEO_UFOS);
 	if (Options::aggressiveRetaliation)
 	{
 		// Detect as many bases as possible.
@@ -1231,6 +1326,7 @@ struct expireCrashedUfo: public std::unary_function<Ufo*, void>
 void GeoscapeState::time30Minutes()
 {
 	// Decrease mission countdowns
+	GeoscapeProfile::Probe probe(_profile, GEO_MISSIONS);
 	std::for_each(_game->getSavedGame()->getAlienMissions().begin(),
 			  _game->getSavedGame()->getAlienMissions().end(),
 			  callThink(*_game, *_globe));
@@ -1250,12 +1346,14 @@ void GeoscapeState::time30Minutes()
 	}
 
 	// Handle crashed UFOs expiration
+	probe.switchTo(GEO_UFOS);
 	std::for_each(_game->getSavedGame()->getUfos()->begin(),
 			  _game->getSavedGame()->getUfos()->end(),
 			  expireCrashedUfo());
 
 
 	// Handle craft maintenance and alien base detection
+	probe.switchTo(GEO_CRAFTS);
 	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
 	{
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
@@ -1297,6 +1395,7 @@ void GeoscapeState::time30Minutes()
 	}
 
 	// Handle UFO detection and give aliens points
+	probe.switchTo(GEO_UFOS);
 	for (std::vector<Ufo*>::iterator u = _game->getSavedGame()->getUfos()->begin(); u != _game->getSavedGame()->getUfos()->end(); ++u)
 	{
 		int points = (*u)->getRules()->getMissionScore(); //one point per UFO in-flight per half hour
@@ -1395,6 +1494,7 @@ void GeoscapeState::time30Minutes()
 	}
 
 	// Processes MissionSites
+	probe.switchTo(GEO_MISSIONS);
 	for (std::vector<MissionSite*>::iterator site = _game->getSavedGame()->getMissionSites()->begin(); site != _game->getSavedGame()->getMissionSites()->end();)
 	{
 		if (processMissionSite(*site))
@@ -1415,6 +1515,7 @@ void GeoscapeState::time30Minutes()
 void GeoscapeState::time1Hour()
 {
 	// Handle craft maintenance
+	GeoscapeProfile::Probe probe(_profile, GEO_CRAFTS);
 	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
 	{
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
@@ -1439,6 +1540,7 @@ void GeoscapeState::time1Hour()
 	}
 
 	// Handle transfers
+	probe.switchTo(GEO_PRODUCTION);
 	bool window = false;
 	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
 	{
@@ -1478,6 +1580,7 @@ void GeoscapeState::time1Hour()
 			popup(new SellState((*i)));
 		}
 	}
+	probe.switchTo(GEO_MISSIONS);
 	for (std::vector<MissionSite*>::iterator i = _game->getSavedGame()->getMissionSites()->begin(); i != _game->getSavedGame()->getMissionSites()->end(); ++i)
 	{
 		if (!(*i)->getDetected())
@@ -1540,9 +1643,11 @@ void GenerateSupplyMission::operator()(const AlienBase *base) const
  */
 void GeoscapeState::time1Day()
 {
+	GeoscapeProfile::Probe probe(_profile, GEO_PRODUCTION);
 	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
 	{
 		// Handle facility construction
+		probe.switchTo(GEO_PRODUCTION);
 		for (std::vector<BaseFacility*>::iterator j = (*i)->getFacilities()->begin(); j != (*i)->getFacilities()->end(); ++j)
 		{
 			if ((*j)->getBuildTime() > 0)
@@ -1557,6 +1662,7 @@ void GeoscapeState::time1Day()
 
 		// Handle science project
 		// 1. gather finished research
+		probe.switchTo(GEO_RESEARCH);
 		std::vector<ResearchProject*> finished;
 		for (std::vector<ResearchProject*>::const_iterator iter = (*i)->getResearch().begin(); iter != (*i)->getResearch().end(); ++iter)
 		{
@@ -1712,6 +1818,7 @@ void GeoscapeState::time1Day()
 		}
 	}
 	// handle regional and country points for alien bases
+	probe.switchTo(GEO_MISSIONS);
 	for (std::vector<AlienBase*>::const_iterator b = _game->getSavedGame()->getAlienBases()->begin(); b != _game->getSavedGame()->getAlienBases()->end(); ++b)
 	{
 		for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
@@ -1760,6 +1867,7 @@ void GeoscapeState::time1Month()
 	_game->getSavedGame()->addMonth();
 
 	// Determine alien mission for this month.
+	GeoscapeProfile::Probe probe(_profile, GEO_MISSIONS);
 	determineAlienMissions();
 
 	// Handle Psi-Training and initiate a new retaliation mission, if applicable
@@ -1784,6 +1892,7 @@ void GeoscapeState::time1Month()
 	}
 
 	// Handle funding
+	probe.switchTo(GEO_FUNDING);
 	timerReset();
 	_game->getSavedGame()->monthlyFunding();
 	popup(new MonthlyReportState(psi, _globe));
@@ -1823,6 +1932,19 @@ void GeoscapeState::timerReset()
  */
 void GeoscapeState::popup(State *state)
 {
+	if (_profile != 0)
+	{
+		// Nobody is around to answer it, but the monthly
+		// report still decides if the campaign goes on
+		_profile->addPopup();
+		MonthlyReportState *report = dynamic_cast<MonthlyReportState*>(state);
+		if (report != 0)
+		{
+			report->skip();
+		}
+		delete state;
+		return;
+	}
 	_pause = true;
 	_popups.push_back(state);
 }
@@ -2230,6 +2352,12 @@ void GeoscapeState::handleBaseDefense(Base *base, Ufo *ufo)
 	// Whatever happens in the base defense, the UFO has finished its duty
 	ufo->setStatus(Ufo::DESTROYED);
 
+	// No battles are fought headless, the base holds
+	if (_profile != 0)
+	{
+		return;
+	}
+
 	if (base->getAvailableSoldiers(true) > 0 || !base->getVehicles()->empty())
 	{
 		SavedBattleGame *bgame = new SavedBattleGame();
@@ -19,6 +19,8 @@
  */
 #include "../Engine/State.h"
 #include <list>
+#include <map>
+#include "../Savegame/Craft.h"
 
 namespace OpenXcom
 {
@@ -34,6 +36,9 @@ class Ufo;
 class MissionSite;
 class Base;
 class RuleMissionScript;
+class GeoscapeProfile;
+class Craft;
+class Target;
 
 /**
  * Geoscape screen which shows an overview of
@@ -56,6 +61,8 @@ private:
 	std::list<State*> _popups;
 	std::list<DogfightState*> _dogfights, _dogfightsToBeStarted;
 	size_t _minimizedDogfights;
+	GeoscapeProfile *_profile;
+	std::map<CraftId, std::pair<std::string, int> > _terrainPrefetch;
 public:
 	/// Creates the Geoscape state.
 	GeoscapeState();
@@ -71,6 +78,10 @@ public:
 	void timeDisplay();
 	/// Advances the game timer.
 	void timeAdvance();
+	/// Advances the game time by a number of steps.
+	void timeAdvance(int steps);
+	/// Runs the geoscape without user interaction.
+	void setHeadless(GeoscapeProfile *profile);
 	/// Trigger whenever 5 seconds pass.
 	void time5Seconds();
 	/// Trigger whenever 10 minutes pass.
@@ -155,6 +166,8 @@ private:
 	/// Process each individual mission script command.
 	bool processCommand(RuleMissionScript *command);
 	bool buttonsDisabled();
+	/// Prefetches the terrain of a craft's landing site.
+	void prefetchTerrain(Craft *craft);
 };
 
 }
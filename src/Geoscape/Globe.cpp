@@ -44,6 +44,7 @@
 #include "../Engine/ShaderMove.h"
 #include "../Engine/ShaderRepeat.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "../Savegame/MissionSite.h"
 #include "../Savegame/AlienBase.h"
 #include "../Engine/Language.h"
@@ -867,6 +868,7 @@ void Globe::rotate()
  */
 void Globe::draw()
 {
+	PROFILE_SCOPE("Globe::draw");
 	if (_redraw)
 	{
 		cachePolygons();
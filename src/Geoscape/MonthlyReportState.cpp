@@ -256,22 +256,7 @@ void MonthlyReportState::btnOkClick(Action *)
 	if (!_gameOver)
 	{
 		_game->popState();
-		// Award medals for service time
-		// Iterate through all your bases
-		for (std::vector<Base*>::iterator b = _game->getSavedGame()->getBases()->begin(); b != _game->getSavedGame()->getBases()->end(); ++b)
-		{
-			// Iterate through all your soldiers
-			for (std::vector<Soldier*>::iterator s = (*b)->getSoldiers()->begin(); s != (*b)->getSoldiers()->end(); ++s)
-			{
-				Soldier *soldier = _game->getSavedGame()->getSoldier((*s)->getId());
-				// Award medals to eligible soldiers
-				soldier->getDiary()->addMonthlyService();
-				if (soldier->getDiary()->manageCommendations(_game->getMod(), _game->getSavedGame()->getMissionStatistics()))
-				{
-					_soldiersMedalled.push_back(soldier);
-				}
-			}
-		}
+		awardServiceMedals();
 		if (!_soldiersMedalled.empty())
 		{
 			_game->pushState(new CommendationState(_soldiersMedalled));
@@ -318,6 +303,46 @@ void MonthlyReportState::btnOkClick(Action *)
 	}
 }
 
+/**
+ * Awards medals for service time to every eligible soldier.
+ */
+void MonthlyReportState::awardServiceMedals()
+{
+	// Iterate through all your bases
+	for (std::vector<Base*>::iterator b = _game->getSavedGame()->getBases()->begin(); b != _game->getSavedGame()->getBases()->end(); ++b)
+	{
+		// Iterate through all your soldiers
+		for (std::vector<Soldier*>::iterator s = (*b)->getSoldiers()->begin(); s != (*b)->getSoldiers()->end(); ++s)
+		{
+			Soldier *soldier = _game->getSavedGame()->getSoldier((*s)->getId());
+			// Award medals to eligible soldiers
+			soldier->getDiary()->addMonthlyService();
+			if (soldier->getDiary()->manageCommendations(_game->getMod(), _game->getSavedGame()->getMissionStatistics()))
+			{
+				_soldiersMedalled.push_back(soldier);
+			}
+		}
+	}
+}
+
+/**
+ * Applies what the report would when shown and
+ * dismissed: either the game is lost, or soldiers
+ * get their service medals. The screens that would
+ * follow it are left out.
+ */
+void MonthlyReportState::skip()
+{
+	if (_gameOver)
+	{
+		_game->getSavedGame()->setEnding(END_LOSE);
+	}
+	else
+	{
+		awardServiceMedals();
+	}
+}
+
 /**
  * Update all our activity counters, gather all our scores,
  * get our countries to make sign pacts, adjust their fundings,
@@ -50,6 +50,8 @@ private:
 	std::vector<Soldier*> _soldiersMedalled;
 	/// Builds a country list string.
 	std::string countryList(const std::vector<std::string> &countries, const std::string &singular, const std::string &plural);
+	/// Awards medals for the month of service.
+	void awardServiceMedals();
 public:
 	/// Creates the Monthly Report state.
 	MonthlyReportState(bool psi, Globe *globe);
@@ -59,6 +61,8 @@ public:
 	void init();
 	/// Handler for clicking the OK button.
 	void btnOkClick(Action *action);
+	/// Applies the report without showing it.
+	void skip();
 	/// Calculate monthly scores.
 	void calculateChanges();
 };
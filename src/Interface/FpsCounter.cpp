@@ -19,10 +19,14 @@
 
 #include "FpsCounter.h"
 #include <cmath>
+#include <iomanip>
+#include <sstream>
 #include "../Engine/Action.h"
 #include "../Engine/Timer.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "NumberText.h"
+#include "Text.h"
 
 namespace OpenXcom
 {
@@ -34,7 +38,7 @@ namespace OpenXcom
  * @param x X position in pixels.
  * @param y Y position in pixels.
  */
-FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, height, x, y), _frames(0)
+FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, height, x, y), _profile(0), _frames(0)
 {
 	_visible = Options::fpsCounter;
 
@@ -51,6 +55,7 @@ FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, hei
 FpsCounter::~FpsCounter()
 {
 	delete _text;
+	delete _profile;
 	delete _timer;
 }
 
@@ -64,6 +69,10 @@ void FpsCounter::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
 	_text->setPalette(colors, firstcolor, ncolors);
+	if (_profile != 0)
+	{
+		_profile->setPalette(colors, firstcolor, ncolors);
+	}
 }
 
 /**
@@ -73,6 +82,37 @@ void FpsCounter::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 void FpsCounter::setColor(Uint8 color)
 {
 	_text->setColor(color);
+	if (_profile != 0)
+	{
+		_profile->setColor(color);
+	}
+}
+
+/**
+ * Sets up the profiler overlay with the mod fonts.
+ * Does nothing unless the profiler is compiled in.
+ * @param big Pointer to the big font, or 0 when the mod is unloaded.
+ * @param small Pointer to the small font, or 0 when the mod is unloaded.
+ * @param lang Pointer to the current language.
+ */
+void FpsCounter::initText(Font *big, Font *small, Language *lang)
+{
+	delete _profile;
+	_profile = 0;
+#ifdef OXC_PROFILER
+	if (big != 0 && small != 0)
+	{
+		_profile = new Text(320, 200, getX(), getY() + getHeight() + 1);
+		_profile->initText(big, small, lang);
+		_profile->setSmall();
+		_profile->setHighContrast(true);
+		_profile->setColor(_text->getColor());
+		if (getPalette() != 0)
+		{
+			_profile->setPalette(getPalette());
+		}
+	}
+#endif
 }
 
 /**
@@ -83,6 +123,21 @@ void FpsCounter::handle(Action *action)
 {
 	if (action->getDetails()->type == SDL_KEYDOWN && action->getDetails()->key.keysym.sym == Options::keyFps)
 	{
+#ifdef OXC_PROFILER
+		// ctrl toggles a trace capture instead
+		if ((SDL_GetModState() & KMOD_CTRL) != 0)
+		{
+			if (Profiler::isTracing())
+			{
+				Profiler::stopTrace(Options::getMasterUserFolder() + "trace.json");
+			}
+			else
+			{
+				Profiler::startTrace();
+			}
+			return;
+		}
+#endif
 		_visible = !_visible;
 		Options::fpsCounter = _visible;
 	}
@@ -105,6 +160,24 @@ void FpsCounter::update()
 	_text->setValue(fps);
 	_frames = 0;
 	_redraw = true;
+#ifdef OXC_PROFILER
+	Profiler::rollOver();
+	if (_profile != 0)
+	{
+		std::ostringstream ss;
+		ss << std::fixed << std::setprecision(2);
+		if (Profiler::isTracing())
+		{
+			ss << "TRACING\n";
+		}
+		const std::vector<ProfilerEntry> &entries = Profiler::getEntries();
+		for (std::vector<ProfilerEntry>::const_iterator i = entries.begin(); i != entries.end(); ++i)
+		{
+			ss << i->name << "  " << i->time << "ms  max " << i->peak << "ms  x" << i->calls << "  " << i->allocations << " allocs\n";
+		}
+		_profile->setText(ss.str());
+	}
+#endif
 }
 
 /**
@@ -116,9 +189,26 @@ void FpsCounter::draw()
 	_text->blit(this);
 }
 
+/**
+ * Blits the FPS counter and, when profiling,
+ * the scope timings below it.
+ * @param surface Pointer to surface to blit onto.
+ */
+void FpsCounter::blit(Surface *surface)
+{
+	Surface::blit(surface);
+	if (_visible && _profile != 0)
+	{
+		_profile->blit(surface);
+	}
+}
+
 void FpsCounter::addFrame()
 {
 	_frames++;
+#ifdef OXC_PROFILER
+	Profiler::addFrame();
+#endif
 }
 
 }
@@ -23,17 +23,20 @@ namespace OpenXcom
 {
 
 class NumberText;
+class Text;
 class Timer;
 class Action;
 
 /**
  * Counts the amount of frames each second
  * and displays them in a NumberText surface.
+ * Profiler builds also list the slowest scopes below.
  */
 class FpsCounter : public Surface
 {
 private:
 	NumberText *_text;
+	Text *_profile;
 	Timer *_timer;
 	int _frames;
 public:
@@ -45,6 +48,8 @@ public:
 	void setPalette(SDL_Color *colors, int firstcolor = 0, int ncolors = 256);
 	/// Sets the FpsCounter's color.
 	void setColor(Uint8 color);
+	/// Initializes the profiler overlay fonts.
+	void initText(Font *big, Font *small, Language *lang);
 	/// Handles keyboard events.
 	void handle(Action *action);
 	/// Advances frame counter.
@@ -53,6 +58,8 @@ public:
 	void update();
 	/// Draws the FPS counter.
 	void draw();
+	/// Blits the FPS counter and profiler overlay.
+	void blit(Surface *surface);
 	void addFrame();
 };
 
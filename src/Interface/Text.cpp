@@ -18,6 +18,7 @@
  */
 #include "Text.h"
 #include <cmath>
+#include <map>
 #include "../Engine/Font.h"
 #include "../Engine/Options.h"
 #include "../Engine/Language.h"
@@ -28,6 +29,53 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/**
+ * Everything that affects how a string is measured and wrapped.
+ */
+struct TextLayoutKey
+{
+	std::string text;
+	Font *font, *small;
+	int width;
+	bool wrap, indent;
+	TextWrapping wrapping;
+
+	bool operator<(const TextLayoutKey &other) const
+	{
+		if (text != other.text)
+			return text < other.text;
+		if (font != other.font)
+			return font < other.font;
+		if (small != other.small)
+			return small < other.small;
+		if (width != other.width)
+			return width < other.width;
+		if (wrap != other.wrap)
+			return wrap < other.wrap;
+		if (indent != other.indent)
+			return indent < other.indent;
+		return wrapping < other.wrapping;
+	}
+};
+
+/**
+ * A string already converted, wrapped and measured.
+ */
+struct TextLayout
+{
+	UString text;
+	std::vector<int> lineWidth, lineHeight;
+};
+
+/// Most layouts kept before the cache starts over.
+const size_t LAYOUT_CACHE_SIZE = 4096;
+std::map<TextLayoutKey, TextLayout> layoutCache;
+
+}
+
 /**
  * Sets up a blank text with the specified size and position.
  * @param width Width in pixels.
@@ -304,6 +352,25 @@ void Text::processText()
 		return;
 	}
 
+	// Lists and buttons keep laying out the same strings, so reuse them
+	TextLayoutKey key;
+	key.text = _text;
+	key.font = _font;
+	key.small = _small;
+	key.width = _wrap ? getWidth() : 0;
+	key.wrap = _wrap;
+	key.indent = _wrap && _indent;
+	key.wrapping = _lang->getTextWrapping();
+	std::map<TextLayoutKey, TextLayout>::const_iterator cached = layoutCache.find(key);
+	if (cached != layoutCache.end())
+	{
+		_processedText = cached->second.text;
+		_lineWidth = cached->second.lineWidth;
+		_lineHeight = cached->second.lineHeight;
+		_redraw = true;
+		return;
+	}
+
 	_processedText = Unicode::convUtf8ToUtf32(_text);
 	_lineWidth.clear();
 	_lineHeight.clear();
@@ -408,9 +475,27 @@ void Text::processText()
 		}
 	}
 
+	if (layoutCache.size() >= LAYOUT_CACHE_SIZE)
+	{
+		layoutCache.clear();
+	}
+	TextLayout &layout = layoutCache[key];
+	layout.text = _processedText;
+	layout.lineWidth = _lineWidth;
+	layout.lineHeight = _lineHeight;
+
 	_redraw = true;
 }
 
+/**
+ * Forgets all the cached text layouts. Must be called
+ * whenever the fonts they were measured with go away.
+ */
+void Text::clearLayoutCache()
+{
+	layoutCache.clear();
+}
+
 /**
  * Calculates the starting X position for a line of text.
  * @param line The line number (0 = first, etc).
@@ -497,7 +582,25 @@ void Text::draw()
 		this->drawRect(&r, 0);
 	}
 
-	int x = 0, y = 0, line = 0, height = 0;
+	drawText(this, 0, 0);
+}
+
+/**
+ * Renders the characters of the text straight onto another
+ * surface, clipped to the text's own area. Saves going through
+ * the text's surface when it's just part of a bigger one.
+ * @param surface Pointer to surface to draw onto.
+ * @param x X position of the text in the surface.
+ * @param y Y position of the text in the surface.
+ */
+void Text::drawText(Surface *surface, int x, int y)
+{
+	if (_text.empty() || _font == 0)
+	{
+		return;
+	}
+
+	int line = 0, height = 0, originX = x, originY = y;
 	Font *font = _font;
 	int color = _color;
 	const UString &s = _processedText;
@@ -510,17 +613,21 @@ void Text::draw()
 	switch (_valign)
 	{
 	case ALIGN_TOP:
-		y = 0;
+		y = originY;
 		break;
 	case ALIGN_MIDDLE:
-		y = (int)ceil((getHeight() - height) / 2.0);
+		y = originY + (int)ceil((getHeight() - height) / 2.0);
 		break;
 	case ALIGN_BOTTOM:
-		y = getHeight() - height;
+		y = originY + getHeight() - height;
 		break;
 	}
 
-	x = getLineX(line);
+	x = originX + getLineX(line);
+
+	// Keep the letters within the text's area
+	ShaderMove<Uint8> dest(surface, 0, 0);
+	dest.setDomain(GraphSubset(std::make_pair(originX, originX + getWidth()), std::make_pair(originY, originY + getHeight())));
 
 	// Set up text color
 	int mul = 1;
@@ -550,7 +657,7 @@ void Text::draw()
 		{
 			line++;
 			y += font->getCharSize(*c).h;
-			x = getLineX(line);
+			x = originX + getLineX(line);
 			if (*c == Unicode::TOK_NL_SMALL)
 			{
 				font = _small;
@@ -567,7 +674,7 @@ void Text::draw()
 			Surface* chr = font->getChar(*c);
 			chr->setX(x);
 			chr->setY(y);
-			ShaderDraw<PaletteShift>(ShaderSurface(this, 0, 0), ShaderCrop(chr), ShaderScalar(color), ShaderScalar(mul), ShaderScalar(mid));
+			ShaderDraw<PaletteShift>(dest, ShaderCrop(chr), ShaderScalar(color), ShaderScalar(mul), ShaderScalar(mid));
 			if (dir > 0)
 				x += dir * font->getCharSize(*c).w;
 		}
@@ -101,6 +101,10 @@ public:
 	int getTextHeight(int line = -1) const;
 	/// Draws the text.
 	void draw();
+	/// Draws the text onto another surface.
+	void drawText(Surface *surface, int x, int y);
+	/// Clears the cached text layouts.
+	static void clearLayoutCache();
 };
 
 }
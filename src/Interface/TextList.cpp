@@ -32,6 +32,14 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Rows created past each edge of the view in lists filled from a row source.
+const size_t ROW_SOURCE_OVERSCAN = 4;
+
+}
+
 /**
  * Sets up a blank list with the specified size and position.
  * @param width Width in pixels.
@@ -41,7 +49,7 @@ namespace OpenXcom
  */
 TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _big(0), _small(0), _font(0), _scroll(0), _visibleRows(0), _selRow(0), _color(0), _dot(false), _selectable(false), _condensed(false), _contrast(false), _wrap(false), _flooding(false),
 																								   _bg(0), _selector(0), _margin(0), _scrolling(true), _arrowPos(-1), _scrollPos(4), _arrowType(ARROW_VERTICAL),
-																								   _leftClick(0), _leftPress(0), _leftRelease(0), _rightClick(0), _rightPress(0), _rightRelease(0), _arrowsLeftEdge(0), _arrowsRightEdge(0), _comboBox(0)
+																								   _leftClick(0), _leftPress(0), _leftRelease(0), _rightClick(0), _rightPress(0), _rightRelease(0), _arrowsLeftEdge(0), _arrowsRightEdge(0), _comboBox(0), _rowState(0), _rowSource(0), _firstText(0)
 {
 	_up = new ArrowButton(ARROW_BIG_UP, 13, 14, getX() + getWidth() + _scrollPos, getY());
 	_up->setVisible(false);
@@ -152,7 +160,7 @@ void TextList::unpress(State *state)
  */
 void TextList::setCellColor(size_t row, size_t column, Uint8 color)
 {
-	_texts[row][column]->setColor(color);
+	getRowTexts(row)[column]->setColor(color);
 	_redraw = true;
 }
 
@@ -163,7 +171,8 @@ void TextList::setCellColor(size_t row, size_t column, Uint8 color)
  */
 void TextList::setRowColor(size_t row, Uint8 color)
 {
-	for (std::vector<Text*>::iterator i = _texts[row].begin(); i < _texts[row].end(); ++i)
+	const std::vector<Text*> &texts = getRowTexts(row);
+	for (std::vector<Text*>::const_iterator i = texts.begin(); i < texts.end(); ++i)
 	{
 		(*i)->setColor(color);
 	}
@@ -178,7 +187,14 @@ void TextList::setRowColor(size_t row, Uint8 color)
  */
 std::string TextList::getCellText(size_t row, size_t column) const
 {
-	return _texts[row][column]->getText();
+	// Rows out of view are only in the row source
+	if (_rowSource != 0 && (row < _firstText || row >= _firstText + _texts.size()))
+	{
+		std::vector<std::string> cells;
+		(_rowState->*_rowSource)(row, cells);
+		return column < cells.size() ? cells[column] : "";
+	}
+	return getRowTexts(row)[column]->getText();
 }
 
 /**
@@ -189,7 +205,7 @@ std::string TextList::getCellText(size_t row, size_t column) const
  */
 void TextList::setCellText(size_t row, size_t column, const std::string &text)
 {
-	_texts[row][column]->setText(text);
+	getRowTexts(row)[column]->setText(text);
 	_redraw = true;
 }
 
@@ -200,7 +216,7 @@ void TextList::setCellText(size_t row, size_t column, const std::string &text)
  */
 int TextList::getColumnX(size_t column) const
 {
-	return getX() + _texts[0][column]->getX();
+	return getX() + _texts.front()[column]->getX();
 }
 
 /**
@@ -210,7 +226,7 @@ int TextList::getColumnX(size_t column) const
  */
 int TextList::getRowY(size_t row) const
 {
-	return getY() + _texts[row][0]->getY();
+	return getY() + getRowTexts(row).front()->getY();
 }
 
 /**
@@ -220,7 +236,7 @@ int TextList::getRowY(size_t row) const
  */
 int TextList::getTextHeight(size_t row) const
 {
-	return _texts[row].front()->getTextHeight();
+	return getRowTexts(row).front()->getTextHeight();
 }
 
 /**
@@ -230,7 +246,7 @@ int TextList::getTextHeight(size_t row) const
  */
 int TextList::getNumTextLines(size_t row) const
 {
-	return _texts[row].front()->getNumLines();
+	return getRowTexts(row).front()->getNumLines();
 }
 
 /**
@@ -239,6 +255,10 @@ int TextList::getNumTextLines(size_t row) const
  */
 size_t TextList::getTexts() const
 {
+	if (_rowSource != 0)
+	{
+		return _rows.size();
+	}
 	return _texts.size();
 }
 
@@ -300,24 +320,7 @@ void TextList::addRow(int cols, ...)
 		{
 			width = _columns[i];
 		}
-		Text* txt = new Text(width, _font->getHeight(), _margin + rowX, rowY);
-		txt->setPalette(this->getPalette());
-		txt->initText(_big, _small, _lang);
-		txt->setColor(_color);
-		txt->setSecondaryColor(_color2);
-		if (_align[i])
-		{
-			txt->setAlign(_align[i]);
-		}
-		txt->setHighContrast(_contrast);
-		if (_font == _big)
-		{
-			txt->setBig();
-		}
-		else
-		{
-			txt->setSmall();
-		}
+		Text* txt = createText(i, width, _margin + rowX, rowY);
 		if (cols > 0)
 			txt->setText(va_arg(args, char*));
 		// grab this before we enable word wrapping so we can use it to calculate
@@ -334,22 +337,7 @@ void TextList::addRow(int cols, ...)
 		// Places dots between text
 		if (_dot && i < cols - 1)
 		{
-			std::string buf = txt->getText();
-			unsigned int w = txt->getTextWidth();
-			while (w < _columns[i])
-			{
-				if (_align[i] != ALIGN_RIGHT)
-				{
-				w += _font->getChar('.')->getCrop()->w + _font->getSpacing();
-				buf += '.';
-			}
-				if (_align[i] != ALIGN_LEFT)
-				{
-					w += _font->getChar('.')->getCrop()->w + _font->getSpacing();
-					buf.insert(0, 1, '.');
-				}
-			}
-			txt->setText(buf);
+			addDots(txt, i);
 		}
 
 		temp.push_back(txt);
@@ -413,6 +401,225 @@ void TextList::addRow(int cols, ...)
 	updateArrows();
 }
 
+/**
+ * Fills the list from a callback instead of adding every row up front.
+ * Only the rows in view (plus a few around them) are ever created,
+ * and they're reused for other rows as the list scrolls, so lists
+ * with lots of rows open just as fast as short ones.
+ * Call it again whenever the rows change to refresh them.
+ * @note Rows filled this way are a single line each, and can't have arrow buttons.
+ * @param state State that the callback belongs to.
+ * @param source Callback that fills in the text of each cell of a row.
+ * @param rows Number of rows in the list.
+ */
+void TextList::setRowSource(State *state, RowSource source, size_t rows)
+{
+	size_t scroll = _scroll;
+	clearList();
+	_rowState = state;
+	_rowSource = source;
+	for (size_t i = 0; i < rows; ++i)
+	{
+		_rows.push_back(i);
+	}
+	// Stay where we were if it's still in the list
+	if (rows > _visibleRows)
+	{
+		_scroll = std::min(scroll, rows - _visibleRows);
+	}
+	updateRowSource();
+	updateArrows();
+	_redraw = true;
+}
+
+/**
+ * Creates a Text object for a cell, set up with the
+ * list's current font and colors.
+ * @param column Column number.
+ * @param width Width in pixels.
+ * @param x X position in pixels.
+ * @param y Y position in pixels.
+ * @return New text.
+ */
+Text *TextList::createText(size_t column, int width, int x, int y)
+{
+	Text* txt = new Text(width, _font->getHeight(), x, y);
+	txt->setPalette(this->getPalette());
+	txt->initText(_big, _small, _lang);
+	txt->setColor(_color);
+	txt->setSecondaryColor(_color2);
+	if (_align[column])
+	{
+		txt->setAlign(_align[column]);
+	}
+	txt->setHighContrast(_contrast);
+	if (_font == _big)
+	{
+		txt->setBig();
+	}
+	else
+	{
+		txt->setSmall();
+	}
+	return txt;
+}
+
+/**
+ * Fills the rest of a cell with dots to separate it
+ * from the next column.
+ * @param txt Pointer to the cell's text.
+ * @param column Column number.
+ */
+void TextList::addDots(Text *txt, size_t column)
+{
+	std::string buf = txt->getText();
+	unsigned int w = txt->getTextWidth();
+	while (w < _columns[column])
+	{
+		if (_align[column] != ALIGN_RIGHT)
+		{
+			w += _font->getChar('.')->getCrop()->w + _font->getSpacing();
+			buf += '.';
+		}
+		if (_align[column] != ALIGN_LEFT)
+		{
+			w += _font->getChar('.')->getCrop()->w + _font->getSpacing();
+			buf.insert(0, 1, '.');
+		}
+	}
+	txt->setText(buf);
+}
+
+/**
+ * Returns the Text objects of a row. For lists filled
+ * from a row source, the row has to be in view.
+ * @param row Row number.
+ * @return Texts of each cell.
+ */
+const std::vector<Text*> &TextList::getRowTexts(size_t row) const
+{
+	return _texts[row - _firstText];
+}
+
+/**
+ * Asks the row source for the contents of a row and
+ * puts them in its cells, reusing whatever cells are
+ * there already.
+ * @param row Row number.
+ * @param texts Texts of each cell.
+ */
+void TextList::fillRow(size_t row, std::vector<Text*> &texts)
+{
+	std::vector<std::string> cells;
+	(_rowState->*_rowSource)(row, cells);
+
+	size_t cols = std::max(cells.size(), (size_t)1);
+	while (texts.size() > cols)
+	{
+		delete texts.back();
+		texts.pop_back();
+	}
+
+	int rowX = 0;
+	int rowY = row * (_font->getHeight() + _font->getSpacing());
+	for (size_t i = 0; i < cols; ++i)
+	{
+		int width;
+		if (_flooding)
+		{
+			width = 340;
+		}
+		else
+		{
+			width = _columns[i];
+		}
+		if (i == texts.size())
+		{
+			texts.push_back(createText(i, width, 0, 0));
+		}
+		Text *txt = texts[i];
+		txt->setX(_margin + rowX);
+		txt->setY(rowY);
+		txt->setColor(_color);
+		txt->setSecondaryColor(_color2);
+		txt->setText(i < cells.size() ? cells[i] : "");
+
+		if (_dot && i + 1 < cells.size())
+		{
+			addDots(txt, i);
+		}
+
+		if (_condensed)
+		{
+			rowX += txt->getTextWidth();
+		}
+		else
+		{
+			rowX += _columns[i];
+		}
+	}
+}
+
+/**
+ * Makes sure the rows in view (and a few around them) are
+ * created for lists filled from a row source. Rows that
+ * scrolled out are reused for the ones that scrolled in.
+ */
+void TextList::updateRowSource()
+{
+	if (_rowSource == 0)
+	{
+		return;
+	}
+
+	size_t first = std::min(_scroll, _rows.size());
+	first -= std::min(first, ROW_SOURCE_OVERSCAN);
+	size_t count = std::min(_rows.size() - first, _visibleRows + ROW_SOURCE_OVERSCAN * 2);
+	if (first == _firstText && count == _texts.size())
+	{
+		return;
+	}
+
+	// Keep the rows that are still around, recycle the rest
+	std::vector< std::vector<Text*> > texts(count), spare;
+	for (size_t i = 0; i < _texts.size(); ++i)
+	{
+		size_t row = _firstText + i;
+		if (row >= first && row < first + count)
+		{
+			texts[row - first].swap(_texts[i]);
+		}
+		else
+		{
+			spare.push_back(std::vector<Text*>());
+			spare.back().swap(_texts[i]);
+		}
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (texts[i].empty())
+		{
+			if (!spare.empty())
+			{
+				texts[i].swap(spare.back());
+				spare.pop_back();
+			}
+			fillRow(first + i, texts[i]);
+		}
+	}
+	for (std::vector< std::vector<Text*> >::iterator u = spare.begin(); u < spare.end(); ++u)
+	{
+		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
+		{
+			delete *v;
+		}
+	}
+
+	_texts.swap(texts);
+	_firstText = first;
+	_redraw = true;
+}
+
 /**
  * Changes the columns that the list contains.
  * While rows can be unlimited, columns need to be specified
@@ -813,6 +1020,9 @@ void TextList::onRightArrowRelease(ActionHandler handler)
  */
 void TextList::clearList()
 {
+	_rowSource = 0;
+	_rowState = 0;
+	_firstText = 0;
 	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
 	{
 		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
@@ -909,6 +1119,7 @@ void TextList::updateVisible()
 	{
 		_visibleRows++;
 	}
+	updateRowSource();
 	updateArrows();
 }
 
@@ -944,16 +1155,21 @@ void TextList::draw()
 		{
 			y -= _font->getHeight() + _font->getSpacing();
 		}
-		for (size_t i = _rows[_scroll]; i < _texts.size() && i < _rows[_scroll] + _visibleRows; ++i)
+		for (size_t i = _rows[_scroll]; i < _firstText + _texts.size() && i < _rows[_scroll] + _visibleRows; ++i)
 		{
-			for (std::vector<Text*>::iterator j = _texts[i].begin(); j < _texts[i].end(); ++j)
+			const std::vector<Text*> &texts = getRowTexts(i);
+			// Cells are laid out already, render them straight into the list
+			for (std::vector<Text*>::const_iterator j = texts.begin(); j < texts.end(); ++j)
 			{
 				(*j)->setY(y);
-				(*j)->blit(this);
+				if ((*j)->getVisible())
+				{
+					(*j)->drawText(this, (*j)->getX(), y);
+				}
 			}
-			if (!_texts[i].empty())
+			if (!texts.empty())
 			{
-				y += _texts[i].front()->getHeight() + _font->getSpacing();
+				y += texts.front()->getHeight() + _font->getSpacing();
 			}
 			else
 			{
@@ -976,7 +1192,7 @@ void TextList::blit(Surface *surface)
 	Surface::blit(surface);
 	if (_visible && !_hidden)
 	{
-		if (_arrowPos != -1 && !_rows.empty())
+		if (_arrowPos != -1 && _rowSource == 0 && !_rows.empty())
 		{
 			int y = getY();
 			for (int row = _scroll; row > 0 && _rows[row] == _rows[row - 1]; --row)
@@ -1023,7 +1239,7 @@ void TextList::handle(Action *action, State *state)
 	_up->handle(action, state);
 	_down->handle(action, state);
 	_scrollbar->handle(action, state);
-	if (_arrowPos != -1 && !_rows.empty())
+	if (_arrowPos != -1 && _rowSource == 0 && !_rows.empty())
 	{
 		size_t startArrowIdx = _rows[_scroll];
 		if (0 < _scroll && _rows[_scroll] == _rows[_scroll - 1])
@@ -1155,7 +1371,7 @@ void TextList::mouseOver(Action *action, State *state)
 		_selRow = std::max(0, (int)(_scroll + (int)floor(action->getRelativeYMouse() / (rowHeight * action->getYScale()))));
 		if (_selRow < _rows.size())
 		{
-			Text *selText = _texts[_rows[_selRow]].front();
+			Text *selText = getRowTexts(_rows[_selRow]).front();
 			int y = getY() + selText->getY();
 			int actualHeight = selText->getHeight() + _font->getSpacing(); //current line height
 			if (y < getY() || y + actualHeight > getY() + getHeight())
@@ -1231,6 +1447,7 @@ void TextList::scrollTo(size_t scroll)
 	if (!_scrolling)
 		return;
 	_scroll = Clamp(scroll, (size_t)(0), _rows.size() - _visibleRows);
+	updateRowSource();
 	draw(); // can't just set _redraw here because reasons
 	updateArrows();
 }
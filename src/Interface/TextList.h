@@ -27,6 +27,8 @@ namespace OpenXcom
 
 enum ArrowOrientation { ARROW_VERTICAL, ARROW_HORIZONTAL };
 
+typedef void (State::* RowSource)(size_t, std::vector<std::string>&);
+
 class ArrowButton;
 class ComboBox;
 class ScrollBar;
@@ -59,11 +61,24 @@ private:
 	ActionHandler _leftClick, _leftPress, _leftRelease, _rightClick, _rightPress, _rightRelease;
 	int _arrowsLeftEdge, _arrowsRightEdge;
 	ComboBox *_comboBox;
+	State *_rowState;
+	RowSource _rowSource;
+	size_t _firstText;
 
 	/// Updates the arrow buttons.
 	void updateArrows();
 	/// Updates the visible rows.
 	void updateVisible();
+	/// Creates the text for a cell.
+	Text *createText(size_t column, int width, int x, int y);
+	/// Pads the text of a cell with dots.
+	void addDots(Text *txt, size_t column);
+	/// Gets the texts of a row.
+	const std::vector<Text*> &getRowTexts(size_t row) const;
+	/// Fills a row from the row source.
+	void fillRow(size_t row, std::vector<Text*> &texts);
+	/// Creates the rows in view from the row source.
+	void updateRowSource();
 public:
 	/// Creates a text list with the specified size and position.
 	TextList(int width, int height, int x = 0, int y = 0);
@@ -103,6 +118,8 @@ public:
 	size_t getVisibleRows() const;
 	/// Adds a new row to the text list.
 	void addRow(int cols, ...);
+	/// Fills the text list on demand from a callback.
+	void setRowSource(State *state, RowSource source, size_t rows);
 	/// Sets the columns in the text list.
 	void setColumns(int cols, ...);
 	/// Sets the palette of the text list.
@@ -158,7 +158,8 @@ void SaveGameState::think()
 		// Save the game
 		try
 		{
-			_game->getSavedGame()->save(_filename);
+			// the battle goes on while the autosave gets written
+			_game->getSavedGame()->save(_filename, _type == SAVE_AUTO_BATTLESCAPE);
 			if (_type == SAVE_IRONMAN_END)
 			{
 				Screen::updateScale(Options::geoscapeScale, Options::baseXGeoscape, Options::baseYGeoscape, true);
@@ -28,6 +28,7 @@
 #include "../Engine/Sound.h"
 #include "../Engine/Music.h"
 #include "../Engine/Font.h"
+#include "../Mod/Mod.h"
 #include "../Engine/Timer.h"
 #include "../Engine/CrossPlatform.h"
 #include "../Interface/FpsCounter.h"
@@ -35,6 +36,7 @@
 #include "../Interface/Text.h"
 #include "MainMenuState.h"
 #include "CutsceneState.h"
+#include "../Geoscape/BenchmarkState.h"
 #include <SDL_mixer.h>
 #include <SDL_thread.h>
 
@@ -93,6 +95,7 @@ StartState::StartState() : _anim(0)
 	// Hide UI
 	_game->getCursor()->setVisible(false);
 	_game->getFpsCounter()->setVisible(false);
+	_game->getFpsCounter()->initText(0, 0, 0);
 
 	if (Options::reload)
 	{
@@ -164,10 +167,19 @@ void StartState::think()
 		addLine("");
 		addLine("Press any key to continue.");
 		loading = LOADING_DONE;
+		if (!Options::getBenchmarkSave().empty())
+		{
+			_game->quit();
+		}
 		break;
 	case LOADING_SUCCESSFUL:
 		CrossPlatform::flashWindow();
 		Log(LOG_INFO) << "OpenXcom started successfully!";
+		if (!Options::getBenchmarkSave().empty())
+		{
+			_game->setState(new BenchmarkState(Options::getBenchmarkSave(), Options::getBenchmarkMonths(), Options::getBenchmarkSeed()));
+			break;
+		}
 		_game->setState(new GoToMainMenuState);
 		if (_oldMaster != Options::getActiveMaster() && Options::playIntro)
 		{
@@ -178,6 +190,7 @@ void StartState::think()
 			Options::reload = false;
 		}
 		_game->getCursor()->setVisible(true);
+		_game->getFpsCounter()->initText(_game->getMod()->getFont("FONT_BIG"), _game->getMod()->getFont("FONT_SMALL"), _game->getLanguage());
 		_game->getFpsCounter()->setVisible(Options::fpsCounter);
 		break;
 	default:
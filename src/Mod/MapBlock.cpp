@@ -18,17 +18,40 @@
  */
 #include "MapBlock.h"
 #include <sstream>
+#include <fstream>
+#include <iterator>
 #include <algorithm>
 #include "../Battlescape/Position.h"
 #include "../Engine/Exception.h"
+#include "../Engine/FileMap.h"
 
 namespace OpenXcom
 {
 
+namespace
+{
+
+/**
+ * Reads a whole game file into memory.
+ * @param filename Game path of the file.
+ * @param data Returns the file contents.
+ */
+void loadFile(const std::string &filename, std::vector<char> &data)
+{
+	std::ifstream file(FileMap::getFilePath(filename).c_str(), std::ios::in | std::ios::binary);
+	if (!file)
+	{
+		throw Exception(filename + " not found");
+	}
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+}
+
 /**
  * MapBlock construction.
  */
-MapBlock::MapBlock(const std::string &name): _name(name), _size_x(10), _size_y(10), _size_z(4)
+MapBlock::MapBlock(const std::string &name): _name(name), _size_x(10), _size_y(10), _size_z(4), _mapLoaded(false), _routesLoaded(false)
 {
 	_groups.push_back(0);
 }
@@ -154,4 +177,36 @@ std::map<std::string, std::vector<Position> > *MapBlock::getItems()
 	return &_items;
 }
 
+/**
+ * Gets the contents of the MAP file for this mapblock.
+ * It's only read the first time, after that every map
+ * using this block gets it straight from memory.
+ * @return The MAP file data.
+ */
+const std::vector<char> &MapBlock::getMapData()
+{
+	if (!_mapLoaded)
+	{
+		loadFile("MAPS/" + _name + ".MAP", _mapData);
+		_mapLoaded = true;
+	}
+	return _mapData;
+}
+
+/**
+ * Gets the contents of the RMP file for this mapblock.
+ * It's only read the first time, after that every map
+ * using this block gets it straight from memory.
+ * @return The RMP file data.
+ */
+const std::vector<char> &MapBlock::getRouteData()
+{
+	if (!_routesLoaded)
+	{
+		loadFile("ROUTES/" + _name + ".RMP", _routeData);
+		_routesLoaded = true;
+	}
+	return _routeData;
+}
+
 }
@@ -41,6 +41,8 @@ private:
 	int _size_x, _size_y, _size_z;
 	std::vector<int> _groups, _revealedFloors;
 	std::map<std::string, std::vector<Position> > _items;
+	std::vector<char> _mapData, _routeData;
+	bool _mapLoaded, _routesLoaded;
 public:
 	MapBlock(const std::string &name);
 	~MapBlock();
@@ -62,6 +64,10 @@ public:
 	bool isFloorRevealed(int floor);
 	/// Gets the layout for any items that belong in this map block.
 	std::map<std::string, std::vector<Position> > *getItems();
+	/// Gets the contents of the mapblock's MAP file.
+	const std::vector<char> &getMapData();
+	/// Gets the contents of the mapblock's RMP file.
+	const std::vector<char> &getRouteData();
 
 };
 
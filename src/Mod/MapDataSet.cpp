@@ -31,6 +31,38 @@ namespace OpenXcom
 
 MapData *MapDataSet::_blankTile = 0;
 MapData *MapDataSet::_scorchedTile = 0;
+std::list<MapDataSet*> MapDataSet::_idleSets;
+std::deque<std::pair<MapDataSet*, MCDPatch*> > MapDataSet::_prefetchQueue;
+SDL_Thread *MapDataSet::_prefetchThread = 0;
+SDL_mutex *MapDataSet::_loadMutex = 0;
+SDL_mutex *MapDataSet::_queueMutex = 0;
+SDL_cond *MapDataSet::_prefetchCond = 0;
+bool MapDataSet::_prefetchStop = false;
+
+namespace
+{
+
+/**
+ * Holds a mutex for the lifetime of the lock.
+ * Does nothing without a mutex, which is the case
+ * as long as no background loading is running.
+ */
+class DataLock
+{
+private:
+	SDL_mutex *_mutex;
+public:
+	DataLock(SDL_mutex *mutex) : _mutex(mutex)
+	{
+		if (_mutex) SDL_mutexP(_mutex);
+	}
+	~DataLock()
+	{
+		if (_mutex) SDL_mutexV(_mutex);
+	}
+};
+
+}
 
 /**
  * MapDataSet construction.
@@ -90,11 +122,58 @@ SurfaceSet *MapDataSet::getSurfaceset() const
 	return _surfaceSet;
 }
 
+/**
+ * Loads terrain data for use in a battle. The data
+ * is taken out of the cache, so it stays loaded
+ * until the battle releases it again.
+ * @param patch MCD patch to apply, if any.
+ */
+void MapDataSet::loadData(MCDPatch *patch)
+{
+	DataLock lock(_loadMutex);
+	_idleSets.remove(this);
+	load(patch);
+}
+
+/**
+ * Hands terrain data that a battle is done with
+ * back to the cache, so the next battle on the same
+ * terrain can skip loading it. Only the CACHE_SIZE
+ * most recently used datasets are kept, the rest
+ * are unloaded.
+ */
+void MapDataSet::releaseData()
+{
+	DataLock lock(_loadMutex);
+	if (_loaded)
+	{
+		cache();
+	}
+}
+
+/**
+ * Marks the dataset as the most recently used one
+ * in the cache, and unloads the least recently used
+ * ones over the limit.
+ */
+void MapDataSet::cache()
+{
+	_idleSets.remove(this);
+	_idleSets.push_front(this);
+	while (_idleSets.size() > CACHE_SIZE)
+	{
+		MapDataSet *oldest = _idleSets.back();
+		_idleSets.pop_back();
+		oldest->unload();
+	}
+}
+
 /**
  * Loads terrain data in XCom format (MCD & PCK files).
+ * @param patch MCD patch to apply, if any.
  * @sa http://www.ufopaedia.org/index.php?title=MCD
  */
-void MapDataSet::loadData(MCDPatch *patch)
+void MapDataSet::load(MCDPatch *patch)
 {
 	// prevents loading twice
 	if (_loaded) return;
@@ -255,9 +334,19 @@ void MapDataSet::loadData(MCDPatch *patch)
 }
 
 /**
- * Unloads the terrain data.
+ * Unloads the terrain data, whether it's cached or not.
  */
 void MapDataSet::unloadData()
+{
+	DataLock lock(_loadMutex);
+	_idleSets.remove(this);
+	unload();
+}
+
+/**
+ * Frees the terrain objects and surfaces.
+ */
+void MapDataSet::unload()
 {
 	if (_loaded)
 	{
@@ -267,10 +356,126 @@ void MapDataSet::unloadData()
 		}
 		_objects.clear();
 		delete _surfaceSet;
+		_surfaceSet = 0;
 		_loaded = false;
 	}
 }
 
+/**
+ * Queues terrain data to be loaded in the background
+ * and put in the cache, so it's ready by the time a
+ * battle needs it. The background thread is started
+ * on first use; if it can't be, nothing is prefetched.
+ * @param patch MCD patch to apply, if any.
+ */
+void MapDataSet::prefetchData(MCDPatch *patch)
+{
+	if (_prefetchThread == 0)
+	{
+		_loadMutex = SDL_CreateMutex();
+		_queueMutex = SDL_CreateMutex();
+		_prefetchCond = SDL_CreateCond();
+		_prefetchStop = false;
+		if (_loadMutex == 0 || _queueMutex == 0 || _prefetchCond == 0 ||
+			(_prefetchThread = SDL_CreateThread(prefetchThread, 0)) == 0)
+		{
+			Log(LOG_WARNING) << "Couldn't start terrain prefetching: " << SDL_GetError();
+			stopPrefetch();
+			return;
+		}
+	}
+
+	DataLock lock(_queueMutex);
+	for (std::deque<std::pair<MapDataSet*, MCDPatch*> >::const_iterator i = _prefetchQueue.begin(); i != _prefetchQueue.end(); ++i)
+	{
+		if (i->first == this)
+		{
+			return;
+		}
+	}
+	_prefetchQueue.push_back(std::make_pair(this, patch));
+	SDL_CondSignal(_prefetchCond);
+}
+
+/**
+ * Stops the background thread, dropping anything
+ * still queued. Must be called before the datasets
+ * are deleted.
+ */
+void MapDataSet::stopPrefetch()
+{
+	if (_prefetchThread != 0)
+	{
+		{
+			DataLock lock(_queueMutex);
+			_prefetchStop = true;
+			SDL_CondSignal(_prefetchCond);
+		}
+		SDL_WaitThread(_prefetchThread, 0);
+		_prefetchThread = 0;
+	}
+	_prefetchQueue.clear();
+	if (_prefetchCond != 0)
+	{
+		SDL_DestroyCond(_prefetchCond);
+		_prefetchCond = 0;
+	}
+	if (_queueMutex != 0)
+	{
+		SDL_DestroyMutex(_queueMutex);
+		_queueMutex = 0;
+	}
+	if (_loadMutex != 0)
+	{
+		SDL_DestroyMutex(_loadMutex);
+		_loadMutex = 0;
+	}
+}
+
+/**
+ * Background thread loading the queued datasets
+ * into the cache, one at a time. A dataset that
+ * fails to load is left unloaded, so the battle
+ * reports the error when it loads it itself.
+ * @return Always 0.
+ */
+int MapDataSet::prefetchThread(void *)
+{
+	while (true)
+	{
+		std::pair<MapDataSet*, MCDPatch*> next;
+		{
+			DataLock lock(_queueMutex);
+			while (_prefetchQueue.empty() && !_prefetchStop)
+			{
+				SDL_CondWait(_prefetchCond, _queueMutex);
+			}
+			if (_prefetchStop)
+			{
+				return 0;
+			}
+			next = _prefetchQueue.front();
+			_prefetchQueue.pop_front();
+		}
+
+		DataLock lock(_loadMutex);
+		MapDataSet *set = next.first;
+		if (!set->_loaded)
+		{
+			try
+			{
+				set->load(next.second);
+				set->cache();
+			}
+			catch (std::exception &e)
+			{
+				Log(LOG_WARNING) << "Couldn't prefetch terrain " << set->getName() << ": " << e.what();
+				set->unload();
+			}
+		}
+	}
+}
+
 /**
  * Loads the LOFTEMPS.DAT into the ruleset voxeldata.
  * @param filename Filename of the DAT file.
@@ -19,7 +19,10 @@
  */
 #include <string>
 #include <vector>
+#include <list>
+#include <deque>
 #include <SDL.h>
+#include <SDL_thread.h>
 #include <yaml-cpp/yaml.h>
 #include "../Mod/MCDPatch.h"
 
@@ -33,6 +36,8 @@ class SurfaceSet;
  * Represents a Terrain Map Datafile.
  * Which corresponds to an XCom MCD & PCK file.
  * The list of map datafiles is stored in RuleSet, but referenced in RuleTerrain.
+ * Loaded datafiles stay cached between battles, and the ones
+ * a battle is likely to need can be prefetched in the background.
  * @sa http://www.ufopaedia.org/index.php?title=MCD
  */
 class MapDataSet
@@ -44,7 +49,23 @@ private:
 	bool _loaded;
 	static MapData *_blankTile;
 	static MapData *_scorchedTile;
+	static std::list<MapDataSet*> _idleSets;
+	static std::deque<std::pair<MapDataSet*, MCDPatch*> > _prefetchQueue;
+	static SDL_Thread *_prefetchThread;
+	static SDL_mutex *_loadMutex, *_queueMutex;
+	static SDL_cond *_prefetchCond;
+	static bool _prefetchStop;
+	/// Loads the objects and surfaces, if not loaded yet.
+	void load(MCDPatch *patch);
+	/// Frees the objects and surfaces.
+	void unload();
+	/// Puts the objects in the cache.
+	void cache();
+	/// Loads the queued datasets in the background.
+	static int prefetchThread(void *);
 public:
+	/// Maximum number of datasets kept loaded while no battle uses them.
+	static const size_t CACHE_SIZE = 32;
 	MapDataSet(const std::string &name);
 	~MapDataSet();
 	/// Loads voxeldata from a DAT file.
@@ -59,8 +80,14 @@ public:
 	SurfaceSet *getSurfaceset() const;
 	/// Loads the objects from an MCD file.
 	void loadData(MCDPatch *patch);
+	/// Hands the objects back to the cache.
+	void releaseData();
 	///	Unloads to free memory.
 	void unloadData();
+	/// Queues the objects for loading in the background.
+	void prefetchData(MCDPatch *patch);
+	/// Stops the background loading.
+	static void stopPrefetch();
 	/// Gets a blank floor tile.
 	static MapData *getBlankFloorTile();
 	/// Gets a scorched earth tile.
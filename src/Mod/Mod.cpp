@@ -18,8 +18,10 @@
  */
 #include "Mod.h"
 #include <algorithm>
+#include <fstream>
 #include <sstream>
 #include <climits>
+#include <cstring>
 #include <cassert>
 #include "../Engine/CrossPlatform.h"
 #include "../Engine/FileMap.h"
@@ -33,6 +35,7 @@
 #include "../Engine/Sound.h"
 #include "../Interface/TextButton.h"
 #include "../Interface/Window.h"
+#include "../Interface/Text.h"
 #include "MapDataSet.h"
 #include "RuleMusic.h"
 #include "../Engine/ShaderDraw.h"
@@ -197,7 +200,7 @@ void Mod::resetGlobalStatics()
 /**
  * Creates an empty mod.
  */
-Mod::Mod() : _costEngineer(0), _costScientist(0), _timePersonnel(0), _initialFunding(0), _turnAIUseGrenade(3), _turnAIUseBlaster(3), _defeatScore(0), _defeatFunds(0), _difficultyDemigod(false), _startingTime(6, 1, 1, 1999, 12, 0, 0),
+Mod::Mod() : _adlibCat(0), _aintroCat(0), _gmCat(0), _costEngineer(0), _costScientist(0), _timePersonnel(0), _initialFunding(0), _turnAIUseGrenade(3), _turnAIUseBlaster(3), _defeatScore(0), _defeatFunds(0), _difficultyDemigod(false), _startingTime(6, 1, 1, 1999, 12, 0, 0),
 			 _facilityListOrder(0), _craftListOrder(0), _itemListOrder(0), _researchListOrder(0),  _manufactureListOrder(0), _ufopaediaListOrder(0), _invListOrder(0), _modCurrent(0), _statePalette(0)
 {
 	_muteMusic = new Music();
@@ -218,10 +221,14 @@ Mod::Mod() : _costEngineer(0), _costScientist(0), _timePersonnel(0), _initialFun
  */
 Mod::~Mod()
 {
+	// the terrain prefetching works on the mod data
+	MapDataSet::stopPrefetch();
+
 	delete _muteMusic;
 	delete _muteSound;
 	delete _globe;
 	delete _converter;
+	Text::clearLayoutCache();
 	for (std::map<std::string, Font*>::iterator i = _fonts.begin(); i != _fonts.end(); ++i)
 	{
 		delete i->second;
@@ -242,6 +249,9 @@ Mod::~Mod()
 	{
 		delete i->second;
 	}
+	delete _gmCat;
+	delete _adlibCat;
+	delete _aintroCat;
 	for (std::map<std::string, SoundSet*>::iterator i = _sounds.begin(); i != _sounds.end(); ++i)
 	{
 		delete i->second;
@@ -465,20 +475,67 @@ SurfaceSet *Mod::getSurfaceSet(const std::string &name, bool error)
 }
 
 /**
- * Returns a specific music from the mod.
+ * Returns a specific music from the mod. Musics are only
+ * opened the first time they're requested, and just the
+ * most recently requested ones are kept open.
  * @param name Name of the music.
  * @return Pointer to the music.
  */
-Music *Mod::getMusic(const std::string &name, bool error) const
+Music *Mod::getMusic(const std::string &name, bool error)
 {
 	if (Options::mute)
 	{
 		return _muteMusic;
 	}
-	else
+
+	std::map<std::string, Music*>::iterator loaded = _musics.find(name);
+	if (loaded != _musics.end())
+	{
+		_recentMusics.remove(name);
+		_recentMusics.push_front(name);
+		return loaded->second;
+	}
+
+	Music *music = 0;
+	std::map<std::string, std::vector<MusicFormat> >::iterator i = _musicFormats.find(name);
+	if (i != _musicFormats.end())
+	{
+		// fall back on the next available format if one fails to load
+		const RuleMusic *rule = _musicDefs[name];
+		std::vector<MusicFormat>::iterator fmt = i->second.begin();
+		while (music == 0 && fmt != i->second.end())
+		{
+			music = loadMusic(*fmt, name, rule->getCatPos(), rule->getNormalization(), _adlibCat, _aintroCat, _gmCat);
+			if (music == 0)
+			{
+				fmt = i->second.erase(fmt);
+			}
+		}
+		if (music == 0)
+		{
+			_musicFormats.erase(i);
+		}
+	}
+	if (music == 0)
+	{
+		if (error)
+		{
+			throw Exception("Music " + name + " not found");
+		}
+		return 0;
+	}
+
+	// freeing a music only stops it if it's the one playing,
+	// and musics are requested right before playing them
+	_musics[name] = music;
+	_recentMusics.push_front(name);
+	while (_recentMusics.size() > MUSIC_CACHE_SIZE)
 	{
-		return getRule(name, "Music", _musics, error);
+		delete _musics[_recentMusics.back()];
+		_musics.erase(_recentMusics.back());
+		_recentMusics.pop_back();
 	}
+	return music;
 }
 
 /**
@@ -486,7 +543,7 @@ Music *Mod::getMusic(const std::string &name, bool error) const
  * @param name Name of the music to pick from.
  * @return Pointer to the music.
  */
-Music *Mod::getRandomMusic(const std::string &name) const
+Music *Mod::getRandomMusic(const std::string &name)
 {
 	if (Options::mute)
 	{
@@ -494,12 +551,12 @@ Music *Mod::getRandomMusic(const std::string &name) const
 	}
 	else
 	{
-		std::vector<Music*> music;
-		for (std::map<std::string, Music*>::const_iterator i = _musics.begin(); i != _musics.end(); ++i)
+		std::vector<std::string> music;
+		for (std::map<std::string, std::vector<MusicFormat> >::const_iterator i = _musicFormats.begin(); i != _musicFormats.end(); ++i)
 		{
 			if (i->first.find(name) != std::string::npos)
 			{
-				music.push_back(i->second);
+				music.push_back(i->first);
 			}
 		}
 		if (music.empty())
@@ -508,7 +565,8 @@ Music *Mod::getRandomMusic(const std::string &name) const
 		}
 		else
 		{
-			return music[RNG::seedless(0, music.size() - 1)];
+			Music *pick = getMusic(music[RNG::seedless(0, music.size() - 1)], false);
+			return pick ? pick : _muteMusic;
 		}
 	}
 }
@@ -931,6 +989,7 @@ void Mod::loadAll(const std::vector< std::pair< std::string, std::vector<std::st
 	//back master
 	_modCurrent = &_modData.at(0);
 	sortLists();
+	linkResearch();
 	loadExtraResources();
 	modResources();
 }
@@ -2153,6 +2212,27 @@ RuleManufacture *Mod::getManufacture (const std::string &id, bool error) const
 	return getRule(id, "Manufacture", _manufacture, error);
 }
 
+/**
+ * Returns the rules of all the research projects in list order.
+ * The position of each one is its RuleResearch::getIndex().
+ * @return The list of research rules.
+ */
+const std::vector<RuleResearch*> &Mod::getResearchRules() const
+{
+	return _researchRules;
+}
+
+/**
+ * Returns the manufacture projects that have a certain
+ * research project among their requirements.
+ * @param research The research project.
+ * @return The list of manufacture rules, in list order.
+ */
+const std::vector<RuleManufacture*> &Mod::getManufactureRequiring(const RuleResearch *research) const
+{
+	return _researchManufacture[research->getIndex()];
+}
+
 /**
  * Returns the list of manufacture projects.
  * @return The list of manufacture projects.
@@ -2451,6 +2531,42 @@ void Mod::sortLists()
 	std::sort(_ufopaediaCatIndex.begin(), _ufopaediaCatIndex.end(), compareSection(this));
 }
 
+/**
+ * Compiles the research tree into something quicker to work with:
+ * every research gets an index and direct links to the research it
+ * refers to, and every research knows which manufacture requires it.
+ * The saved game uses this to check prerequisites without any
+ * string lookups.
+ */
+void Mod::linkResearch()
+{
+	_researchRules.clear();
+	for (std::vector<std::string>::const_iterator i = _researchIndex.begin(); i != _researchIndex.end(); ++i)
+	{
+		_researchRules.push_back(getResearch(*i));
+	}
+	for (size_t i = 0; i < _researchRules.size(); ++i)
+	{
+		_researchRules[i]->link(i, this);
+	}
+
+	_researchManufacture.clear();
+	_researchManufacture.resize(_researchRules.size());
+	for (std::vector<std::string>::const_iterator i = _manufactureIndex.begin(); i != _manufactureIndex.end(); ++i)
+	{
+		RuleManufacture *manufacture = getManufacture(*i);
+		const std::vector<std::string> &reqs = manufacture->getRequirements();
+		for (std::vector<std::string>::const_iterator j = reqs.begin(); j != reqs.end(); ++j)
+		{
+			RuleResearch *research = getResearch(*j);
+			if (research != 0 && (_researchManufacture[research->getIndex()].empty() || _researchManufacture[research->getIndex()].back() != manufacture))
+			{
+				_researchManufacture[research->getIndex()].push_back(manufacture);
+			}
+		}
+	}
+}
+
 /**
  * Gets the research-requirements for Psi-Lab (it's a cache for psiStrengthEval)
  */
@@ -3326,45 +3442,44 @@ void Mod::loadExtraResources()
 	{
 		const std::set<std::string> &soundFiles(FileMap::getVFolderContents("SOUND"));
 
-		// Check which music version is available
-		CatFile *adlibcat = 0, *aintrocat = 0;
-		GMCatFile *gmcat = 0;
-
+		// Check which music version is available,
+		// the CATs stay open to load tracks from later
 		for (std::set<std::string>::iterator i = soundFiles.begin(); i != soundFiles.end(); ++i)
 		{
 			if (0 == i->compare("adlib.cat"))
 			{
-				adlibcat = new CatFile(FileMap::getFilePath("SOUND/" + *i).c_str());
+				_adlibCat = new CatFile(FileMap::getFilePath("SOUND/" + *i).c_str());
 			}
 			else if (0 == i->compare("aintro.cat"))
 			{
-				aintrocat = new CatFile(FileMap::getFilePath("SOUND/" + *i).c_str());
+				_aintroCat = new CatFile(FileMap::getFilePath("SOUND/" + *i).c_str());
 			}
 			else if (0 == i->compare("gm.cat"))
 			{
-				gmcat = new GMCatFile(FileMap::getFilePath("SOUND/" + *i).c_str());
+				_gmCat = new GMCatFile(FileMap::getFilePath("SOUND/" + *i).c_str());
 			}
 		}
 
+		// Only catalogue the formats each music is available in,
+		// the music itself is loaded when it's first played.
 		// Try the preferred format first, otherwise use the default priority
 		MusicFormat priority[] = { Options::preferredMusic, MUSIC_FLAC, MUSIC_OGG, MUSIC_MP3, MUSIC_MOD, MUSIC_WAV, MUSIC_ADLIB, MUSIC_GM, MUSIC_MIDI };
 		for (std::map<std::string, RuleMusic *>::const_iterator i = _musicDefs.begin(); i != _musicDefs.end(); ++i)
 		{
-			Music *music = 0;
-			for (size_t j = 0; j < ARRAYLEN(priority) && music == 0; ++j)
+			std::vector<MusicFormat> formats;
+			for (size_t j = 0; j < ARRAYLEN(priority); ++j)
 			{
-				music = loadMusic(priority[j], (*i).first, (*i).second->getCatPos(), (*i).second->getNormalization(), adlibcat, aintrocat, gmcat);
+				if (std::find(formats.begin(), formats.end(), priority[j]) == formats.end() &&
+					isMusicAvailable(priority[j], (*i).first, (*i).second->getCatPos()))
+				{
+					formats.push_back(priority[j]);
+				}
 			}
-			if (music)
+			if (!formats.empty())
 			{
-				_musics[(*i).first] = music;
+				_musicFormats[(*i).first] = formats;
 			}
-
 		}
-
-		delete gmcat;
-		delete adlibcat;
-		delete aintrocat;
 	}
 #endif
 
@@ -3547,6 +3662,78 @@ void Mod::modResources()
 	}
 }
 
+/**
+ * Checks if the specified music file format is available,
+ * going by the CAT indexes and file headers, without
+ * actually loading the music.
+ * @param fmt Format of the music.
+ * @param file Filename of the music.
+ * @param track Track number of the music, if stored in a CAT.
+ * @return True if the music can be loaded in this format.
+ */
+bool Mod::isMusicAvailable(MusicFormat fmt, const std::string &file, int track) const
+{
+	/* MUSIC_AUTO, MUSIC_FLAC, MUSIC_OGG, MUSIC_MP3, MUSIC_MOD, MUSIC_WAV, MUSIC_ADLIB, MUSIC_GM, MUSIC_MIDI */
+	static const std::string exts[] = { "", ".flac", ".ogg", ".mp3", ".mod", ".wav", "", "", ".mid" };
+	if (fmt == MUSIC_ADLIB)
+	{
+		if (!_adlibCat || Options::audioBitDepth != 16)
+			return false;
+		if (track < _adlibCat->getAmount())
+			return true;
+		return _aintroCat && track - _adlibCat->getAmount() < _aintroCat->getAmount();
+	}
+	else if (fmt == MUSIC_GM)
+	{
+		return _gmCat && track < _gmCat->getAmount();
+	}
+
+	std::string fname = file + exts[fmt];
+	std::transform(fname.begin(), fname.end(), fname.begin(), ::tolower);
+	const std::set<std::string> &soundContents = FileMap::getVFolderContents("SOUND");
+	if (soundContents.find(fname) == soundContents.end())
+	{
+		return false;
+	}
+
+	char header[12] = {0};
+	std::ifstream music(FileMap::getFilePath("SOUND/" + fname).c_str(), std::ios::in | std::ios::binary);
+	music.read(header, sizeof(header));
+	if (music.gcount() < 4)
+	{
+		Log(LOG_INFO) << "Music " << fname << " is empty";
+		return false;
+	}
+	bool valid;
+	switch (fmt)
+	{
+	case MUSIC_FLAC:
+		valid = memcmp(header, "fLaC", 4) == 0 || memcmp(header, "ID3", 3) == 0;
+		break;
+	case MUSIC_OGG:
+		valid = memcmp(header, "OggS", 4) == 0;
+		break;
+	case MUSIC_MP3:
+		valid = memcmp(header, "ID3", 3) == 0 || ((Uint8)header[0] == 0xFF && ((Uint8)header[1] & 0xE0) == 0xE0);
+		break;
+	case MUSIC_WAV:
+		valid = memcmp(header, "RIFF", 4) == 0 && memcmp(header + 8, "WAVE", 4) == 0;
+		break;
+	case MUSIC_MIDI:
+		valid = memcmp(header, "MThd", 4) == 0 || memcmp(header, "RIFF", 4) == 0;
+		break;
+	default:
+		// modules come in too many flavors to tell apart
+		valid = true;
+		break;
+	}
+	if (!valid)
+	{
+		Log(LOG_INFO) << "Music " << fname << " has an unrecognized header";
+	}
+	return valid;
+}
+
 /**
  * Loads the specified music file format.
  * @param fmt Format of the music.
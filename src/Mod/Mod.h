@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <map>
+#include <list>
 #include <vector>
 #include <string>
 #include <SDL.h>
@@ -113,6 +114,10 @@ private:
 	std::map<std::string, SurfaceSet*> _sets;
 	std::map<std::string, SoundSet*> _sounds;
 	std::map<std::string, Music*> _musics;
+	std::map<std::string, std::vector<MusicFormat> > _musicFormats;
+	std::list<std::string> _recentMusics;
+	CatFile *_adlibCat, *_aintroCat;
+	GMCatFile *_gmCat;
 	std::vector<Uint16> _voxelData;
 	std::vector<std::vector<Uint8> > _transparencyLUTs;
 
@@ -169,6 +174,8 @@ private:
 	ModData* _modCurrent;
 	SDL_Color *_statePalette;
 	std::vector<std::string> _psiRequirements; // it's a cache for psiStrengthEval
+	std::vector<RuleResearch*> _researchRules;
+	std::vector< std::vector<RuleManufacture*> > _researchManufacture;
 
 	/// Loads a ruleset from a YAML file that have basic resources configuration.
 	void loadResourceConfigFile(const std::string &filename);
@@ -182,11 +189,13 @@ private:
 	template <typename T>
 	T *getRule(const std::string &id, const std::string &name, const std::map<std::string, T*> &map, bool error) const;
 	/// Gets a random music. This is private to prevent access, use playMusic(name, true) instead.
-	Music *getRandomMusic(const std::string &name) const;
+	Music *getRandomMusic(const std::string &name);
 	/// Gets a particular sound set. This is private to prevent access, use getSound(name, id) instead.
 	SoundSet *getSoundSet(const std::string &name, bool error = true) const;
 	/// Loads battlescape specific resources.
 	void loadBattlescapeResources();
+	/// Checks if a music is available in the specified format.
+	bool isMusicAvailable(MusicFormat fmt, const std::string &file, int track) const;
 	/// Loads a specified music file.
 	Music *loadMusic(MusicFormat fmt, const std::string &file, int track, float volume, CatFile *adlibcat, CatFile *aintrocat, GMCatFile *gmcat) const;
 	/// Creates a transparency lookup table for a given palette.
@@ -205,6 +214,8 @@ private:
 	void modResources();
 	/// Sorts all our lists according to their weight.
 	void sortLists();
+	/// Builds the research and manufacture dependency graph.
+	void linkResearch();
 public:
 	static int DOOR_OPEN;
 	static int SLIDING_DOOR_OPEN;
@@ -238,6 +249,7 @@ public:
 	static std::string DEBRIEF_MUSIC_GOOD;
 	static std::string DEBRIEF_MUSIC_BAD;
 	static int DIFFICULTY_COEFFICIENT[5];
+	static const size_t MUSIC_CACHE_SIZE = 4;
 	// reset all the statics in all classes to default values
 	static void resetGlobalStatics();
 	/// Creates a blank mod.
@@ -255,7 +267,7 @@ public:
 	/// Gets a particular surface set.
 	SurfaceSet *getSurfaceSet(const std::string &name, bool error = true);
 	/// Gets a particular music.
-	Music *getMusic(const std::string &name, bool error = true) const;
+	Music *getMusic(const std::string &name, bool error = true);
 	/// Plays a particular music.
 	void playMusic(const std::string &name, int id = 0);
 	/// Gets a particular sound.
@@ -364,6 +376,10 @@ public:
 	RuleResearch *getResearch (const std::string &id, bool error = false) const;
 	/// Gets the list of all research projects.
 	const std::vector<std::string> &getResearchList() const;
+	/// Gets the rulesets of all research projects, by research index.
+	const std::vector<RuleResearch*> &getResearchRules() const;
+	/// Gets the manufacture projects that require a research project.
+	const std::vector<RuleManufacture*> &getManufactureRequiring(const RuleResearch *research) const;
 	/// Gets the ruleset for a specific manufacture project.
 	RuleManufacture *getManufacture (const std::string &id, bool error = false) const;
 	/// Gets the list of all manufacture projects.
@@ -18,6 +18,7 @@
  */
 
 #include "RuleCommendations.h"
+#include <algorithm>
 
 namespace OpenXcom
 {
@@ -25,7 +26,7 @@ namespace OpenXcom
 /**
  * Creates a blank set of commendation data.
  */
-RuleCommendations::RuleCommendations() : _criteria(), _killCriteria(), _description(""), _sprite()
+RuleCommendations::RuleCommendations() : _criteria(), _killCriteria(), _compiledCriteria(), _compiledKillCriteria(), _description(""), _sprite()
 {
 }
 
@@ -46,6 +47,114 @@ void RuleCommendations::load(const YAML::Node &node)
 	_criteria = node["criteria"].as<std::map<std::string, std::vector<int> > >(_criteria);
 	_sprite = node["sprite"].as<int>(_sprite);
 	_killCriteria = node["killCriteria"].as<std::vector<std::vector<std::pair<int, std::vector<std::string> > > > >(_killCriteria);
+	compileCriteria();
+}
+
+/**
+ * Converts the criteria names into evaluator ids, so
+ * the soldier diaries don't have to compare strings
+ * every time they check for new commendations.
+ * Unknown criteria are kept, they only limit the award level.
+ */
+void RuleCommendations::compileCriteria()
+{
+	static const struct { const char *name; CommendationCriterion criterion; } criteriaNames[] =
+	{
+		{ "totalKills", CC_TOTAL_KILLS },
+		{ "totalMissions", CC_TOTAL_MISSIONS },
+		{ "totalWins", CC_TOTAL_WINS },
+		{ "totalScore", CC_TOTAL_SCORE },
+		{ "totalStuns", CC_TOTAL_STUNS },
+		{ "totalDaysWounded", CC_TOTAL_DAYS_WOUNDED },
+		{ "totalBaseDefenseMissions", CC_TOTAL_BASE_DEFENSE_MISSIONS },
+		{ "totalTerrorMissions", CC_TOTAL_TERROR_MISSIONS },
+		{ "totalNightMissions", CC_TOTAL_NIGHT_MISSIONS },
+		{ "totalNightTerrorMissions", CC_TOTAL_NIGHT_TERROR_MISSIONS },
+		{ "totalMonthlyService", CC_TOTAL_MONTHLY_SERVICE },
+		{ "totalFellUnconcious", CC_TOTAL_FELL_UNCONSCIOUS },
+		{ "totalShotAt10Times", CC_TOTAL_SHOT_AT_10_TIMES },
+		{ "totalHit5Times", CC_TOTAL_HIT_5_TIMES },
+		{ "totalFriendlyFired", CC_TOTAL_FRIENDLY_FIRED },
+		{ "total_lone_survivor", CC_TOTAL_LONE_SURVIVOR },
+		{ "totalIronMan", CC_TOTAL_IRON_MAN },
+		{ "totalImportantMissions", CC_TOTAL_IMPORTANT_MISSIONS },
+		{ "totalLongDistanceHits", CC_TOTAL_LONG_DISTANCE_HITS },
+		{ "totalLowAccuracyHits", CC_TOTAL_LOW_ACCURACY_HITS },
+		{ "totalReactionFire", CC_TOTAL_REACTION_FIRE },
+		{ "totalTimesWounded", CC_TOTAL_TIMES_WOUNDED },
+		{ "totalValientCrux", CC_TOTAL_VALIANT_CRUX },
+		{ "isDead", CC_IS_DEAD },
+		{ "totalTrapKills", CC_TOTAL_TRAP_KILLS },
+		{ "totalAlienBaseAssaults", CC_TOTAL_ALIEN_BASE_ASSAULTS },
+		{ "totalAllAliensKilled", CC_TOTAL_ALL_ALIENS_KILLED },
+		{ "totalAllAliensStunned", CC_TOTAL_ALL_ALIENS_STUNNED },
+		{ "totalWoundsHealed", CC_TOTAL_WOUNDS_HEALED },
+		{ "totalAllUFOs", CC_TOTAL_ALL_UFOS },
+		{ "totalAllMissionTypes", CC_TOTAL_ALL_MISSION_TYPES },
+		{ "totalStatGain", CC_TOTAL_STAT_GAIN },
+		{ "totalRevives", CC_TOTAL_REVIVES },
+		{ "totalSoldierRevives", CC_TOTAL_SOLDIER_REVIVES },
+		{ "totalHostileRevives", CC_TOTAL_HOSTILE_REVIVES },
+		{ "totalNeutralRevives", CC_TOTAL_NEUTRAL_REVIVES },
+		{ "totalWholeMedikit", CC_TOTAL_WHOLE_MEDIKIT },
+		{ "totalBraveryGain", CC_TOTAL_BRAVERY_GAIN },
+		{ "bestOfRank", CC_BEST_OF_RANK },
+		{ "bestSoldier", CC_BEST_SOLDIER },
+		{ "isMIA", CC_IS_MIA },
+		{ "totalMartyrKills", CC_TOTAL_MARTYR_KILLS },
+		{ "totalPostMortemKills", CC_TOTAL_POST_MORTEM_KILLS },
+		{ "globeTrotter", CC_GLOBE_TROTTER },
+		{ "totalSlaveKills", CC_TOTAL_SLAVE_KILLS },
+		{ "totalKillsWithAWeapon", CC_TOTAL_KILLS_WITH_A_WEAPON },
+		{ "totalMissionsInARegion", CC_TOTAL_MISSIONS_IN_A_REGION },
+		{ "totalKillsByRace", CC_TOTAL_KILLS_BY_RACE },
+		{ "totalKillsByRank", CC_TOTAL_KILLS_BY_RANK },
+		{ "killsWithCriteriaCareer", CC_KILLS_WITH_CRITERIA_CAREER },
+		{ "killsWithCriteriaMission", CC_KILLS_WITH_CRITERIA_MISSION },
+		{ "killsWithCriteriaTurn", CC_KILLS_WITH_CRITERIA_TURN }
+	};
+	const int CRITERIA_NAMES = sizeof(criteriaNames) / sizeof(criteriaNames[0]);
+	const int BATTLE_TYPES = 13;
+	const int DAMAGE_TYPES = 11;
+	const std::string battleTypeArray[BATTLE_TYPES] = { "BT_NONE", "BT_FIREARM", "BT_AMMO", "BT_MELEE", "BT_GRENADE", "BT_PROXIMITYGRENADE", "BT_MEDIKIT", "BT_SCANNER", "BT_MINDPROBE", "BT_PSIAMP", "BT_FLARE", "BT_CORPSE", "BT_END" };
+	const std::string damageTypeArray[DAMAGE_TYPES] = { "DT_NONE", "DT_AP", "DT_IN", "DT_HE", "DT_LASER", "DT_PLASMA", "DT_STUN", "DT_MELEE", "DT_ACID", "DT_SMOKE", "DT_END"};
+
+	// Keep the map order, the diary evaluates the criteria in the same order as before.
+	_compiledCriteria.clear();
+	for (std::map<std::string, std::vector<int> >::const_iterator i = _criteria.begin(); i != _criteria.end(); ++i)
+	{
+		CommendationCriterion criterion = CC_UNKNOWN;
+		for (int j = 0; j != CRITERIA_NAMES; ++j)
+		{
+			if (i->first == criteriaNames[j].name)
+			{
+				criterion = criteriaNames[j].criterion;
+				break;
+			}
+		}
+		_compiledCriteria.push_back(std::make_pair(criterion, i->second));
+	}
+
+	// Details that don't name a battle or damage type get an out-of-range value, so they never match one.
+	_compiledKillCriteria.clear();
+	for (std::vector<std::vector<std::pair<int, std::vector<std::string> > > >::const_iterator orCriteria = _killCriteria.begin(); orCriteria != _killCriteria.end(); ++orCriteria)
+	{
+		std::vector<std::pair<int, std::vector<CommendationKillDetail> > > compiledOr;
+		for (std::vector<std::pair<int, std::vector<std::string> > >::const_iterator andCriteria = orCriteria->begin(); andCriteria != orCriteria->end(); ++andCriteria)
+		{
+			std::vector<CommendationKillDetail> compiledAnd;
+			for (std::vector<std::string>::const_iterator detail = andCriteria->second.begin(); detail != andCriteria->second.end(); ++detail)
+			{
+				CommendationKillDetail compiled;
+				compiled.name = *detail;
+				compiled.battleType = std::find(battleTypeArray, battleTypeArray + BATTLE_TYPES, *detail) - battleTypeArray;
+				compiled.damageType = std::find(damageTypeArray, damageTypeArray + DAMAGE_TYPES, *detail) - damageTypeArray;
+				compiledAnd.push_back(compiled);
+			}
+			compiledOr.push_back(std::make_pair(andCriteria->first, compiledAnd));
+		}
+		_compiledKillCriteria.push_back(compiledOr);
+	}
 }
 
 /**
@@ -75,6 +184,26 @@ std::vector<std::vector<std::pair<int, std::vector<std::string> > > > *RuleComme
 	return &_killCriteria;
 }
 
+/**
+ * Get the commendation's award criteria, with the
+ * names resolved into evaluator ids.
+ * @return List of criteria and their thresholds per level.
+ */
+const std::vector<std::pair<CommendationCriterion, std::vector<int> > > &RuleCommendations::getCompiledCriteria() const
+{
+	return _compiledCriteria;
+}
+
+/**
+ * Get the commendation's award kill criteria, with the
+ * battle and damage types resolved.
+ * @return List of OR blocks of AND blocks of kill details.
+ */
+const std::vector<std::vector<std::pair<int, std::vector<CommendationKillDetail> > > > &RuleCommendations::getCompiledKillCriteria() const
+{
+	return _compiledKillCriteria;
+}
+
 /**
  * Get the commendation's sprite.
  * @return int Sprite number.
@@ -22,6 +22,32 @@
 namespace OpenXcom
 {
 
+/// Award criteria understood by the soldier diary, resolved from their names when the ruleset loads.
+enum CommendationCriterion
+{
+	CC_UNKNOWN, CC_TOTAL_KILLS, CC_TOTAL_MISSIONS, CC_TOTAL_WINS, CC_TOTAL_SCORE, CC_TOTAL_STUNS, CC_TOTAL_DAYS_WOUNDED,
+	CC_TOTAL_BASE_DEFENSE_MISSIONS, CC_TOTAL_TERROR_MISSIONS, CC_TOTAL_NIGHT_MISSIONS, CC_TOTAL_NIGHT_TERROR_MISSIONS,
+	CC_TOTAL_MONTHLY_SERVICE, CC_TOTAL_FELL_UNCONSCIOUS, CC_TOTAL_SHOT_AT_10_TIMES, CC_TOTAL_HIT_5_TIMES, CC_TOTAL_FRIENDLY_FIRED,
+	CC_TOTAL_LONE_SURVIVOR, CC_TOTAL_IRON_MAN, CC_TOTAL_IMPORTANT_MISSIONS, CC_TOTAL_LONG_DISTANCE_HITS, CC_TOTAL_LOW_ACCURACY_HITS,
+	CC_TOTAL_REACTION_FIRE, CC_TOTAL_TIMES_WOUNDED, CC_TOTAL_VALIANT_CRUX, CC_IS_DEAD, CC_TOTAL_TRAP_KILLS, CC_TOTAL_ALIEN_BASE_ASSAULTS,
+	CC_TOTAL_ALL_ALIENS_KILLED, CC_TOTAL_ALL_ALIENS_STUNNED, CC_TOTAL_WOUNDS_HEALED, CC_TOTAL_ALL_UFOS, CC_TOTAL_ALL_MISSION_TYPES,
+	CC_TOTAL_STAT_GAIN, CC_TOTAL_REVIVES, CC_TOTAL_SOLDIER_REVIVES, CC_TOTAL_HOSTILE_REVIVES, CC_TOTAL_NEUTRAL_REVIVES,
+	CC_TOTAL_WHOLE_MEDIKIT, CC_TOTAL_BRAVERY_GAIN, CC_BEST_OF_RANK, CC_BEST_SOLDIER, CC_IS_MIA, CC_TOTAL_MARTYR_KILLS,
+	CC_TOTAL_POST_MORTEM_KILLS, CC_GLOBE_TROTTER, CC_TOTAL_SLAVE_KILLS,
+	CC_TOTAL_KILLS_WITH_A_WEAPON, CC_TOTAL_MISSIONS_IN_A_REGION, CC_TOTAL_KILLS_BY_RACE, CC_TOTAL_KILLS_BY_RANK,
+	CC_KILLS_WITH_CRITERIA_CAREER, CC_KILLS_WITH_CRITERIA_MISSION, CC_KILLS_WITH_CRITERIA_TURN
+};
+
+/**
+ * A single detail of a kill criteria, with the
+ * battle and damage types it names already resolved.
+ */
+struct CommendationKillDetail
+{
+	std::string name;
+	int battleType, damageType;
+};
+
 /**
  * Represents a specific type of commendation.
  * Contains constant info about a commendation like
@@ -33,8 +59,12 @@ class RuleCommendations
 private:
 	std::map<std::string, std::vector<int> > _criteria;
 	std::vector<std::vector<std::pair<int, std::vector<std::string> > > > _killCriteria;
+	std::vector<std::pair<CommendationCriterion, std::vector<int> > > _compiledCriteria;
+	std::vector<std::vector<std::pair<int, std::vector<CommendationKillDetail> > > > _compiledKillCriteria;
 	std::string _description;
 	int _sprite;
+	/// Resolves the criteria names into evaluator ids.
+	void compileCriteria();
 public:
 	/// Creates a blank commendation ruleset.
 	RuleCommendations();
@@ -48,6 +78,10 @@ public:
 	std::map<std::string, std::vector<int> > *getCriteria();
 	/// Get the commendation's award kill related criteria.
 	std::vector<std::vector<std::pair<int, std::vector<std::string> > > > *getKillCriteria();
+	/// Get the commendation's award criteria, resolved for evaluation.
+	const std::vector<std::pair<CommendationCriterion, std::vector<int> > > &getCompiledCriteria() const;
+	/// Get the commendation's award kill related criteria, resolved for evaluation.
+	const std::vector<std::vector<std::pair<int, std::vector<CommendationKillDetail> > > > &getCompiledKillCriteria() const;
 	/// Get the commendation's sprite.
 	int getSprite() const;
 
@@ -17,12 +17,13 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleResearch.h"
+#include "Mod.h"
 #include "../Engine/Exception.h"
 
 namespace OpenXcom
 {
 
-RuleResearch::RuleResearch(const std::string & name) : _name(name), _cost(0), _points(0), _needItem(false), _destroyItem(false), _listOrder(0)
+RuleResearch::RuleResearch(const std::string & name) : _name(name), _cost(0), _points(0), _needItem(false), _destroyItem(false), _listOrder(0), _index(0)
 {
 }
 
@@ -163,4 +164,73 @@ const std::string & RuleResearch::getCutscene() const
 	return _cutscene;
 }
 
+/**
+ * Looks up the research topics this one refers to by name, so
+ * checking them later doesn't need any string lookups.
+ * Missing dependencies and requirements are kept as null,
+ * since they can never be discovered.
+ * @param index Position of this research in the research list.
+ * @param mod Pointer to the mod with all the research.
+ */
+void RuleResearch::link(size_t index, const Mod *mod)
+{
+	_index = index;
+	_dependencyRules.clear();
+	_unlockRules.clear();
+	_requiresRules.clear();
+	for (std::vector<std::string>::const_iterator i = _dependencies.begin(); i != _dependencies.end(); ++i)
+	{
+		_dependencyRules.push_back(mod->getResearch(*i));
+	}
+	for (std::vector<std::string>::const_iterator i = _unlocks.begin(); i != _unlocks.end(); ++i)
+	{
+		const RuleResearch *unlock = mod->getResearch(*i);
+		if (unlock != 0)
+		{
+			_unlockRules.push_back(unlock);
+		}
+	}
+	for (std::vector<std::string>::const_iterator i = _requires.begin(); i != _requires.end(); ++i)
+	{
+		_requiresRules.push_back(mod->getResearch(*i));
+	}
+}
+
+/**
+ * Gets the position of this research in the mod's research list,
+ * used to keep track of it with plain indexes.
+ * @return The research index.
+ */
+size_t RuleResearch::getIndex() const
+{
+	return _index;
+}
+
+/**
+ * Gets the research that must be discovered before this one.
+ * @return The list of research, null for topics that don't exist.
+ */
+const std::vector<const RuleResearch*> & RuleResearch::getDependencyRules() const
+{
+	return _dependencyRules;
+}
+
+/**
+ * Gets the research unlocked by this one.
+ * @return The list of research.
+ */
+const std::vector<const RuleResearch*> & RuleResearch::getUnlockedRules() const
+{
+	return _unlockRules;
+}
+
+/**
+ * Gets the research required to discover this one.
+ * @return The list of research, null for topics that don't exist.
+ */
+const std::vector<const RuleResearch*> & RuleResearch::getRequirementRules() const
+{
+	return _requiresRules;
+}
+
 }
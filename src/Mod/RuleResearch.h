@@ -23,6 +23,9 @@
 
 namespace OpenXcom
 {
+
+class Mod;
+
 /**
  * Represents one research project.
  * Dependency is the list of RuleResearchs which must be discovered before a RuleResearch became available.
@@ -43,6 +46,8 @@ class RuleResearch
 	std::vector<std::string> _dependencies, _unlocks, _getOneFree, _requires;
 	bool _needItem, _destroyItem;
 	int _listOrder;
+	size_t _index;
+	std::vector<const RuleResearch*> _dependencyRules, _unlockRules, _requiresRules;
 public:
 	RuleResearch(const std::string & name);
 	/// Loads the research from YAML.
@@ -71,6 +76,16 @@ public:
 	int getListOrder() const;
 	/// Gets the cutscene to play when this item is researched
 	const std::string & getCutscene() const;
+	/// Resolves the research topics this one refers to.
+	void link(size_t index, const Mod *mod);
+	/// Gets the position of this research in the research graph.
+	size_t getIndex() const;
+	/// Gets the resolved research dependencies.
+	const std::vector<const RuleResearch*> & getDependencyRules() const;
+	/// Gets the resolved research unlocked by this research.
+	const std::vector<const RuleResearch*> & getUnlockedRules() const;
+	/// Gets the resolved requirements for this research.
+	const std::vector<const RuleResearch*> & getRequirementRules() const;
 };
 
 /**
@@ -20,6 +20,7 @@
 #include "../fmath.h"
 #include <stack>
 #include <algorithm>
+#include <cassert>
 #include "BaseFacility.h"
 #include "../Mod/RuleBaseFacility.h"
 #include "Craft.h"
@@ -55,6 +56,7 @@ namespace OpenXcom
 Base::Base(const Mod *mod) : Target(), _mod(mod), _scientists(0), _engineers(0), _inBattlescape(false), _retaliationTarget(false)
 {
 	_items = new ItemContainer();
+	std::fill(_capacities, _capacities + CAPACITY_TYPES, 0);
 }
 
 /**
@@ -124,6 +126,7 @@ void Base::load(const YAML::Node &node, SavedGame *save, bool newGame, bool newB
 			}
 		}
 	}
+	updateCapacities();
 
 	for (YAML::const_iterator i = node["crafts"].begin(); i != node["crafts"].end(); ++i)
 	{
@@ -630,15 +633,7 @@ int Base::getUsedQuarters() const
  */
 int Base::getAvailableQuarters() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getPersonnel();
-		}
-	}
-	return total;
+	return getCapacity(CAPACITY_QUARTERS);
 }
 
 /**
@@ -696,15 +691,7 @@ bool Base::storesOverfull(double offset)
  */
 int Base::getAvailableStores() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getStorage();
-		}
-	}
-	return total;
+	return getCapacity(CAPACITY_STORES);
 }
 
 /**
@@ -766,15 +753,7 @@ int Base::getUsedLaboratories() const
  */
 int Base::getAvailableLaboratories() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getLaboratories();
-		}
-	}
-	return total;
+	return getCapacity(CAPACITY_LABORATORIES);
 }
 
 /**
@@ -799,15 +778,7 @@ int Base::getUsedWorkshops() const
  */
 int Base::getAvailableWorkshops() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getWorkshops();
-		}
-	}
-	return total;
+	return getCapacity(CAPACITY_WORKSHOPS);
 }
 
 /**
@@ -843,15 +814,7 @@ int Base::getUsedHangars() const
  */
 int Base::getAvailableHangars() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getCrafts();
-		}
-	}
-	return total;
+	return getCapacity(CAPACITY_HANGARS);
 }
 
 /**
@@ -928,15 +891,7 @@ int Base::getAllocatedEngineers() const
  */
 int Base::getDefenseValue() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getDefenseValue();
-		}
-	}
-	return total;
+	return getCapacity(CAPACITY_DEFENSE);
 }
 
 /**
@@ -946,18 +901,7 @@ int Base::getDefenseValue() const
  */
 int Base::getShortRangeDetection() const
 {
-	int total = 0;
-	int minRadarRange = _mod->getMinRadarRange();
-
-	if (minRadarRange == 0) return 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getRules()->getRadarRange() == minRadarRange && (*i)->getBuildTime() == 0)
-		{
-			total++;
-		}
-	}
-	return total;
+	return getCapacity(CAPACITY_SHORT_RANGE_DETECTION);
 }
 
 /**
@@ -967,17 +911,7 @@ int Base::getShortRangeDetection() const
  */
 int Base::getLongRangeDetection() const
 {
-	int total = 0;
-	int minRadarRange = _mod->getMinRadarRange();
-
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getRules()->getRadarRange() > minRadarRange && (*i)->getBuildTime() == 0)
-		{
-			total++;
-		}
-	}
-	return total;
+	return getCapacity(CAPACITY_LONG_RANGE_DETECTION);
 }
 
 /**
@@ -1085,15 +1019,7 @@ int Base::getPersonnelMaintenance() const
  */
 int Base::getFacilityMaintenance() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getMonthlyCost();
-		}
-	}
-	return total;
+	return getCapacity(CAPACITY_MAINTENANCE);
 }
 
 /**
@@ -1106,6 +1032,70 @@ int Base::getMonthlyMaintenace() const
 	return getCraftMaintenance() + getPersonnelMaintenance() + getFacilityMaintenance();
 }
 
+/**
+ * Adds up the capacities provided by all the
+ * completed facilities in the base.
+ * @param capacities Array of CAPACITY_TYPES totals to fill.
+ */
+void Base::calculateCapacities(int *capacities) const
+{
+	int minRadarRange = _mod->getMinRadarRange();
+	std::fill(capacities, capacities + CAPACITY_TYPES, 0);
+	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
+	{
+		if ((*i)->getBuildTime() != 0)
+		{
+			continue;
+		}
+		const RuleBaseFacility *rules = (*i)->getRules();
+		capacities[CAPACITY_QUARTERS] += rules->getPersonnel();
+		capacities[CAPACITY_STORES] += rules->getStorage();
+		capacities[CAPACITY_LABORATORIES] += rules->getLaboratories();
+		capacities[CAPACITY_WORKSHOPS] += rules->getWorkshops();
+		capacities[CAPACITY_HANGARS] += rules->getCrafts();
+		capacities[CAPACITY_PSI_LABORATORIES] += rules->getPsiLaboratories();
+		capacities[CAPACITY_CONTAINMENT] += rules->getAliens();
+		capacities[CAPACITY_DEFENSE] += rules->getDefenseValue();
+		capacities[CAPACITY_MAINTENANCE] += rules->getMonthlyCost();
+		if (minRadarRange != 0 && rules->getRadarRange() == minRadarRange)
+		{
+			capacities[CAPACITY_SHORT_RANGE_DETECTION]++;
+		}
+		if (rules->getRadarRange() > minRadarRange)
+		{
+			capacities[CAPACITY_LONG_RANGE_DETECTION]++;
+		}
+	}
+}
+
+/**
+ * Recalculates the capacities provided by the base facilities.
+ * Must be called whenever a facility is added, removed or
+ * finishes construction, since the capacity getters only
+ * return the cached totals.
+ */
+void Base::updateCapacities()
+{
+	calculateCapacities(_capacities);
+}
+
+/**
+ * Returns a capacity provided by the base facilities.
+ * Debug builds check it against a full recalculation
+ * to catch facility changes that skipped updateCapacities().
+ * @param capacity Capacity type.
+ * @return Capacity total.
+ */
+int Base::getCapacity(BaseCapacity capacity) const
+{
+#ifdef _DEBUG
+	int capacities[CAPACITY_TYPES];
+	calculateCapacities(capacities);
+	assert(std::equal(capacities, capacities + CAPACITY_TYPES, _capacities));
+#endif
+	return _capacities[capacity];
+}
+
 /**
  * Returns the list of all base's ResearchProject
  * @return list of base's ResearchProject
@@ -1188,15 +1178,7 @@ const std::vector<Production *> & Base::getProductions() const
  */
 int Base::getAvailablePsiLabs() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getPsiLaboratories();
-		}
-	}
-	return total;
+	return getCapacity(CAPACITY_PSI_LABORATORIES);
 }
 
 /**
@@ -1224,14 +1206,7 @@ int Base::getUsedPsiLabs() const
  */
 int Base::getUsedContainment() const
 {
-	int total = 0;
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); ++i)
-	{
-		if (_mod->getItem((i)->first, true)->isAlien())
-		{
-			total += (i)->second;
-		}
-	}
+	int total = _items->getTotalAliens(_mod);
 	for (std::vector<Transfer*>::const_iterator i = _transfers.begin(); i != _transfers.end(); ++i)
 	{
 		if ((*i)->getType() == TRANSFER_ITEM)
@@ -1260,15 +1235,7 @@ int Base::getUsedContainment() const
  */
 int Base::getAvailableContainment() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getAliens();
-		}
-	}
-	return total;
+	return getCapacity(CAPACITY_CONTAINMENT);
 }
 
 /**
@@ -1759,6 +1726,7 @@ void Base::destroyFacility(std::vector<BaseFacility*>::iterator facility)
 	}
 	delete *facility;
 	_facilities.erase(facility);
+	updateCapacities();
 }
 
 /**
@@ -38,6 +38,10 @@ class ResearchProject;
 class Production;
 class Vehicle;
 
+/// Capacities provided by the completed facilities of a base.
+enum BaseCapacity { CAPACITY_QUARTERS, CAPACITY_STORES, CAPACITY_LABORATORIES, CAPACITY_WORKSHOPS, CAPACITY_HANGARS, CAPACITY_PSI_LABORATORIES,
+	CAPACITY_CONTAINMENT, CAPACITY_DEFENSE, CAPACITY_SHORT_RANGE_DETECTION, CAPACITY_LONG_RANGE_DETECTION, CAPACITY_MAINTENANCE, CAPACITY_TYPES };
+
 /**
  * Represents a player base on the globe.
  * Bases can contain facilities, personnel, crafts and equipment.
@@ -59,9 +63,14 @@ private:
 	bool _retaliationTarget;
 	std::vector<Vehicle*> _vehicles;
 	std::vector<BaseFacility*> _defenses;
+	int _capacities[CAPACITY_TYPES];
 
 	/// Determines space taken up by ammo clips about to rearm craft.
 	double getIgnoredStores();
+	/// Adds up the capacities of the completed facilities.
+	void calculateCapacities(int *capacities) const;
+	/// Gets a cached facility capacity.
+	int getCapacity(BaseCapacity capacity) const;
 
 	using Target::load;
 public:
@@ -213,6 +222,8 @@ public:
 	void destroyFacility(std::vector<BaseFacility*>::iterator facility);
 	/// Cleans up the defenses vector and optionally reclaims the tanks and their ammo.
 	void cleanupDefenses(bool reclaimItems);
+	/// Recalculates the capacities provided by the facilities.
+	void updateCapacities();
 	/// Removes a craft from the base.
 	std::vector<Craft*>::iterator removeCraft(Craft *craft, bool unload);
 };
@@ -131,7 +131,12 @@ int BaseFacility::getBuildTime() const
  */
 void BaseFacility::setBuildTime(int time)
 {
+	bool wasBuilt = (_buildTime == 0);
 	_buildTime = time;
+	if (wasBuilt != (_buildTime == 0))
+	{
+		_base->updateCapacities();
+	}
 }
 
 /**
@@ -140,6 +145,10 @@ void BaseFacility::setBuildTime(int time)
 void BaseFacility::build()
 {
 	_buildTime--;
+	if (_buildTime == 0)
+	{
+		_base->updateCapacities();
+	}
 }
 
 /**
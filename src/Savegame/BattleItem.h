@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <yaml-cpp/yaml.h>
+#include "../Engine/ObjectPool.h"
 
 namespace OpenXcom
 {
@@ -53,6 +54,7 @@ public:
 	BattleItem(RuleItem *rules, int *id);
 	/// Cleans up the item.
 	~BattleItem();
+	OXC_POOLED_OBJECT(BattleItem)
 	/// Loads the item from YAML.
 	void load(const YAML::Node& node, Mod *mod);
 	/// Saves the item to YAML.
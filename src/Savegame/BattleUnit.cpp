@@ -41,6 +41,42 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/**
+ * Sets a flag in a bitset, growing it as needed.
+ * @param bits Bitset.
+ * @param index Flag index.
+ * @return False if the flag was already set.
+ */
+bool setFlag(std::vector<bool> &bits, size_t index)
+{
+	if (index >= bits.size())
+	{
+		bits.resize(index + 1, false);
+	}
+	if (bits[index])
+	{
+		return false;
+	}
+	bits[index] = true;
+	return true;
+}
+
+/**
+ * Checks a flag in a bitset.
+ * @param bits Bitset.
+ * @param index Flag index.
+ * @return True if the flag is set.
+ */
+bool hasFlag(const std::vector<bool> &bits, size_t index)
+{
+	return index < bits.size() && bits[index];
+}
+
+}
+
 /**
  * Initializes a BattleUnit from a Soldier
  * @param soldier Pointer to the Soldier.
@@ -1422,25 +1458,13 @@ void BattleUnit::setTimeUnits(int tu)
  */
 bool BattleUnit::addToVisibleUnits(BattleUnit *unit)
 {
-	bool add = true;
-	for (std::vector<BattleUnit*>::iterator i = _unitsSpottedThisTurn.begin(); i != _unitsSpottedThisTurn.end();++i)
-	{
-		if ((BattleUnit*)(*i) == unit)
-		{
-			add = false;
-			break;
-		}
-	}
-	if (add)
+	if (setFlag(_spottedUnitIds, unit->getId()))
 	{
 		_unitsSpottedThisTurn.push_back(unit);
 	}
-	for (std::vector<BattleUnit*>::iterator i = _visibleUnits.begin(); i != _visibleUnits.end(); ++i)
+	if (!setFlag(_visibleUnitIds, unit->getId()))
 	{
-		if ((BattleUnit*)(*i) == unit)
-		{
-			return false;
-		}
+		return false;
 	}
 	_visibleUnits.push_back(unit);
 	return true;
@@ -1460,27 +1484,80 @@ std::vector<BattleUnit*> *BattleUnit::getVisibleUnits()
  */
 void BattleUnit::clearVisibleUnits()
 {
+	for (std::vector<BattleUnit*>::iterator i = _visibleUnits.begin(); i != _visibleUnits.end(); ++i)
+	{
+		_visibleUnitIds[(*i)->getId()] = false;
+	}
 	_visibleUnits.clear();
 }
 
 /**
- * Add this unit to the list of visible tiles. Returns true if this is a new one.
- * @param tile
+ * Checks if a unit is in the list of visible units.
+ * @param unit Unit to check.
+ * @return True if this unit sees it.
+ */
+bool BattleUnit::hasVisibleUnit(BattleUnit *unit) const
+{
+	return hasFlag(_visibleUnitIds, unit->getId());
+}
+
+/**
+ * Checks if a unit is in the list of units spotted this turn.
+ * @param unit Unit to check.
+ * @return True if this unit spotted it.
+ */
+bool BattleUnit::hasSpottedUnit(BattleUnit *unit) const
+{
+	return hasFlag(_spottedUnitIds, unit->getId());
+}
+
+/**
+ * Starts collecting the visible tiles anew. The previous ones are kept
+ * until endVisibleTiles, so only the tiles that actually changed
+ * have their visibility updated.
+ */
+void BattleUnit::beginVisibleTiles()
+{
+	_previousVisibleTiles.swap(_visibleTiles);
+	_previousVisibleTileIndexes.swap(_visibleTileIndexes);
+}
+
+/**
+ * Add this tile to the list of visible tiles. Returns true if this is a new one.
+ * The tile stays visible as long as it's in the list.
+ * @param tile Tile seen.
+ * @param index Index of the tile on the map.
  * @return
  */
-bool BattleUnit::addToVisibleTiles(Tile *tile)
+bool BattleUnit::addToVisibleTiles(Tile *tile, int index)
 {
-	_visibleTiles.push_back(tile);
+	if (!setFlag(_visibleTileIndexes, index))
+	{
+		return false;
+	}
+	_visibleTiles.push_back(std::make_pair(index, tile));
+	if (!hasFlag(_previousVisibleTileIndexes, index))
+	{
+		tile->setVisible(+1);
+	}
 	return true;
 }
 
 /**
- * Get the pointer to the vector of visible tiles.
- * @return pointer to vector.
+ * Releases the tiles seen before beginVisibleTiles
+ * that haven't been added again since.
  */
-std::vector<Tile*> *BattleUnit::getVisibleTiles()
+void BattleUnit::endVisibleTiles()
 {
-	return &_visibleTiles;
+	for (std::vector<std::pair<int, Tile*> >::iterator i = _previousVisibleTiles.begin(); i != _previousVisibleTiles.end(); ++i)
+	{
+		if (!hasFlag(_visibleTileIndexes, i->first))
+		{
+			i->second->setVisible(-1);
+		}
+		_previousVisibleTileIndexes[i->first] = false;
+	}
+	_previousVisibleTiles.clear();
 }
 
 /**
@@ -1488,11 +1565,20 @@ std::vector<Tile*> *BattleUnit::getVisibleTiles()
  */
 void BattleUnit::clearVisibleTiles()
 {
-	for (std::vector<Tile*>::iterator j = _visibleTiles.begin(); j != _visibleTiles.end(); ++j)
+	beginVisibleTiles();
+	endVisibleTiles();
+}
+
+/**
+ * Empties the list of visible tiles without touching the tiles,
+ * for when they belong to a map that is gone.
+ */
+void BattleUnit::forgetVisibleTiles()
+{
+	for (std::vector<std::pair<int, Tile*> >::iterator i = _visibleTiles.begin(); i != _visibleTiles.end(); ++i)
 	{
-		(*j)->setVisible(-1);
+		_visibleTileIndexes[i->first] = false;
 	}
-
 	_visibleTiles.clear();
 }
 
@@ -1649,6 +1735,10 @@ void BattleUnit::prepareNewTurn(bool fullProcess)
 	}
 
 
+	for (std::vector<BattleUnit*>::iterator i = _unitsSpottedThisTurn.begin(); i != _unitsSpottedThisTurn.end(); ++i)
+	{
+		_spottedUnitIds[(*i)->getId()] = false;
+	}
 	_unitsSpottedThisTurn.clear();
 
 	// revert to original faction
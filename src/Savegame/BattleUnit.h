@@ -19,6 +19,7 @@
  */
 #include <vector>
 #include <string>
+#include <utility>
 #include <yaml-cpp/yaml.h>
 #include "../Battlescape/Position.h"
 #include "../Battlescape/BattlescapeGame.h"
@@ -74,7 +75,9 @@ private:
 	UnitStatus _status;
 	int _walkPhase, _fallPhase;
 	std::vector<BattleUnit *> _visibleUnits, _unitsSpottedThisTurn;
-	std::vector<Tile *> _visibleTiles;
+	std::vector<bool> _visibleUnitIds, _spottedUnitIds;
+	std::vector<std::pair<int, Tile *> > _visibleTiles, _previousVisibleTiles;
+	std::vector<bool> _visibleTileIndexes, _previousVisibleTileIndexes;
 	int _tu, _energy, _health, _morale, _stunlevel;
 	bool _kneeled, _floating, _dontReselect;
 	int _currentArmor[5], _maxArmor[5];
@@ -246,12 +249,20 @@ public:
 	std::vector<BattleUnit*> *getVisibleUnits();
 	/// Clear visible units.
 	void clearVisibleUnits();
+	/// Checks if a unit is in the visible units.
+	bool hasVisibleUnit(BattleUnit *unit) const;
+	/// Checks if a unit was spotted this turn.
+	bool hasSpottedUnit(BattleUnit *unit) const;
+	/// Starts collecting the visible tiles anew.
+	void beginVisibleTiles();
 	/// Add unit to visible tiles.
-	bool addToVisibleTiles(Tile *tile);
-	/// Get the list of visible tiles.
-	std::vector<Tile*> *getVisibleTiles();
+	bool addToVisibleTiles(Tile *tile, int index);
+	/// Releases the tiles that are no longer visible.
+	void endVisibleTiles();
 	/// Clear visible tiles.
 	void clearVisibleTiles();
+	/// Forgets the visible tiles without releasing them.
+	void forgetVisibleTiles();
 	/// Calculate firing accuracy.
 	int getFiringAccuracy(BattleActionType actionType, BattleItem *item);
 	/// Calculate accuracy modifier.
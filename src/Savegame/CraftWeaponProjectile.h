@@ -17,6 +17,9 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <cstddef>
+#include "../Engine/ObjectPool.h"
+
 namespace OpenXcom {
 
 class Surface;
@@ -50,6 +53,7 @@ private:
 public:
 	CraftWeaponProjectile();
 	~CraftWeaponProjectile(void);
+	OXC_POOLED_OBJECT(CraftWeaponProjectile)
 
 	/// Sets projectile type. This determines it's speed.
 	void setType(CraftWeaponProjectileType type);
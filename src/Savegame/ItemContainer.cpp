@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "ItemContainer.h"
+#include <cassert>
 #include "../Mod/Mod.h"
 #include "../Mod/RuleItem.h"
 
@@ -26,7 +27,7 @@ namespace OpenXcom
 /**
  * Initializes an item container with no contents.
  */
-ItemContainer::ItemContainer()
+ItemContainer::ItemContainer() : _cachedMod(0), _totalSize(0), _totalAliens(0)
 {
 }
 
@@ -44,6 +45,7 @@ ItemContainer::~ItemContainer()
 void ItemContainer::load(const YAML::Node &node)
 {
 	_qty = node.as< std::map<std::string, int> >(_qty);
+	_cachedMod = 0;
 }
 
 /**
@@ -73,6 +75,7 @@ void ItemContainer::addItem(const std::string &id, int qty)
 		_qty[id] = 0;
 	}
 	_qty[id] += qty;
+	_cachedMod = 0;
 }
 
 /**
@@ -94,6 +97,7 @@ void ItemContainer::removeItem(const std::string &id, int qty)
 	{
 		_qty.erase(id);
 	}
+	_cachedMod = 0;
 }
 
 /**
@@ -134,18 +138,58 @@ int ItemContainer::getTotalQuantity() const
 }
 
 /**
- * Returns the total size of the items in the container.
+ * Recalculates the totals of the items in the container.
+ * They are only recalculated after the contents change,
+ * the stores screens ask for them on every refresh.
  * @param mod Pointer to mod.
- * @return Total item size.
  */
-double ItemContainer::getTotalSize(const Mod *mod) const
+void ItemContainer::cacheTotals(const Mod *mod)
 {
-	double total = 0;
+	double size = 0;
+	int aliens = 0;
 	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
 	{
-		total += mod->getItem(i->first, true)->getSize() * i->second;
+		RuleItem *rule = mod->getItem(i->first, true);
+		size += rule->getSize() * i->second;
+		if (rule->isAlien())
+		{
+			aliens += i->second;
+		}
 	}
-	return total;
+#ifdef _DEBUG
+	assert(_cachedMod != mod || (size == _totalSize && aliens == _totalAliens));
+#endif
+	_totalSize = size;
+	_totalAliens = aliens;
+	_cachedMod = mod;
+}
+
+/**
+ * Returns the total size of the items in the container.
+ * @param mod Pointer to mod.
+ * @return Total item size.
+ */
+double ItemContainer::getTotalSize(const Mod *mod)
+{
+#ifndef _DEBUG
+	if (_cachedMod != mod)
+#endif
+		cacheTotals(mod);
+	return _totalSize;
+}
+
+/**
+ * Returns the total quantity of the live aliens in the container.
+ * @param mod Pointer to mod.
+ * @return Total alien quantity.
+ */
+int ItemContainer::getTotalAliens(const Mod *mod)
+{
+#ifndef _DEBUG
+	if (_cachedMod != mod)
+#endif
+		cacheTotals(mod);
+	return _totalAliens;
 }
 
 /**
@@ -154,6 +198,8 @@ double ItemContainer::getTotalSize(const Mod *mod) const
  */
 std::map<std::string, int> *ItemContainer::getContents()
 {
+	// The caller may change the contents directly.
+	_cachedMod = 0;
 	return &_qty;
 }
 
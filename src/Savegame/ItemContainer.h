@@ -35,6 +35,11 @@ class ItemContainer
 {
 private:
 	std::map<std::string, int> _qty;
+	const Mod *_cachedMod;
+	double _totalSize;
+	int _totalAliens;
+	/// Recalculates the cached totals.
+	void cacheTotals(const Mod *mod);
 public:
 	/// Creates an empty item container.
 	ItemContainer();
@@ -53,7 +58,9 @@ public:
 	/// Gets the total quantity of items in the container.
 	int getTotalQuantity() const;
 	/// Gets the total size of items in the container.
-	double getTotalSize(const Mod *mod) const;
+	double getTotalSize(const Mod *mod);
+	/// Gets the total quantity of live aliens in the container.
+	int getTotalAliens(const Mod *mod);
 	/// Gets all the items in the container.
 	std::map<std::string, int> *getContents();
 };
@@ -24,10 +24,26 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+inline double dot(const Cord &a, const Cord &b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Cord cross(const Cord &a, const Cord &b)
+{
+	return Cord(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+}
+
 /**
  * Initializes a moving target with blank coordinates.
  */
-MovingTarget::MovingTarget() : Target(), _dest(0), _speedLon(0.0), _speedLat(0.0), _speedRadian(0.0), _meetPointLon(0.0), _meetPointLat(0.0), _speed(0), _meetCalculated(false)
+MovingTarget::MovingTarget() : Target(), _dest(0), _speedLon(0.0), _speedLat(0.0), _speedRadian(0.0), _meetPointLon(0.0), _meetPointLat(0.0), _speed(0), _meetCalculated(false),
+	_routeLon(0.0), _routeLat(0.0), _routeMeetLon(0.0), _routeMeetLat(0.0), _routeSpeed(0.0), _routeDistance(0.0), _routeCos(1.0), _routeSin(0.0), _routeCalculated(false)
 {
 }
 
@@ -162,7 +178,7 @@ void MovingTarget::setSpeed(int speed)
 
 /**
  * Calculates the speed vector based on the
- * great circle distance to destination and
+ * great circle route to destination and
  * current raw speed.
  */
 void MovingTarget::calculateSpeed()
@@ -170,12 +186,14 @@ void MovingTarget::calculateSpeed()
 	calculateMeetPoint();
 	if (_dest != 0)
 	{
-		double dLon, dLat, length;
-		dLon = sin(_meetPointLon - _lon) * cos(_meetPointLat);
-		dLat = cos(_lat) * sin(_meetPointLat) - sin(_lat) * cos(_meetPointLat) * cos(_meetPointLon - _lon);
-		length = sqrt(dLon * dLon + dLat * dLat);
-		_speedLat = dLat / length * _speedRadian;
-		_speedLon = dLon / length * _speedRadian / cos(_lat + _speedLat);
+		calculateRoute();
+		// split the heading along the route into its east and north parts
+		Cord heading = cross(_routeAxis, _routePos);
+		double cosLat = sqrt(_routePos.x * _routePos.x + _routePos.z * _routePos.z);
+		double dLon = (heading.x * _routePos.z - heading.z * _routePos.x) / cosLat;
+		double dLat = heading.y * cosLat - _routePos.y * (heading.x * _routePos.x + heading.z * _routePos.z) / cosLat;
+		_speedLat = dLat * _speedRadian;
+		_speedLon = dLon * _speedRadian / cos(_lat + _speedLat);
 
 		// Check for invalid speeds when a division by zero occurs due to near-zero values
 		if (!(_speedLon == _speedLon) || !(_speedLat == _speedLat))
@@ -191,6 +209,42 @@ void MovingTarget::calculateSpeed()
 	}
 }
 
+/**
+ * Calculates the great circle from the current position
+ * to the meeting point, as the position on the unit sphere,
+ * the rotation axis and the angle left to travel.
+ * Only done when the position, meeting point or speed
+ * changed since, otherwise the route is still good.
+ */
+void MovingTarget::calculateRoute()
+{
+	if (_routeCalculated && _routeLon == _lon && _routeLat == _lat &&
+		_routeMeetLon == _meetPointLon && _routeMeetLat == _meetPointLat && _routeSpeed == _speedRadian)
+	{
+		return;
+	}
+
+	_routePos = Cord(CordPolar(_lon, _lat));
+	Cord meet = Cord(CordPolar(_meetPointLon, _meetPointLat));
+	_routeAxis = cross(_routePos, meet);
+	double sine = _routeAxis.norm();
+	_routeDistance = atan2(sine, dot(_routePos, meet));
+	// no axis if already there (or exactly on the other side of the globe)
+	if (sine > 0.0)
+	{
+		_routeAxis /= sine;
+	}
+	_routeCos = cos(_speedRadian);
+	_routeSin = sin(_speedRadian);
+
+	_routeLon = _lon;
+	_routeLat = _lat;
+	_routeMeetLon = _meetPointLon;
+	_routeMeetLat = _meetPointLat;
+	_routeSpeed = _speedRadian;
+	_routeCalculated = true;
+}
+
 /**
  * Checks if the moving target has reached its destination.
  * @return True if it has, False otherwise.
@@ -206,16 +260,28 @@ bool MovingTarget::reachedDestination() const
 
 /**
  * Executes a movement cycle for the moving target.
+ * Along the way this is a single rotation around the
+ * route's axis, the route itself is only recalculated
+ * when the meeting point moves.
  */
 void MovingTarget::move()
 {
 	calculateSpeed();
 	if (_dest != 0)
 	{
-		if (getDistance(_meetPointLon, _meetPointLat) > _speedRadian)
+		if (_routeDistance > _speedRadian)
 		{
-			setLongitude(_lon + _speedLon);
-			setLatitude(_lat + _speedLat);
+			Cord heading = cross(_routeAxis, _routePos);
+			heading *= _routeSin;
+			_routePos *= _routeCos;
+			_routePos += heading;
+			_routePos /= _routePos.norm();
+			CordPolar pos = CordPolar(_routePos);
+			setLongitude(pos.lon);
+			setLatitude(pos.lat);
+			_routeDistance -= _speedRadian;
+			_routeLon = _lon;
+			_routeLat = _lat;
 		}
 		else
 		{
@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Target.h"
+#include "../Geoscape/Cord.h"
 
 namespace OpenXcom
 {
@@ -36,9 +37,15 @@ protected:
 	double _meetPointLon, _meetPointLat;
 	int _speed;
 	bool _meetCalculated;
+	Cord _routePos, _routeAxis;
+	double _routeLon, _routeLat, _routeMeetLon, _routeMeetLat, _routeSpeed;
+	double _routeDistance, _routeCos, _routeSin;
+	bool _routeCalculated;
 
 	/// Calculates a new speed vector to the destination.
 	virtual void calculateSpeed();
+	/// Calculates the great circle route to the meeting point.
+	void calculateRoute();
 	/// Converts a speed to radians.
 	static double calculateRadianSpeed(int speed);
 	/// Creates a moving target.
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "NodeIndex.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include "Node.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Sorts the nodes of a map into buckets and grid cells.
+ * @param nodes Nodes of the map, in their original order.
+ * @param mapsize_x Map width.
+ * @param mapsize_y Map length.
+ * @param mapsize_z Map height.
+ */
+NodeIndex::NodeIndex(const std::vector<Node*> &nodes, int mapsize_x, int mapsize_y, int mapsize_z) : _nodes(nodes)
+{
+	_cellsX = std::max(1, (mapsize_x + CELL_SIZE - 1) / CELL_SIZE);
+	_cellsY = std::max(1, (mapsize_y + CELL_SIZE - 1) / CELL_SIZE);
+	_levels = std::max(1, mapsize_z);
+	_cells.resize(_cellsX * _cellsY * _levels);
+
+	for (size_t i = 0; i < _nodes.size(); ++i)
+	{
+		Node *node = _nodes[i];
+		if (node->isDummy())
+		{
+			continue;
+		}
+		Position pos = node->getPosition();
+		int cell = getCell(pos.x, pos.y, pos.z);
+		if (cell != -1)
+		{
+			_cells[cell].push_back(i);
+		}
+		for (int c = 0; c < UNIT_CLASSES; ++c)
+		{
+			bool small = (c & 1) == 0;
+			bool flying = (c & 2) != 0;
+			if ((!(node->getType() & Node::TYPE_SMALL) || small)
+				&& (!(node->getType() & Node::TYPE_FLYING) || flying))
+			{
+				_byClass[c].push_back(node);
+				int rank = node->getRank();
+				if (rank >= 0)
+				{
+					if ((size_t)rank >= _byRank[c].size())
+					{
+						_byRank[c].resize(rank + 1);
+					}
+					_byRank[c][rank].push_back(node);
+				}
+			}
+		}
+	}
+}
+
+/**
+ *
+ */
+NodeIndex::~NodeIndex()
+{
+}
+
+/**
+ * Gets the bucket for units of a size and movement type.
+ * @param size Unit size.
+ * @param flying Can the unit fly?
+ * @return Bucket index.
+ */
+int NodeIndex::getUnitClass(int size, bool flying)
+{
+	return (size == 1 ? 0 : 1) | (flying ? 2 : 0);
+}
+
+/**
+ * Gets the grid cell holding a map position.
+ * @param x X position.
+ * @param y Y position.
+ * @param z Z position.
+ * @return Cell index, or -1 if off the map.
+ */
+int NodeIndex::getCell(int x, int y, int z) const
+{
+	if (x < 0 || y < 0 || z < 0 || x / CELL_SIZE >= _cellsX || y / CELL_SIZE >= _cellsY || z >= _levels)
+	{
+		return -1;
+	}
+	return (z * _cellsY + y / CELL_SIZE) * _cellsX + x / CELL_SIZE;
+}
+
+/**
+ * Gets the nodes a unit fits on: the small unit bit is not set or
+ * the unit is small, the flying unit bit is not set or the unit can fly.
+ * @param size Unit size.
+ * @param flying Can the unit fly?
+ * @return List of nodes, without dummies.
+ */
+const std::vector<Node*> &NodeIndex::getNodes(int size, bool flying) const
+{
+	return _byClass[getUnitClass(size, flying)];
+}
+
+/**
+ * Gets the nodes of a rank a unit fits on.
+ * @param size Unit size.
+ * @param flying Can the unit fly?
+ * @param rank Node rank.
+ * @return List of nodes, without dummies.
+ */
+const std::vector<Node*> &NodeIndex::getNodes(int size, bool flying, int rank) const
+{
+	const std::vector<std::vector<Node*> > &byRank = _byRank[getUnitClass(size, flying)];
+	if (rank < 0 || (size_t)rank >= byRank.size())
+	{
+		return _none;
+	}
+	return byRank[rank];
+}
+
+/**
+ * Gets the closest node on the same level that matches the unit
+ * size, searching outwards ring by ring from the position's cell.
+ * Of equally close nodes, the first one is picked.
+ * @param pos Position to search from.
+ * @param size Unit size.
+ * @return Closest node, or 0 if none.
+ */
+Node *NodeIndex::getNearestNode(Position pos, int size) const
+{
+	int best = -1;
+	int closest = INT_MAX;
+	if (pos.z < 0 || pos.z >= _levels)
+	{
+		return 0;
+	}
+	int cx = std::min(std::max(pos.x / CELL_SIZE, 0), _cellsX - 1);
+	int cy = std::min(std::max(pos.y / CELL_SIZE, 0), _cellsY - 1);
+	int rings = std::max(_cellsX, _cellsY);
+	for (int ring = 0; ring <= rings; ++ring)
+	{
+		// nodes in this ring are at least this far off on x or y
+		int nearest = std::max(0, (ring - 1) * CELL_SIZE + 1);
+		if (best != -1 && nearest * nearest > closest)
+		{
+			break;
+		}
+		for (int y = cy - ring; y <= cy + ring; ++y)
+		{
+			for (int x = cx - ring; x <= cx + ring; ++x)
+			{
+				if ((std::abs(x - cx) != ring && std::abs(y - cy) != ring) || x < 0 || y < 0 || x >= _cellsX || y >= _cellsY)
+				{
+					continue;
+				}
+				const std::vector<int> &cell = _cells[(pos.z * _cellsY + y) * _cellsX + x];
+				for (std::vector<int>::const_iterator i = cell.begin(); i != cell.end(); ++i)
+				{
+					Node *node = _nodes[*i];
+					if ((node->getType() & Node::TYPE_SMALL) && size != 1)
+					{
+						continue;
+					}
+					Position d = node->getPosition() - pos;
+					int distance = d.x * d.x + d.y * d.y;
+					if (distance < closest || (distance == closest && *i < best))
+					{
+						best = *i;
+						closest = distance;
+					}
+				}
+			}
+		}
+	}
+	return best == -1 ? 0 : _nodes[best];
+}
+
+/**
+ * Gets the nodes on any level within a horizontal range of a position,
+ * so callers only have to check the nodes that can be close enough.
+ * @param pos Position to search around.
+ * @param range Maximum distance on x and y.
+ * @param nodes Receives the nodes, without dummies, in their original order.
+ */
+void NodeIndex::getNodesInRange(Position pos, int range, std::vector<Node*> &nodes) const
+{
+	std::vector<int> found;
+	int minX = std::max(0, (pos.x - range) / CELL_SIZE), maxX = std::min(_cellsX - 1, (pos.x + range) / CELL_SIZE);
+	int minY = std::max(0, (pos.y - range) / CELL_SIZE), maxY = std::min(_cellsY - 1, (pos.y + range) / CELL_SIZE);
+	for (int z = 0; z < _levels; ++z)
+	{
+		for (int y = minY; y <= maxY; ++y)
+		{
+			for (int x = minX; x <= maxX; ++x)
+			{
+				const std::vector<int> &cell = _cells[(z * _cellsY + y) * _cellsX + x];
+				for (std::vector<int>::const_iterator i = cell.begin(); i != cell.end(); ++i)
+				{
+					Position node = _nodes[*i]->getPosition();
+					if (std::abs(node.x - pos.x) <= range && std::abs(node.y - pos.y) <= range)
+					{
+						found.push_back(*i);
+					}
+				}
+			}
+		}
+	}
+	std::sort(found.begin(), found.end());
+	for (std::vector<int>::const_iterator i = found.begin(); i != found.end(); ++i)
+	{
+		nodes.push_back(_nodes[*i]);
+	}
+}
+
+}
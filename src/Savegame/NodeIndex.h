@@ -0,0 +1,68 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include "../Battlescape/Position.h"
+
+namespace OpenXcom
+{
+
+class Node;
+
+/**
+ * Lookups into the nodes of a battle map. Nodes are bucketed
+ * by the kind of unit allowed on them (small or large, flying or
+ * walking) and by rank, and placed in a coarse grid for distance
+ * queries. Only covers the fixed parts of a node, whether it's
+ * free, safe or occupied is still checked by the caller.
+ * Every list keeps the nodes in their original order.
+ */
+class NodeIndex
+{
+private:
+	static const int CELL_SIZE = 10;
+	static const int UNIT_CLASSES = 4;
+	std::vector<Node*> _nodes;
+	std::vector<Node*> _byClass[UNIT_CLASSES];
+	std::vector<std::vector<Node*> > _byRank[UNIT_CLASSES];
+	std::vector<Node*> _none;
+	std::vector<std::vector<int> > _cells;
+	int _cellsX, _cellsY, _levels;
+	/// Gets the bucket of units of a size and movement.
+	static int getUnitClass(int size, bool flying);
+	/// Gets the grid cell of a map position.
+	int getCell(int x, int y, int z) const;
+public:
+	/// Indexes the nodes of a map.
+	NodeIndex(const std::vector<Node*> &nodes, int mapsize_x, int mapsize_y, int mapsize_z);
+	/// Cleans up the node index.
+	~NodeIndex();
+	/// Gets the number of nodes indexed, dummies included.
+	size_t size() const { return _nodes.size(); }
+	/// Gets the nodes a unit fits on.
+	const std::vector<Node*> &getNodes(int size, bool flying) const;
+	/// Gets the nodes of a rank a unit fits on.
+	const std::vector<Node*> &getNodes(int size, bool flying, int rank) const;
+	/// Gets the closest node a unit fits on, on the same level.
+	Node *getNearestNode(Position pos, int size) const;
+	/// Gets the nodes within a horizontal range.
+	void getNodesInRange(Position pos, int range, std::vector<Node*> &nodes) const;
+};
+
+}
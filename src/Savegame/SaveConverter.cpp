@@ -750,6 +750,7 @@ void SaveConverter::loadDatBase()
 					base->getFacilities()->push_back(facility);
 				}
 			}
+			base->updateCapacities();
 			int engineers = load<Uint8>(bdata + _rules->getOffset("BASE.DAT_ENGINEERS"));
 			int scientists = load<Uint8>(bdata + _rules->getOffset("BASE.DAT_SCIENTISTS"));
 			// items
@@ -17,12 +17,15 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <assert.h>
+#include <algorithm>
 #include <vector>
+#include <SDL_thread.h>
 #include "BattleItem.h"
 #include "SavedBattleGame.h"
 #include "SavedGame.h"
 #include "Tile.h"
 #include "Node.h"
+#include "NodeIndex.h"
 #include "../Mod/MapDataSet.h"
 #include "../Mod/MCDPatch.h"
 #include "../Battlescape/Pathfinding.h"
@@ -44,10 +47,157 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// What a tile spreads to a neighbour.
+enum SpreadType { SPREAD_FIRE, SPREAD_SMOKE, SPREAD_FIRE_SMOKE };
+
+/// Fire or smoke spread to a neighbour, gathered before any is applied.
+struct SpreadEffect
+{
+	Tile *tile;
+	int power;
+	SpreadType type;
+};
+
+/// A share of the spreading tiles, gathered on its own thread.
+struct SpreadJob
+{
+	SavedBattleGame *save;
+	const std::vector<Tile*> *tiles;
+	size_t begin, end;
+	bool smoke;
+	std::vector<SpreadEffect> effects;
+};
+
+/// Spreading tiles needed before gathering is split over threads.
+const size_t PARALLEL_SPREAD_TILES = 2048;
+/// Threads gathering is split over.
+const size_t SPREAD_THREADS = 4;
+
+/**
+ * Sorts tiles in the same order as the map.
+ */
+bool beforeTile(const Tile *a, const Tile *b)
+{
+	Position pa = a->getPosition(), pb = b->getPosition();
+	if (pa.z != pb.z) return pa.z < pb.z;
+	if (pa.y != pb.y) return pa.y < pb.y;
+	return pa.x < pb.x;
+}
+
+/**
+ * Adds the effects of a tile on its four cardinal neighbours,
+ * as long as no wall blocks the way.
+ */
+void spreadAround(SpreadJob *job, Tile *tile, ItemDamageType type, int power, SpreadType spread)
+{
+	for (int dir = 0; dir <= 6; dir += 2)
+	{
+		Position pos;
+		Pathfinding::directionToVector(dir, &pos);
+		Tile *t = job->save->getTile(tile->getPosition() + pos);
+		if (t && job->save->getTileEngine()->horizontalBlockage(tile, t, type) == 0)
+		{
+			SpreadEffect effect = { t, power, spread };
+			job->effects.push_back(effect);
+		}
+	}
+}
+
+/**
+ * Gathers what a share of the tiles spreads to their neighbours. Only reads
+ * the map as it was before anything spreads, so shares can run in parallel.
+ * @param data Pointer to the SpreadJob.
+ * @return Always 0.
+ */
+int gatherSpread(void *data)
+{
+	SpreadJob *job = (SpreadJob*)data;
+	for (size_t i = job->begin; i != job->end; ++i)
+	{
+		Tile *tile = (*job->tiles)[i];
+		if (!job->smoke)
+		{
+			// fires that keep burning try to set their neighbours on fire
+			if (tile->getFire() > 1)
+			{
+				spreadAround(job, tile, DT_IN, tile->getSmoke(), SPREAD_FIRE);
+			}
+		}
+		else if (tile->getFire() == 0)
+		{
+			// smoke that keeps smoking spreads what is left of it
+			if (tile->getSmoke() > 1)
+			{
+				spreadAround(job, tile, DT_SMOKE, tile->getSmoke() - 1, SPREAD_SMOKE);
+			}
+		}
+		else
+		{
+			// smoke from fire spreads upwards one level if there's no floor blocking it.
+			Tile *t = job->save->getTile(tile->getPosition() + Position(0,0,1));
+			if (t && t->hasNoFloor(tile))
+			{
+				// only add smoke equal to half the intensity of the fire
+				SpreadEffect effect = { t, tile->getSmoke()/2, SPREAD_FIRE_SMOKE };
+				job->effects.push_back(effect);
+			}
+			// then it spreads in the four cardinal directions.
+			spreadAround(job, tile, DT_SMOKE, tile->getSmoke()/2, SPREAD_FIRE_SMOKE);
+		}
+	}
+	return 0;
+}
+
+/**
+ * Gathers what the tiles spread, split over threads on big fires.
+ * The effects always come out in the order of the tiles.
+ * @param save Pointer to the battle.
+ * @param tiles Spreading tiles.
+ * @param smoke Spread smoke instead of fire.
+ * @param effects Receives the effects.
+ */
+void gatherSpread(SavedBattleGame *save, const std::vector<Tile*> &tiles, bool smoke, std::vector<SpreadEffect> &effects)
+{
+	size_t threads = tiles.size() < PARALLEL_SPREAD_TILES ? 1 : SPREAD_THREADS;
+	std::vector<SpreadJob> jobs(threads);
+	std::vector<SDL_Thread*> handles(threads, (SDL_Thread*)0);
+	for (size_t i = 0; i < threads; ++i)
+	{
+		jobs[i].save = save;
+		jobs[i].tiles = &tiles;
+		jobs[i].begin = tiles.size() * i / threads;
+		jobs[i].end = tiles.size() * (i + 1) / threads;
+		jobs[i].smoke = smoke;
+		if (i != 0)
+		{
+			handles[i] = SDL_CreateThread(gatherSpread, &jobs[i]);
+		}
+	}
+	gatherSpread(&jobs[0]);
+	for (size_t i = 0; i < threads; ++i)
+	{
+		if (handles[i] != 0)
+		{
+			SDL_WaitThread(handles[i], 0);
+		}
+		else if (i != 0)
+		{
+			// couldn't start the thread, do it here instead
+			gatherSpread(&jobs[i]);
+		}
+		effects.insert(effects.end(), jobs[i].effects.begin(), jobs[i].effects.end());
+	}
+}
+
+}
+
 /**
  * Initializes a brand new battlescape saved game.
  */
-SavedBattleGame::SavedBattleGame() : _battleState(0), _mapsize_x(0), _mapsize_y(0), _mapsize_z(0), _selectedUnit(0), _lastSelectedUnit(0), _pathfinding(0), _tileEngine(0), _globalShade(0),
+SavedBattleGame::SavedBattleGame() : _battleState(0), _mapsize_x(0), _mapsize_y(0), _mapsize_z(0), _selectedUnit(0), _lastSelectedUnit(0), _nodeIndex(0), _pathfinding(0), _tileEngine(0), _globalShade(0),
 	_side(FACTION_PLAYER), _turn(1), _debugMode(false), _aborted(false), _itemId(0), _objectiveType(-1), _objectivesDestroyed(0), _objectivesNeeded(0), _unitsFalling(false), _cheating(false),
 	_tuReserved(BA_NONE), _kneelReserved(false), _depth(0), _ambience(-1), _ambientVolume(0.5), _turnLimit(0), _cheatTurn(20), _chronoTrigger(FORCE_LOSE), _beforeGame(true)
 {
@@ -75,13 +225,14 @@ SavedBattleGame::~SavedBattleGame()
 
 	for (std::vector<MapDataSet*>::iterator i = _mapDataSets.begin(); i != _mapDataSets.end(); ++i)
 	{
-		(*i)->unloadData();
+		(*i)->releaseData();
 	}
 
 	for (std::vector<Node*>::iterator i = _nodes.begin(); i != _nodes.end(); ++i)
 	{
 		delete *i;
 	}
+	delete _nodeIndex;
 
 	for (std::vector<BattleUnit*>::iterator i = _units.begin(); i != _units.end(); ++i)
 	{
@@ -173,6 +324,10 @@ void SavedBattleGame::load(const YAML::Node &node, Mod *mod, SavedGame* savedGam
 			r += serKey.totalBytes-serKey.index; // r is now incremented strictly by totalBytes in case there are obsolete fields present in the data
 		}
 	}
+	for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+	{
+		trackFireAndSmoke(_tiles[i]);
+	}
 	if (_missionType == "STR_BASE_DEFENSE")
 	{
 		if (node["moduleMap"])
@@ -363,17 +518,17 @@ void SavedBattleGame::loadMapResources(Mod *mod)
 	}
 
 	initUtilities(mod);
-	getTileEngine()->calculateSunShading();
-	getTileEngine()->calculateTerrainLighting();
-	getTileEngine()->calculateUnitLighting();
+	getTileEngine()->calculateLighting();
 	getTileEngine()->recalculateFOV();
 }
 
 /**
  * Saves the saved battle game to a YAML file.
+ * @param tiles Include the tiles? Without them the caller has to add
+ * the totalTiles and binTiles entries from saveTiles() itself.
  * @return YAML node.
  */
-YAML::Node SavedBattleGame::save() const
+YAML::Node SavedBattleGame::save(bool tiles) const
 {
 	YAML::Node node;
 	if (_objectivesNeeded)
@@ -411,25 +566,13 @@ YAML::Node SavedBattleGame::save() const
 	node["tileSetIDSize"] = Tile::serializationKey._mapDataSetID;
 	node["tileBoolFieldsSize"] = Tile::serializationKey.boolFields;
 
-	size_t tileDataSize = Tile::serializationKey.totalBytes * _mapsize_z * _mapsize_y * _mapsize_x;
-	Uint8* tileData = (Uint8*) calloc(tileDataSize, 1);
-	Uint8* w = tileData;
-
-	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
+	if (tiles)
 	{
-		if (!_tiles[i]->isVoid())
-		{
-			serializeInt(&w, Tile::serializationKey.index, i);
-			_tiles[i]->saveBinary(&w);
-		}
-		else
-		{
-			tileDataSize -= Tile::serializationKey.totalBytes;
-		}
+		std::vector<Uint8> tileData;
+		saveTiles(tileData);
+		node["totalTiles"] = tileData.size() / Tile::serializationKey.totalBytes; // not strictly necessary, just convenient
+		node["binTiles"] = YAML::Binary(tileData.empty() ? 0 : &tileData[0], tileData.size());
 	}
-	node["totalTiles"] = tileDataSize / Tile::serializationKey.totalBytes; // not strictly necessary, just convenient
-	node["binTiles"] = YAML::Binary(tileData, tileDataSize);
-	free(tileData);
 #endif
 	for (std::vector<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
 	{
@@ -468,6 +611,32 @@ YAML::Node SavedBattleGame::save() const
 	return node;
 }
 
+/**
+ * Packs the non-void tiles of the map into their binary save format,
+ * each one prefixed by its index. The buffer keeps its capacity, so
+ * saving into the same one again doesn't allocate.
+ * @param data Buffer to pack the tiles into.
+ */
+void SavedBattleGame::saveTiles(std::vector<Uint8> &data) const
+{
+	data.resize(Tile::serializationKey.totalBytes * _mapsize_z * _mapsize_y * _mapsize_x);
+	if (data.empty())
+	{
+		return;
+	}
+	Uint8* w = &data[0];
+
+	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
+	{
+		if (!_tiles[i]->isVoid())
+		{
+			serializeInt(&w, Tile::serializationKey.index, i);
+			_tiles[i]->saveBinary(&w);
+		}
+	}
+	data.resize(w - &data[0]);
+}
+
 /**
  * Gets the array of tiles.
  * @return A pointer to the Tile array.
@@ -500,6 +669,8 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z, bool
 		delete *i;
 	}
 	_nodes.clear();
+	delete _nodeIndex;
+	_nodeIndex = 0;
 
 	if (resetTerrain)
 	{
@@ -517,7 +688,9 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z, bool
 		getTileCoords(i, &pos.x, &pos.y, &pos.z);
 		_tiles[i] = new Tile(pos);
 	}
-
+	_fireAndSmokeTiles.clear();
+	_fireAndSmokeIndexes.assign(_mapsize_z * _mapsize_y * _mapsize_x, false);
+	_dangerousTiles.clear();
 }
 
 /**
@@ -757,6 +930,21 @@ std::vector<Node*> *SavedBattleGame::getNodes()
 	return &_nodes;
 }
 
+/**
+ * Gets the lookups into the list of nodes, indexing
+ * them again if any were added since.
+ * @return Pointer to the node index.
+ */
+const NodeIndex *SavedBattleGame::getNodeIndex()
+{
+	if (_nodeIndex == 0 || _nodeIndex->size() != _nodes.size())
+	{
+		delete _nodeIndex;
+		_nodeIndex = new NodeIndex(_nodes, _mapsize_x, _mapsize_y, _mapsize_z);
+	}
+	return _nodeIndex;
+}
+
 /**
  * Gets the list of units.
  * @return Pointer to the list of units.
@@ -1175,17 +1363,11 @@ Node *SavedBattleGame::getSpawnNode(int nodeRank, BattleUnit *unit)
 	int highestPriority = -1;
 	std::vector<Node*> compliantNodes;
 
-	for (std::vector<Node*>::iterator i = getNodes()->begin(); i != getNodes()->end(); ++i)
+	// ranks must match, the small and flying unit bits must fit the unit
+	const std::vector<Node*> &nodes = getNodeIndex()->getNodes(unit->getArmor()->getSize(), unit->getMovementType() == MT_FLY, nodeRank);
+	for (std::vector<Node*>::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
 	{
-		if ((*i)->isDummy())
-		{
-			continue;
-		}
-		if ((*i)->getRank() == nodeRank								// ranks must match
-			&& (!((*i)->getType() & Node::TYPE_SMALL)
-				|| unit->getArmor()->getSize() == 1)				// the small unit bit is not set or the unit is small
-			&& (!((*i)->getType() & Node::TYPE_FLYING)
-				|| unit->getMovementType() == MT_FLY)				// the flying unit bit is not set or the unit can fly
+		if ((*i)->getPriority() >= highestPriority					// lower priorities would be dropped anyway
 			&& (*i)->getPriority() > 0								// priority 0 is no spawnplace
 			&& setUnitPosition(unit, (*i)->getPosition(), true))	// check if not already occupied
 		{
@@ -1230,25 +1412,27 @@ Node *SavedBattleGame::getPatrolNode(bool scout, BattleUnit *unit, Node *fromNod
 		}
 	}
 
-	// scouts roam all over while all others shuffle around to adjacent nodes at most:
-	const int end = scout ? getNodes()->size() : fromNode->getNodeLinks()->size();
+	// scouts roam all over the nodes they fit on while all others shuffle around to adjacent nodes at most:
+	const std::vector<Node*> &scoutNodes = getNodeIndex()->getNodes(unit->getArmor()->getSize(), unit->getMovementType() == MT_FLY);
+	const int end = scout ? scoutNodes.size() : fromNode->getNodeLinks()->size();
 
 	for (int i = 0; i < end; ++i)
 	{
 		if (!scout && fromNode->getNodeLinks()->at(i) < 1) continue;
 
-		Node *n = getNodes()->at(scout ? i : fromNode->getNodeLinks()->at(i));
+		Node *n = scout ? scoutNodes[i] : getNodes()->at(fromNode->getNodeLinks()->at(i));
+		// the cheap checks go first, the occupancy test is the slow one
 		if ( !n->isDummy()																				// don't consider dummy nodes.
 			&& (n->getFlags() > 0 || n->getRank() > 0 || scout)											// for non-scouts we find a node with a desirability above 0
 			&& (!(n->getType() & Node::TYPE_SMALL) || unit->getArmor()->getSize() == 1)					// the small unit bit is not set or the unit is small
 			&& (!(n->getType() & Node::TYPE_FLYING) || unit->getMovementType() == MT_FLY)				// the flying unit bit is not set or the unit can fly
 			&& !n->isAllocated()																		// check if not allocated
 			&& !(n->getType() & Node::TYPE_DANGEROUS)													// don't go there if an alien got shot there; stupid behavior like that
-			&& setUnitPosition(unit, n->getPosition(), true)											// check if not already occupied
+			&& (!scout || n != fromNode)																// scouts push forward
+			&& n->getPosition().x > 0 && n->getPosition().y > 0
 			&& getTile(n->getPosition()) && !getTile(n->getPosition())->getFire()						// you are not a firefighter; do not patrol into fire
 			&& (unit->getFaction() != FACTION_HOSTILE || !getTile(n->getPosition())->getDangerous())	// aliens don't run into a grenade blast
-			&& (!scout || n != fromNode)																// scouts push forward
-			&& n->getPosition().x > 0 && n->getPosition().y > 0)
+			&& setUnitPosition(unit, n->getPosition(), true))											// check if not already occupied
 		{
 			if (!preferred
 				|| (unit->getRankInt() >=0 &&
@@ -1293,155 +1477,183 @@ Node *SavedBattleGame::getPatrolNode(bool scout, BattleUnit *unit, Node *fromNod
  */
 void SavedBattleGame::prepareNewTurn()
 {
-	std::vector<Tile*> tilesOnFire;
-	std::vector<Tile*> tilesOnSmoke;
+	std::vector<Tile*> tiles;
+	std::vector<SpreadEffect> effects;
+	bool lightChanged = false;
 
-	// prepare a list of tiles on fire
-	for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+	// prepare a list of tiles on fire, ignoring fire added this turn
+	sortFireAndSmokeTiles();
+	for (std::vector<Tile*>::iterator i = _fireAndSmokeTiles.begin(); i != _fireAndSmokeTiles.end(); ++i)
 	{
-		if (getTiles()[i]->getFire() > 0)
+		if ((*i)->getFire() > 0 && (*i)->getOverlaps() == 0)
 		{
-			tilesOnFire.push_back(getTiles()[i]);
+			tiles.push_back(*i);
 		}
 	}
 
-	// first: fires spread
-	for (std::vector<Tile*>::iterator i = tilesOnFire.begin(); i != tilesOnFire.end(); ++i)
+	// first: fires spread, all of them from the map as it was before
+	gatherSpread(this, tiles, false, effects);
+	for (std::vector<Tile*>::iterator i = tiles.begin(); i != tiles.end(); ++i)
 	{
-		// if we haven't added fire here this turn
-		if ((*i)->getOverlaps() == 0)
-		{
-			// reduce the fire timer
-			(*i)->setFire((*i)->getFire() -1);
+		// reduce the fire timer
+		(*i)->setFire((*i)->getFire() -1);
 
-			// if we're still burning
-			if ((*i)->getFire())
+		// fire has burnt out
+		if ((*i)->getFire() == 0)
+		{
+			lightChanged = true;
+			(*i)->setSmoke(0);
+			// burn this tile, and any object in it, if it's not fireproof/indestructible.
+			if ((*i)->getMapData(O_OBJECT))
 			{
-				// propagate in four cardinal directions (0, 2, 4, 6)
-				for (int dir = 0; dir <= 6; dir += 2)
+				if ((*i)->getMapData(O_OBJECT)->getFlammable() != 255 && (*i)->getMapData(O_OBJECT)->getArmor() != 255)
 				{
-					Position pos;
-					Pathfinding::directionToVector(dir, &pos);
-					Tile *t = getTile((*i)->getPosition() + pos);
-					// if there's no wall blocking the path of the flames...
-					if (t && getTileEngine()->horizontalBlockage((*i), t, DT_IN) == 0)
+					if ((*i)->destroy(O_OBJECT, getObjectiveType()))
 					{
-						// attempt to set this tile on fire
-						t->ignite((*i)->getSmoke());
+						addDestroyedObjective();
 					}
-				}
-			}
-			// fire has burnt out
-			else
-			{
-				(*i)->setSmoke(0);
-				// burn this tile, and any object in it, if it's not fireproof/indestructible.
-				if ((*i)->getMapData(O_OBJECT))
-				{
-					if ((*i)->getMapData(O_OBJECT)->getFlammable() != 255 && (*i)->getMapData(O_OBJECT)->getArmor() != 255)
+					if ((*i)->destroy(O_FLOOR, getObjectiveType()))
 					{
-						if ((*i)->destroy(O_OBJECT, getObjectiveType()))
-						{
-							addDestroyedObjective();
-						}
-						if ((*i)->destroy(O_FLOOR, getObjectiveType()))
-						{
-							addDestroyedObjective();
-						}
+						addDestroyedObjective();
 					}
 				}
-				else if ((*i)->getMapData(O_FLOOR))
+			}
+			else if ((*i)->getMapData(O_FLOOR))
+			{
+				if ((*i)->getMapData(O_FLOOR)->getFlammable() != 255 && (*i)->getMapData(O_FLOOR)->getArmor() != 255)
 				{
-					if ((*i)->getMapData(O_FLOOR)->getFlammable() != 255 && (*i)->getMapData(O_FLOOR)->getArmor() != 255)
+					if ((*i)->destroy(O_FLOOR, getObjectiveType()))
 					{
-						if ((*i)->destroy(O_FLOOR, getObjectiveType()))
-						{
-							addDestroyedObjective();
-						}
+						addDestroyedObjective();
 					}
 				}
-				getTileEngine()->applyGravity(*i);
 			}
+			getTileEngine()->applyGravity(*i);
+		}
+	}
+	for (std::vector<SpreadEffect>::iterator i = effects.begin(); i != effects.end(); ++i)
+	{
+		// attempt to set this tile on fire
+		bool burning = i->tile->getFire() != 0;
+		i->tile->ignite(i->power);
+		if (!burning && i->tile->getFire() != 0)
+		{
+			lightChanged = true;
+			trackFireAndSmoke(i->tile);
 		}
 	}
 
+	// the danger zones only last until the next turn
+	for (std::vector<Tile*>::iterator i = _dangerousTiles.begin(); i != _dangerousTiles.end(); ++i)
+	{
+		(*i)->setDangerous(false);
+	}
+	_dangerousTiles.clear();
+
 	// prepare a list of tiles on fire/with smoke in them (smoke acts as fire intensity)
-	for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+	sortFireAndSmokeTiles();
+	tiles.clear();
+	effects.clear();
+	for (std::vector<Tile*>::iterator i = _fireAndSmokeTiles.begin(); i != _fireAndSmokeTiles.end(); ++i)
 	{
-		if (getTiles()[i]->getSmoke() > 0)
+		if ((*i)->getSmoke() > 0)
 		{
-			tilesOnSmoke.push_back(getTiles()[i]);
+			tiles.push_back(*i);
 		}
-		getTiles()[i]->setDangerous(false);
 	}
 
-	// now make the smoke spread.
-	for (std::vector<Tile*>::iterator i = tilesOnSmoke.begin(); i != tilesOnSmoke.end(); ++i)
+	// now make the smoke spread, again from the map as it was before.
+	gatherSpread(this, tiles, true, effects);
+	for (std::vector<Tile*>::iterator i = tiles.begin(); i != tiles.end(); ++i)
 	{
 		// smoke and fire follow slightly different rules.
 		if ((*i)->getFire() == 0)
 		{
 			// reduce the smoke counter
 			(*i)->setSmoke((*i)->getSmoke() - 1);
-			// if we're still smoking
-			if ((*i)->getSmoke())
-			{
-				// spread in four cardinal directions
-				for (int dir = 0; dir <= 6; dir += 2)
-				{
-					Position pos;
-					Pathfinding::directionToVector(dir, &pos);
-					Tile *t = getTile((*i)->getPosition() + pos);
-					// as long as there are no walls blocking us
-					if (t && getTileEngine()->horizontalBlockage((*i), t, DT_SMOKE) == 0)
-					{
-						// only add smoke to empty tiles, or tiles with no fire, and smoke that was added this turn
-						if (t->getSmoke() == 0 || (t->getFire() == 0 && t->getOverlaps() != 0))
-						{
-							t->addSmoke((*i)->getSmoke());
-						}
-					}
-				}
-			}
 		}
-		else
+	}
+	for (std::vector<SpreadEffect>::iterator i = effects.begin(); i != effects.end(); ++i)
+	{
+		Tile *t = i->tile;
+		// smoke from smoke is only added to empty tiles, or tiles with no fire, and smoke that was added this turn
+		if (i->type == SPREAD_FIRE_SMOKE || t->getSmoke() == 0 || (t->getFire() == 0 && t->getOverlaps() != 0))
 		{
-			// smoke from fire spreads upwards one level if there's no floor blocking it.
-			Position pos = Position(0,0,1);
-			Tile *t = getTile((*i)->getPosition() + pos);
-			if (t && t->hasNoFloor(*i))
-			{
-				// only add smoke equal to half the intensity of the fire
-				t->addSmoke((*i)->getSmoke()/2);
-			}
-			// then it spreads in the four cardinal directions.
-			for (int dir = 0; dir <= 6; dir += 2)
-			{
-				Pathfinding::directionToVector(dir, &pos);
-				t = getTile((*i)->getPosition() + pos);
-				if (t && getTileEngine()->horizontalBlockage((*i), t, DT_SMOKE) == 0)
-				{
-					t->addSmoke((*i)->getSmoke()/2);
-				}
-			}
+			t->addSmoke(i->power);
+			trackFireAndSmoke(t);
 		}
 	}
 
-	if (!tilesOnFire.empty() || !tilesOnSmoke.empty())
+	// do damage to units, average out the smoke, etc.
+	sortFireAndSmokeTiles();
+	for (std::vector<Tile*>::iterator i = _fireAndSmokeTiles.begin(); i != _fireAndSmokeTiles.end(); ++i)
+	{
+		if ((*i)->getSmoke() != 0)
+			(*i)->prepareNewTurn(getDepth() == 0);
+	}
+
+	// fires could have been started or stopped, smoke doesn't light anything up.
+	// the units' FOV is recalculated at the end of the turn anyway.
+	if (lightChanged)
 	{
-		// do damage to units, average out the smoke, etc.
-		for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
-		{
-			if (getTiles()[i]->getSmoke() != 0)
-				getTiles()[i]->prepareNewTurn(getDepth() == 0);
-		}
-		// fires could have been started, stopped or smoke could reveal/conceal units.
 		getTileEngine()->calculateTerrainLighting();
 	}
 
 	reviveUnconsciousUnits();
 }
 
+/**
+ * Starts tracking a tile that may have caught fire or smoke, so
+ * it spreads at the next turn without searching the whole map.
+ * Tiles without either are dropped again by the next turn.
+ * @param tile Pointer to the tile.
+ */
+void SavedBattleGame::trackFireAndSmoke(Tile *tile)
+{
+	int index = getTileIndex(tile->getPosition());
+	if ((tile->getFire() || tile->getSmoke()) && !_fireAndSmokeIndexes[index])
+	{
+		_fireAndSmokeIndexes[index] = true;
+		_fireAndSmokeTiles.push_back(tile);
+	}
+}
+
+/**
+ * Drops the tracked tiles whose fire and smoke are gone,
+ * and sorts the rest in map order so they spread in the
+ * same order every time.
+ */
+void SavedBattleGame::sortFireAndSmokeTiles()
+{
+	std::vector<Tile*>::iterator last = _fireAndSmokeTiles.begin();
+	for (std::vector<Tile*>::iterator i = _fireAndSmokeTiles.begin(); i != _fireAndSmokeTiles.end(); ++i)
+	{
+		if ((*i)->getFire() || (*i)->getSmoke())
+		{
+			*last++ = *i;
+		}
+		else
+		{
+			_fireAndSmokeIndexes[getTileIndex((*i)->getPosition())] = false;
+		}
+	}
+	_fireAndSmokeTiles.erase(last, _fireAndSmokeTiles.end());
+	std::sort(_fireAndSmokeTiles.begin(), _fireAndSmokeTiles.end(), beforeTile);
+}
+
+/**
+ * Marks a tile as dangerous, eg. by a primed grenade, until the next turn.
+ * @param tile Pointer to the tile.
+ */
+void SavedBattleGame::addDangerousTile(Tile *tile)
+{
+	if (!tile->getDangerous())
+	{
+		tile->setDangerous(true);
+		_dangerousTiles.push_back(tile);
+	}
+}
+
 /**
  * Checks for units that are unconscious and revives them if they shouldn't be.
  *
@@ -1580,8 +1792,7 @@ bool SavedBattleGame::eyesOnTarget(UnitFaction faction, BattleUnit* unit)
 	{
 		if ((*i)->getFaction() != faction) continue;
 
-		std::vector<BattleUnit*> *vis = (*i)->getVisibleUnits();
-		if (std::find(vis->begin(), vis->end(), unit) != vis->end()) return true;
+		if ((*i)->hasVisibleUnit(unit)) return true;
 		// aliens know the location of all XCom agents sighted by all other aliens due to sharing locations over their space-walkie-talkies
 	}
 
@@ -30,6 +30,7 @@ class Tile;
 class SavedGame;
 class MapDataSet;
 class Node;
+class NodeIndex;
 class BattlescapeState;
 class Position;
 class Pathfinding;
@@ -53,6 +54,7 @@ private:
 	Tile **_tiles;
 	BattleUnit *_selectedUnit, *_lastSelectedUnit;
 	std::vector<Node*> _nodes;
+	NodeIndex *_nodeIndex;
 	std::vector<BattleUnit*> _units;
 	std::vector<BattleItem*> _items, _deleted;
 	Pathfinding *_pathfinding;
@@ -79,6 +81,10 @@ private:
 	int _turnLimit, _cheatTurn;
 	ChronoTrigger _chronoTrigger;
 	bool _beforeGame;
+	std::vector<Tile*> _fireAndSmokeTiles, _dangerousTiles;
+	std::vector<bool> _fireAndSmokeIndexes;
+	/// Drops tiles without fire or smoke and sorts the rest in map order.
+	void sortFireAndSmokeTiles();
 	/// Selects a soldier.
 	BattleUnit *selectPlayerUnit(int dir, bool checkReselect = false, bool setReselect = false, bool checkInventory = false);
 public:
@@ -89,7 +95,9 @@ public:
 	/// Loads a saved battle game from YAML.
 	void load(const YAML::Node& node, Mod *mod, SavedGame* savedGame);
 	/// Saves a saved battle game to YAML.
-	YAML::Node save() const;
+	YAML::Node save(bool tiles = true) const;
+	/// Packs the tiles of the map for saving.
+	void saveTiles(std::vector<Uint8> &data) const;
 	/// Sets the dimensions of the map and initializes it.
 	void initMap(int mapsize_x, int mapsize_y, int mapsize_z, bool resetTerrain = true);
 	/// Initialises the pathfinding and tileengine.
@@ -108,6 +116,8 @@ public:
 	Tile **getTiles() const;
 	/// Gets a pointer to the list of nodes.
 	std::vector<Node*> *getNodes();
+	/// Gets the lookups into the list of nodes.
+	const NodeIndex *getNodeIndex();
 	/// Gets a pointer to the list of items.
 	std::vector<BattleItem*> *getItems();
 	/// Gets a pointer to the list of units.
@@ -199,6 +209,10 @@ public:
 	Node *getPatrolNode(bool scout, BattleUnit *unit, Node *fromNode);
 	/// Carries out new turn preparations.
 	void prepareNewTurn();
+	/// Tracks a tile that may have caught fire or smoke.
+	void trackFireAndSmoke(Tile *tile);
+	/// Marks a tile as dangerous until the next turn.
+	void addDangerousTile(Tile *tile);
 	/// Revives unconscious units (healthcheck).
 	void reviveUnconsciousUnits();
 	/// Removes the body item that corresponds to the unit.
@@ -22,6 +22,7 @@
 #include <iomanip>
 #include <algorithm>
 #include <yaml-cpp/yaml.h>
+#include <SDL_thread.h>
 #include "../version.h"
 #include "../Engine/Logger.h"
 #include "../Mod/Mod.h"
@@ -31,6 +32,7 @@
 #include "../Engine/Options.h"
 #include "../Engine/CrossPlatform.h"
 #include "SavedBattleGame.h"
+#include "Tile.h"
 #include "SerializationHelper.h"
 #include "GameTime.h"
 #include "Country.h"
@@ -64,12 +66,12 @@ const std::string SavedGame::AUTOSAVE_GEOSCAPE = "_autogeo_.asav",
 struct findRuleResearch : public std::unary_function<ResearchProject *,
 								bool>
 {
-	RuleResearch * _toFind;
-	findRuleResearch(RuleResearch * toFind);
+	const RuleResearch * _toFind;
+	findRuleResearch(const RuleResearch * toFind);
 	bool operator()(const ResearchProject *r) const;
 };
 
-findRuleResearch::findRuleResearch(RuleResearch * toFind) : _toFind(toFind)
+findRuleResearch::findRuleResearch(const RuleResearch * toFind) : _toFind(toFind)
 {
 }
 
@@ -78,6 +80,107 @@ bool findRuleResearch::operator()(const ResearchProject *r) const
 	return _toFind == r->getRules();
 }
 
+namespace
+{
+
+/**
+ * Snapshot of a game ready to be written to disk.
+ */
+struct SaveJob
+{
+	std::string filename, path;
+	YAML::Node brief, node;
+	bool battle;
+	std::vector<Uint8> tiles;
+	std::string error;
+	SaveJob() : battle(false) {}
+};
+
+// one job gets written in the background while the next is filled in
+SaveJob saveJobs[2];
+int nextSaveJob = 0;
+SaveJob *pendingSave = 0;
+SDL_Thread *saveThread = 0;
+
+/**
+ * Writes a game snapshot to its file, through a temp file
+ * so a failed save doesn't wipe the previous one.
+ * @param job Snapshot to write.
+ */
+void writeSave(SaveJob &job)
+{
+	if (job.battle)
+	{
+		// the tiles are only base64 encoded now, off the game thread for background saves
+		YAML::Node battle = job.node["battleGame"];
+		battle["totalTiles"] = job.tiles.size() / Tile::serializationKey.totalBytes;
+		battle["binTiles"] = YAML::Binary(job.tiles.empty() ? 0 : &job.tiles[0], job.tiles.size());
+	}
+	YAML::Emitter out;
+	out << job.brief;
+	out << YAML::BeginDoc;
+	out << job.node;
+
+	// Save to temp
+	// If this goes wrong, the original save will be safe
+	std::string tmpPath = job.path + ".tmp";
+	std::ofstream tmp(tmpPath.c_str());
+	if (!tmp)
+	{
+		throw Exception("Failed to save " + job.filename);
+	}
+	tmp << out.c_str();
+	tmp.close();
+	if (!tmp)
+	{
+		throw Exception("Failed to save " + job.filename);
+	}
+
+	// If temp went fine, save for real
+	// If this goes wrong, they will have the temp
+	std::ofstream sav(job.path.c_str());
+	if (!sav)
+	{
+		throw Exception("Failed to save " + job.filename);
+	}
+	sav << out.c_str();
+	sav.close();
+	if (!sav)
+	{
+		throw Exception("Failed to save " + job.filename);
+	}
+
+	// Everything went fine, delete the temp
+	// We don't care if this fails
+	CrossPlatform::deleteFile(tmpPath);
+}
+
+/**
+ * Thread function writing a game snapshot in the background.
+ * Errors are kept until the save is waited on.
+ * @param data Pointer to the SaveJob.
+ * @return Always 0.
+ */
+int writeSaveThread(void *data)
+{
+	SaveJob *job = (SaveJob*)data;
+	try
+	{
+		writeSave(*job);
+	}
+	catch (Exception &e)
+	{
+		job->error = e.what();
+	}
+	catch (YAML::Exception &e)
+	{
+		job->error = e.what();
+	}
+	return 0;
+}
+
+}
+
 struct equalProduction : public std::unary_function<Production *,
 							bool>
 {
@@ -115,6 +218,7 @@ SavedGame::SavedGame() : _difficulty(DIFF_BEGINNER), _end(END_NONE), _ironman(fa
  */
 SavedGame::~SavedGame()
 {
+	waitForSave();
 	delete _time;
 	for (std::vector<Country*>::iterator i = _countries.begin(); i != _countries.end(); ++i)
 	{
@@ -217,6 +321,7 @@ static bool _isCurrentGameType(const SaveInfo &saveInfo, const std::string &curM
  */
 std::vector<SaveInfo> SavedGame::getList(Language *lang, bool autoquick)
 {
+	waitForSave();
 	std::vector<SaveInfo> info;
 	std::string curMaster = Options::getActiveMaster();
 	std::vector<std::string> saves = CrossPlatform::getFolderContents(Options::getMasterUserFolder(), "sav");
@@ -330,6 +435,7 @@ SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
  */
 void SavedGame::load(const std::string &filename, Mod *mod)
 {
+	waitForSave();
 	std::string s = Options::getMasterUserFolder() + filename;
 	std::vector<YAML::Node> file = YAML::LoadAllFromFile(s);
 	if (file.empty())
@@ -496,7 +602,7 @@ void SavedGame::load(const std::string &filename, Mod *mod)
 		std::string research = it->as<std::string>();
 		if (mod->getResearch(research))
 		{
-			_discovered.push_back(mod->getResearch(research));
+			discover(mod->getResearch(research));
 		}
 		else
 		{
@@ -557,22 +663,21 @@ void SavedGame::load(const std::string &filename, Mod *mod)
 
 /**
  * Saves a saved game's contents to a YAML file.
+ * A background save only takes a snapshot of the game here, the
+ * encoding and writing to disk happen on another thread while the
+ * game goes on. Errors of a background save only get logged.
  * @param filename YAML filename.
+ * @param background Write the file in the background?
  */
-void SavedGame::save(const std::string &filename) const
+void SavedGame::save(const std::string &filename, bool background) const
 {
-	std::string savPath = Options::getMasterUserFolder() + filename;
-	std::string tmpPath = savPath + ".tmp";
-	std::ofstream tmp(tmpPath.c_str());
-	if (!tmp)
-	{
-		throw Exception("Failed to save " + filename);
-	}
-
-	YAML::Emitter out;
+	SaveJob job;
+	SaveJob &snapshot = background ? saveJobs[nextSaveJob] : job;
+	snapshot.filename = filename;
+	snapshot.path = Options::getMasterUserFolder() + filename;
 
 	// Saves the brief game info used in the saves list
-	YAML::Node brief;
+	YAML::Node &brief = snapshot.brief;
 	brief["name"] = _name;
 	brief["version"] = OPENXCOM_VERSION_SHORT;
 	std::string git_sha = OPENXCOM_VERSION_GIT;
@@ -598,10 +703,8 @@ void SavedGame::save(const std::string &filename) const
 	brief["mods"] = modsList;
 	if (_ironman)
 		brief["ironman"] = _ironman;
-	out << brief;
 	// Saves the full game data to the save
-	out << YAML::BeginDoc;
-	YAML::Node node;
+	YAML::Node &node = snapshot.node;
 	node["difficulty"] = (int)_difficulty;
 	node["end"] = (int)_end;
 	node["monthsPassed"] = _monthsPassed;
@@ -674,38 +777,60 @@ void SavedGame::save(const std::string &filename) const
 			node["missionStatistics"].push_back((*i)->save());
 		}
 	}
-	if (_battleGame != 0)
+	snapshot.battle = background && _battleGame != 0;
+	if (snapshot.battle)
+	{
+		// only pack the tiles, they get encoded with the rest of the file
+		node["battleGame"] = _battleGame->save(false);
+		_battleGame->saveTiles(snapshot.tiles);
+	}
+	else if (_battleGame != 0)
 	{
 		node["battleGame"] = _battleGame->save();
 	}
-	out << node;
 
-	// Save to temp
-	// If this goes wrong, the original save will be safe
-	tmp << out.c_str();
-	tmp.close();
-	if (!tmp)
+	// the previous background save might be writing the same file
+	waitForSave();
+	if (background)
 	{
-		throw Exception("Failed to save " + filename);
+		pendingSave = &snapshot;
+		nextSaveJob = 1 - nextSaveJob;
+		saveThread = SDL_CreateThread(writeSaveThread, pendingSave);
+		if (saveThread == 0)
+		{
+			writeSaveThread(pendingSave);
+			waitForSave();
+		}
+	}
+	else
+	{
+		writeSave(snapshot);
 	}
+}
 
-	// If temp went fine, save for real
-	// If this goes wrong, they will have the temp
-	std::ofstream sav(savPath.c_str());
-	if (!sav)
+/**
+ * Waits for the game being saved in the background to be written,
+ * so the file is complete before it gets read or written again.
+ */
+void SavedGame::waitForSave()
+{
+	if (pendingSave == 0)
 	{
-		throw Exception("Failed to save " + filename);
+		return;
 	}
-	sav << out.c_str();
-	sav.close();
-	if (!sav)
+	if (saveThread != 0)
 	{
-		throw Exception("Failed to save " + filename);
+		SDL_WaitThread(saveThread, 0);
+		saveThread = 0;
 	}
-
-	// Everything went fine, delete the temp
-	// We don't care if this fails
-	CrossPlatform::deleteFile(tmpPath);
+	if (!pendingSave->error.empty())
+	{
+		Log(LOG_ERROR) << pendingSave->error;
+		pendingSave->error.clear();
+	}
+	pendingSave->brief.reset();
+	pendingSave->node.reset();
+	pendingSave = 0;
 }
 
 /**
@@ -1104,8 +1229,60 @@ void SavedGame::setBattleGame(SavedBattleGame *battleGame)
  * @param research The newly found ResearchProject
  */
 void SavedGame::addFinishedResearchSimple(const RuleResearch * research)
+{
+	discover(research);
+}
+
+/**
+ * Adds a research topic to the discovered research and
+ * updates the research it unlocks, so later checks are
+ * just looking up indexes.
+ * @param research The newly found research.
+ */
+void SavedGame::discover(const RuleResearch *research)
 {
 	_discovered.push_back(research);
+	_researchedNames.insert(research->getName());
+	if (research->getIndex() >= _researched.size())
+	{
+		_researched.resize(research->getIndex() + 1, false);
+	}
+	_researched[research->getIndex()] = true;
+	for (std::vector<const RuleResearch*>::const_iterator i = research->getUnlockedRules().begin(); i != research->getUnlockedRules().end(); ++i)
+	{
+		if ((*i)->getIndex() >= _unlocked.size())
+		{
+			_unlocked.resize((*i)->getIndex() + 1, false);
+		}
+		_unlocked[(*i)->getIndex()] = true;
+	}
+}
+
+/**
+ * Returns if a research topic has been discovered.
+ * @param research The research topic, can be null.
+ * @return Whether it's discovered or not.
+ */
+bool SavedGame::isDiscovered(const RuleResearch *research) const
+{
+	return research != 0 && research->getIndex() < _researched.size() && _researched[research->getIndex()];
+}
+
+/**
+ * Returns if all of a list of research topics have been discovered.
+ * @param research The research topics, missing topics are null.
+ * @return Whether they're all discovered or not.
+ */
+bool SavedGame::isDiscovered(const std::vector<const RuleResearch*> &research) const
+{
+	for (std::vector<const RuleResearch*>::const_iterator i = research.begin(); i != research.end(); ++i)
+	{
+		if (!isDiscovered(*i))
+		{
+			return false;
+		}
+	}
+	return true;
 }
 
 /**
@@ -1119,7 +1296,9 @@ void SavedGame::addFinishedResearch(const RuleResearch * research, const Mod * m
 {
 	// Not really a queue in C++ terminology (we don't need or want pop_front())
 	std::vector<const RuleResearch *> queue;
+	std::set<const RuleResearch *> queued;
 	queue.push_back(research);
+	queued.insert(research);
 
 	size_t currentQueueIndex = 0;
 	while (queue.size() > currentQueueIndex)
@@ -1131,9 +1310,9 @@ void SavedGame::addFinishedResearch(const RuleResearch * research, const Mod * m
 
 		// 2. If the currentQueueItem was *not* already discovered before, add it to discovered research
 		bool checkRelatedZeroCostTopics = true;
-		if (!isResearched(currentQueueItem->getName(), false))
+		if (!isDiscovered(currentQueueItem))
 		{
-			_discovered.push_back(currentQueueItem);
+			discover(currentQueueItem);
 			if (!hasUndiscoveredProtectedUnlocks && isResearched(currentQueueItem->getGetOneFree(), false))
 			{
 				// If the currentQueueItem can't tell you anything anymore, remove it from popped research
@@ -1161,58 +1340,36 @@ void SavedGame::addFinishedResearch(const RuleResearch * research, const Mod * m
 		// process all related zero-cost topics
 		if (checkRelatedZeroCostTopics)
 		{
-			// 3a. Gather all available research projects
-			std::vector<RuleResearch *> availableResearch;
-			if (base)
-			{
-				// Note: even if two different but related projects are finished in two different bases at the same time,
-				// the algorithm is robust enough to treat them *sequentially* (i.e. as if one was researched first and the other second),
-				// thus calling this method for *one* base only is enough
-				getAvailableResearchProjects(availableResearch, mod, base);
-			}
-			else
+			// 3a. Go through the zero-cost research projects only, they're the only ones that matter here
+			// Note: even if two different but related projects are finished in two different bases at the same time,
+			// the algorithm is robust enough to treat them *sequentially* (i.e. as if one was researched first and the other second),
+			// thus checking *one* base only is enough (no base is used in the vanilla save converter only)
+			const std::vector<RuleResearch*> &allResearch = mod->getResearchRules();
+			for (std::vector<RuleResearch*>::const_iterator itProjectToTest = allResearch.begin(); itProjectToTest != allResearch.end(); ++itProjectToTest)
 			{
-				// Used in vanilla save converter only
-				getAvailableResearchProjects(availableResearch, mod, 0);
-			}
+				// We are only interested in *new* zero-cost projects (i.e. not processed or scheduled for processing yet)
+				if ((*itProjectToTest)->getCost() != 0 || queued.find(*itProjectToTest) != queued.end())
+				{
+					continue;
+				}
 
-			// 3b. Iterate through all available projects and add zero-cost projects to the processing queue
-			for (std::vector<RuleResearch*>::const_iterator itProjectToTest = availableResearch.begin(); itProjectToTest != availableResearch.end(); ++itProjectToTest)
-			{
-				// We are only interested in zero-cost projects!
-				if ((*itProjectToTest)->getCost() == 0)
+				// 3b. Add available ones to the processing queue
+				if (!isResearchAvailable(*itProjectToTest, mod, base, false))
+				{
+					continue;
+				}
+				const std::vector<const RuleResearch*> &unlocks = currentQueueItem->getUnlockedRules();
+				if ((*itProjectToTest)->getRequirements().empty())
+				{
+					// no additional checks for "unprotected" topics
+					queue.push_back((*itProjectToTest));
+					queued.insert((*itProjectToTest));
+				}
+				else if (std::find(unlocks.begin(), unlocks.end(), *itProjectToTest) != unlocks.end())
 				{
-					// We are only interested in *new* projects (i.e. not processed or scheduled for processing yet)
-					bool isAlreadyInTheQueue = false;
-					for (std::vector<const RuleResearch *>::const_iterator itQueue = queue.begin(); itQueue != queue.end(); ++itQueue)
-					{
-						if ((*itQueue)->getName() == (*itProjectToTest)->getName())
-						{
-							isAlreadyInTheQueue = true;
-							break;
-						}
-					}
-
-					if (!isAlreadyInTheQueue)
-					{
-						if ((*itProjectToTest)->getRequirements().empty())
-						{
-							// no additional checks for "unprotected" topics
-							queue.push_back((*itProjectToTest));
-						}
-						else
-						{
-							// for "protected" topics, we need to check if the currentQueueItem can unlock it or not
-							for (std::vector<std::string>::const_iterator itUnlocks = currentQueueItem->getUnlocked().begin(); itUnlocks != currentQueueItem->getUnlocked().end(); ++itUnlocks)
-							{
-								if ((*itProjectToTest)->getName() == (*itUnlocks))
-								{
-									queue.push_back((*itProjectToTest));
-									break;
-								}
-							}
-						}
-					}
+					// for "protected" topics, we need to check if the currentQueueItem can unlock it or not
+					queue.push_back((*itProjectToTest));
+					queued.insert((*itProjectToTest));
 				}
 			}
 		}
@@ -1240,91 +1397,99 @@ const std::vector<const RuleResearch *> & SavedGame::getDiscoveredResearch() con
  */
 void SavedGame::getAvailableResearchProjects(std::vector<RuleResearch *> & projects, const Mod * mod, Base * base, bool considerDebugMode) const
 {
-	// This list is used for topics that can be researched even if *not all* dependencies have been discovered yet (e.g. STR_ALIEN_ORIGINS)
-	// Note: all requirements of such topics *have to* be discovered though! This will be handled elsewhere.
-	std::vector<const RuleResearch *> unlocked;
-	for (std::vector<const RuleResearch *>::const_iterator it = _discovered.begin(); it != _discovered.end(); ++it)
+	// Create a list of research topics available for research in the given base
+	const std::vector<RuleResearch*> &allResearch = mod->getResearchRules();
+	for (std::vector<RuleResearch*>::const_iterator iter = allResearch.begin(); iter != allResearch.end(); ++iter)
 	{
-		for (std::vector<std::string>::const_iterator itUnlocked = (*it)->getUnlocked().begin(); itUnlocked != (*it)->getUnlocked().end(); ++itUnlocked)
+		if (isResearchAvailable(*iter, mod, base, considerDebugMode))
 		{
-			unlocked.push_back(mod->getResearch(*itUnlocked, true));
+			projects.push_back(*iter);
 		}
 	}
+}
 
-	// Create a list of research topics available for research in the given base
-	for (std::vector<std::string>::const_iterator iter = mod->getResearchList().begin(); iter != mod->getResearchList().end(); ++iter)
+/**
+ * Checks if a research topic can be researched in a Base.
+ * @param research The research topic.
+ * @param mod the game Mod
+ * @param base a pointer to a Base
+ * @param considerDebugMode Should debug mode be considered or not.
+ * @return Whether it's available or not.
+ */
+bool SavedGame::isResearchAvailable(const RuleResearch *research, const Mod *mod, Base *base, bool considerDebugMode) const
+{
+	bool debug = considerDebugMode && _debug;
+	// Topics on the "unlocked list" can be researched even if *not all* dependencies have been discovered yet (e.g. STR_ALIEN_ORIGINS)
+	// Note: all requirements of such topics *have to* be discovered though! This will be handled below.
+	bool unlocked = research->getIndex() < _unlocked.size() && _unlocked[research->getIndex()];
+	if (debug || unlocked)
+	{
+		// Empty, these research topics are on the "unlocked list", *don't* check the dependencies!
+	}
+	else
 	{
-		RuleResearch *research = mod->getResearch(*iter);
+		// These items are not on the "unlocked list", we must check if "dependencies" are satisfied!
+		if (!isDiscovered(research->getDependencyRules()))
+		{
+			return false;
+		}
+	}
 
-		if ((considerDebugMode && _debug) || std::find(unlocked.begin(), unlocked.end(), research) != unlocked.end())
+	// Check if "requires" are satisfied
+	// IMPORTANT: research topics with "requires" will NEVER be directly visible to the player anyway
+	//   - there is an additional filter in NewResearchListState::fillProjectList(), see comments there for more info
+	//   - there is an additional filter in NewPossibleResearchState::NewPossibleResearchState()
+	//   - we do this check for other functionality using this method, namely SavedGame::addFinishedResearch()
+	//     - Note: when called from there, parameter considerDebugMode = false
+	if (!debug && !isDiscovered(research->getRequirementRules()))
+	{
+		return false;
+	}
+
+	// Remove the already researched topics from the list *UNLESS* they can still give you something more
+	if (isDiscovered(research))
+	{
+		if (!isResearched(research->getGetOneFree(), false))
 		{
-			// Empty, these research topics are on the "unlocked list", *don't* check the dependencies!
+			// This research topic still has some more undiscovered "getOneFree" topics, keep it!
 		}
-		else
+		else if (hasUndiscoveredProtectedUnlock(research, mod))
 		{
-			// These items are not on the "unlocked list", we must check if "dependencies" are satisfied!
-			if (!isResearched(research->getDependencies(), considerDebugMode))
-			{
-				continue;
-			}
+			// This research topic still has one or more undiscovered "protected unlocks", keep it!
 		}
-
-		// Check if "requires" are satisfied
-		// IMPORTANT: research topics with "requires" will NEVER be directly visible to the player anyway
-		//   - there is an additional filter in NewResearchListState::fillProjectList(), see comments there for more info
-		//   - there is an additional filter in NewPossibleResearchState::NewPossibleResearchState()
-		//   - we do this check for other functionality using this method, namely SavedGame::addFinishedResearch()
-		//     - Note: when called from there, parameter considerDebugMode = false
-		if (!isResearched(research->getRequirements(), considerDebugMode))
+		else
 		{
-			continue;
+			// This topic can't give you anything else anymore, ignore it!
+			return false;
 		}
+	}
 
-		// Remove the already researched topics from the list *UNLESS* they can still give you something more
-		if (isResearched(research->getName(), false))
+	if (base)
+	{
+		// Check if this topic is already being researched in the given base
+		const std::vector<ResearchProject *> & baseResearchProjects = base->getResearch();
+		if (std::find_if(baseResearchProjects.begin(), baseResearchProjects.end(), findRuleResearch(research)) != baseResearchProjects.end())
 		{
-			if (!isResearched(research->getGetOneFree(), false))
-			{
-				// This research topic still has some more undiscovered "getOneFree" topics, keep it!
-			}
-			else if (hasUndiscoveredProtectedUnlock(research, mod))
-			{
-				// This research topic still has one or more undiscovered "protected unlocks", keep it!
-			}
-			else
-			{
-				// This topic can't give you anything else anymore, ignore it!
-				continue;
-			}
+			return false;
 		}
 
-		if (base)
+		// Check for needed item in the given base
+		if (research->needItem() && base->getStorageItems()->getItem(research->getName()) == 0)
 		{
-			// Check if this topic is already being researched in the given base
-			const std::vector<ResearchProject *> & baseResearchProjects = base->getResearch();
-			if (std::find_if(baseResearchProjects.begin(), baseResearchProjects.end(), findRuleResearch(research)) != baseResearchProjects.end())
-			{
-				continue;
-			}
-
-			// Check for needed item in the given base
-			if (research->needItem() && base->getStorageItems()->getItem(research->getName()) == 0)
-			{
-				continue;
-			}
+			return false;
 		}
-		else
+	}
+	else
+	{
+		// Used in vanilla save converter only
+		if (research->needItem() && research->getCost() == 0)
 		{
-			// Used in vanilla save converter only
-			if (research->needItem() && research->getCost() == 0)
-			{
-				continue;
-			}
+			return false;
 		}
-
-		// Haleluja, all checks passed, add the research topic to the list
-		projects.push_back(research);
 	}
+
+	// Haleluja, all checks passed
+	return true;
 }
 
 /**
@@ -1387,14 +1552,12 @@ void SavedGame::getAvailableProductions (std::vector<RuleManufacture *> & produc
  */
 void SavedGame::getDependableManufacture (std::vector<RuleManufacture *> & dependables, const RuleResearch *research, const Mod * mod, Base *) const
 {
-	const std::vector<std::string> &mans = mod->getManufactureList();
-	for (std::vector<std::string>::const_iterator iter = mans.begin(); iter != mans.end(); ++iter)
+	const std::vector<RuleManufacture*> &mans = mod->getManufactureRequiring(research);
+	for (std::vector<RuleManufacture*>::const_iterator iter = mans.begin(); iter != mans.end(); ++iter)
 	{
-		RuleManufacture *m = mod->getManufacture(*iter);
-		const std::vector<std::string> &reqs = m->getRequirements();
-		if (isResearched(m->getRequirements()) && std::find(reqs.begin(), reqs.end(), research->getName()) != reqs.end())
+		if (isResearched((*iter)->getRequirements()))
 		{
-			dependables.push_back(m);
+			dependables.push_back(*iter);
 		}
 	}
 }
@@ -1408,12 +1571,11 @@ void SavedGame::getDependableManufacture (std::vector<RuleManufacture *> & depen
 bool SavedGame::hasUndiscoveredProtectedUnlock(const RuleResearch * r, const Mod * mod) const
 {
 	// Note: checking for not yet discovered unlocks protected by "requires" (which also implies cost = 0)
-	for (std::vector<std::string>::const_iterator itUnlocked = r->getUnlocked().begin(); itUnlocked != r->getUnlocked().end(); ++itUnlocked)
+	for (std::vector<const RuleResearch*>::const_iterator itUnlocked = r->getUnlockedRules().begin(); itUnlocked != r->getUnlockedRules().end(); ++itUnlocked)
 	{
-		RuleResearch *unlock = mod->getResearch(*itUnlocked, true);
-		if (!unlock->getRequirements().empty())
+		if (!(*itUnlocked)->getRequirements().empty())
 		{
-			if (!isResearched(unlock->getName(), false))
+			if (!isDiscovered(*itUnlocked))
 			{
 				return true;
 			}
@@ -1434,13 +1596,7 @@ bool SavedGame::isResearched(const std::string &research, bool considerDebugMode
 	//	return true;
 	if (considerDebugMode && _debug)
 		return true;
-	for (std::vector<const RuleResearch *>::const_iterator i = _discovered.begin(); i != _discovered.end(); ++i)
-	{
-		if ((*i)->getName() == research)
-			return true;
-	}
-
-	return false;
+	return _researchedNames.find(research) != _researchedNames.end();
 }
 
 /**
@@ -1455,22 +1611,13 @@ bool SavedGame::isResearched(const std::vector<std::string> &research, bool cons
 		return true;
 	if (considerDebugMode && _debug)
 		return true;
-	std::vector<std::string> matches = research;
-	for (std::vector<const RuleResearch *>::const_iterator i = _discovered.begin(); i != _discovered.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = research.begin(); i != research.end(); ++i)
 	{
-		for (std::vector<std::string>::iterator j = matches.begin(); j != matches.end(); ++j)
-		{
-			if ((*i)->getName() == *j)
-			{
-				j = matches.erase(j);
-				break;
-			}
-		}
-		if (matches.empty())
-			return true;
+		if (_researchedNames.find(*i) == _researchedNames.end())
+			return false;
 	}
 
-	return false;
+	return true;
 }
 
 /**
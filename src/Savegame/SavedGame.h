@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <map>
+#include <set>
 #include <vector>
 #include <string>
 #include <time.h>
@@ -119,6 +120,8 @@ private:
 	AlienStrategy *_alienStrategy;
 	SavedBattleGame *_battleGame;
 	std::vector<const RuleResearch*> _discovered;
+	std::vector<bool> _researched, _unlocked;
+	std::set<std::string> _researchedNames;
 	std::vector<AlienMission*> _activeMissions;
 	bool _debug, _warned;
 	int _monthsPassed;
@@ -132,6 +135,14 @@ private:
 	std::vector<MissionStatistics*> _missionStatistics;
 
 	static SaveInfo getSaveInfo(const std::string &file, Language *lang);
+	/// Adds a research topic to the discovered research.
+	void discover(const RuleResearch *research);
+	/// Checks if a research topic has been discovered.
+	bool isDiscovered(const RuleResearch *research) const;
+	/// Checks if a list of research topics has been discovered.
+	bool isDiscovered(const std::vector<const RuleResearch*> &research) const;
+	/// Checks if a research topic can be researched in a Base.
+	bool isResearchAvailable(const RuleResearch *research, const Mod *mod, Base *base, bool considerDebugMode) const;
 public:
 	static const std::string AUTOSAVE_GEOSCAPE, AUTOSAVE_BATTLESCAPE, QUICKSAVE;
 	/// Creates a new saved game.
@@ -145,7 +156,9 @@ public:
 	/// Loads a saved game from YAML.
 	void load(const std::string &filename, Mod *mod);
 	/// Saves a saved game to YAML.
-	void save(const std::string &filename) const;
+	void save(const std::string &filename, bool background = false) const;
+	/// Waits for a save being written in the background.
+	static void waitForSave();
 	/// Gets the game name.
 	std::string getName() const;
 	/// Sets the game name.
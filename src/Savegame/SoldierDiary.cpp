@@ -26,6 +26,31 @@
 namespace OpenXcom
 {
 
+/**
+ * Finds the statistics of a mission by its id.
+ * Ids are handed out in the order missions are recorded, so
+ * the id is the mission's index; only fall back to a search
+ * if the list doesn't follow that order.
+ * @param missionStatistics Mission Statistics.
+ * @param id Mission id.
+ * @return Pointer to the mission's statistics, or 0 if not found.
+ */
+static MissionStatistics *findMissionStatistics(std::vector<MissionStatistics*> *missionStatistics, int id)
+{
+	if (id >= 0 && (size_t)id < missionStatistics->size() && missionStatistics->at(id)->id == id)
+	{
+		return missionStatistics->at(id);
+	}
+	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
+	{
+		if ((*i)->id == id)
+		{
+			return *i;
+		}
+	}
+	return 0;
+}
+
 /**
  * Initializes a new blank diary.
  */
@@ -35,7 +60,9 @@ SoldierDiary::SoldierDiary() : _daysWoundedTotal(0), _totalShotByFriendlyCounter
 	_timesWoundedTotal(0), _KIA(0), _allAliensKilledTotal(0), _allAliensStunnedTotal(0), _woundsHealedTotal(0), _allUFOs(0), _allMissionTypes(0),
 	_statGainTotal(0), _revivedUnitTotal(0), _wholeMedikitTotal(0), _braveryGainTotal(0), _bestOfRank(0),
 	_MIA(0), _martyrKillsTotal(0), _postMortemKills(0), _slaveKillsTotal(0), _bestSoldier(false),
-    _revivedSoldierTotal(0), _revivedHostileTotal(0), _revivedNeutralTotal(0), _globeTrotter(false)
+    _revivedSoldierTotal(0), _revivedHostileTotal(0), _revivedNeutralTotal(0), _globeTrotter(false),
+	_killTotal(0), _stunTotal(0), _missionTotalsCached(false), _winTotal(0), _scoreTotal(0), _terrorMissionTotal(0), _nightMissionTotal(0),
+	_nightTerrorMissionTotal(0), _baseDefenseMissionTotal(0), _alienBaseAssaultTotal(0), _importantMissionTotal(0), _valiantCruxTotal(0), _lootValueTotal(0)
 {
 }
 
@@ -80,9 +107,13 @@ void SoldierDiary::load(const YAML::Node& node, const Mod *mod)
 	if (const YAML::Node &killList = node["killList"])
 	{
 		for (YAML::const_iterator i = killList.begin(); i != killList.end(); ++i)
+		{
 			_killList.push_back(new BattleUnitKills(*i));
+			addKillTotals(_killList.back());
+		}
 	}
 	_missionIdList = node["missionIdList"].as<std::vector<int> >(_missionIdList);
+	_missionTotalsCached = false;
 	_daysWoundedTotal = node["daysWoundedTotal"].as<int>(_daysWoundedTotal);
 	_totalShotByFriendlyCounter = node["totalShotByFriendlyCounter"].as<int>(_totalShotByFriendlyCounter);
 	_totalShotFriendlyCounter = node["totalShotFriendlyCounter"].as<int>(_totalShotFriendlyCounter);
@@ -182,6 +213,7 @@ void SoldierDiary::updateDiary(BattleUnitStatistics *unitStatistics, std::vector
 	{
 		(*kill)->makeTurnUnique();
 		_killList.push_back(*kill);
+		addKillTotals(*kill);
 	}
 	unitKills.clear();
 	if (missionStatistics->success)
@@ -245,6 +277,8 @@ void SoldierDiary::updateDiary(BattleUnitStatistics *unitStatistics, std::vector
 	_revivedNeutralTotal += unitStatistics->revivedNeutral;
 	_revivedHostileTotal += unitStatistics->revivedHostile;
 	_wholeMedikitTotal += std::min( std::min(unitStatistics->woundsHealed, unitStatistics->appliedStimulant), unitStatistics->appliedPainKill);
+	if (_missionTotalsCached)
+		addMissionTotals(missionStatistics);
 	_missionIdList.push_back(missionStatistics->id);
 }
 
@@ -264,12 +298,7 @@ std::vector<SoldierCommendations*> *SoldierDiary::getSoldierCommendations()
  */
 bool SoldierDiary::manageCommendations(Mod *mod, std::vector<MissionStatistics*> *missionStatistics)
 {
-	const int BATTLE_TYPES = 13;
-	const int DAMAGE_TYPES = 11;
-	const std::string battleTypeArray[BATTLE_TYPES] = { "BT_NONE", "BT_FIREARM", "BT_AMMO", "BT_MELEE", "BT_GRENADE",	"BT_PROXIMITYGRENADE", "BT_MEDIKIT", "BT_SCANNER", "BT_MINDPROBE", "BT_PSIAMP", "BT_FLARE", "BT_CORPSE", "BT_END" };
-	const std::string damageTypeArray[DAMAGE_TYPES] = { "DT_NONE", "DT_AP", "DT_IN", "DT_HE", "DT_LASER", "DT_PLASMA", "DT_STUN", "DT_MELEE", "DT_ACID", "DT_SMOKE", "DT_END"};
-
-	const std::map<std::string, RuleCommendations *> commendationsList = mod->getCommendationsList();
+	const std::map<std::string, RuleCommendations *> &commendationsList = mod->getCommendationsList();
 	bool awardedCommendation = false;                   // This value is returned if at least one commendation was given.
 	std::map<std::string, int> nextCommendationLevel;   // Noun, threshold.
 	std::vector<std::string> modularCommendations;      // Commendation name.
@@ -290,94 +319,47 @@ bool SoldierDiary::manageCommendations(Mod *mod, std::vector<MissionStatistics*>
 				nextCommendationLevel[(*j)->getNoun()] = (*j)->getDecorationLevelInt() + 1;
 			}
 		}
+		const int noNounLevel = nextCommendationLevel["noNoun"];
+		const std::vector<std::pair<CommendationCriterion, std::vector<int> > > &criteriaList = (*i).second->getCompiledCriteria();
 		// Go through each possible criteria. Assume the medal is awarded, set to false if not.
 		// As soon as we find a medal criteria that we FAIL TO achieve, then we are not awarded a medal.
-		for (std::map<std::string, std::vector<int> >::const_iterator j = (*i).second->getCriteria()->begin(); j != (*i).second->getCriteria()->end(); ++j)
+		for (std::vector<std::pair<CommendationCriterion, std::vector<int> > >::const_iterator j = criteriaList.begin(); j != criteriaList.end(); ++j)
 		{
 			// Skip this medal if we have reached its max award level.
-			if ((unsigned int)nextCommendationLevel["noNoun"] >= (*j).second.size())
-			{
-				awardCommendationBool = false;
-				break;
-			}
-			// These criteria have no nouns, so only the nextCommendationLevel["noNoun"] will ever be used.
-			else if( nextCommendationLevel.count("noNoun") == 1 &&
-				  ( ((*j).first == "totalKills" && (unsigned int)getKillTotal() < (unsigned int)(*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalMissions" && _missionIdList.size() < (unsigned int)(*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalWins" && getWinTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalScore" && getScoreTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalStuns" && getStunTotal() < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalDaysWounded" && _daysWoundedTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalBaseDefenseMissions" && getBaseDefenseMissionTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalTerrorMissions" && getTerrorMissionTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalNightMissions" && getNightMissionTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalNightTerrorMissions" && getNightTerrorMissionTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalMonthlyService" && _monthsService < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalFellUnconcious" && _unconciousTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalShotAt10Times" && _shotAtCounter10in1Mission < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalHit5Times" && _hitCounter5in1Mission < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalFriendlyFired" && (_totalShotByFriendlyCounter < (*j).second.at(nextCommendationLevel["noNoun"]) || _KIA || _MIA)) ||
-					((*j).first == "total_lone_survivor" && _loneSurvivorTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalIronMan" && _ironManTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalImportantMissions" && getImportantMissionTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalLongDistanceHits" && _longDistanceHitCounterTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalLowAccuracyHits" && _lowAccuracyHitCounterTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalReactionFire" && getReactionFireKillTotal(mod) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalTimesWounded" && _timesWoundedTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalDaysWounded" && _daysWoundedTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalValientCrux" && getValiantCruxTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "isDead" && _KIA < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalTrapKills" && getTrapKillTotal(mod) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalAlienBaseAssaults" && getAlienBaseAssaultTotal(missionStatistics) < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalAllAliensKilled" && _allAliensKilledTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalAllAliensStunned" && _allAliensStunnedTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalWoundsHealed" && _woundsHealedTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalAllUFOs" && _allUFOs < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalAllMissionTypes" && _allMissionTypes < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalStatGain" && _statGainTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalRevives" && _revivedUnitTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalSoldierRevives" && _revivedSoldierTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalHostileRevives" && _revivedHostileTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalNeutralRevives" && _revivedNeutralTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalWholeMedikit" && _wholeMedikitTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalBraveryGain" && _braveryGainTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "bestOfRank" && _bestOfRank < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "bestSoldier" && (int)_bestSoldier < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "isMIA" && _MIA < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalMartyrKills" && _martyrKillsTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalPostMortemKills" && _postMortemKills < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "globeTrotter" && (int)_globeTrotter < (*j).second.at(nextCommendationLevel["noNoun"])) ||
-					((*j).first == "totalSlaveKills" && _slaveKillsTotal < (*j).second.at(nextCommendationLevel["noNoun"])) ) )
-
+			if ((unsigned int)noNounLevel >= (*j).second.size())
 			{
 				awardCommendationBool = false;
 				break;
 			}
 			// Medals with the following criteria are unique because they need a noun.
 			// And because they loop over a map<> (this allows for maximum moddability).
-			else if ((*j).first == "totalKillsWithAWeapon" || (*j).first == "totalMissionsInARegion" || (*j).first == "totalKillsByRace" || (*j).first == "totalKillsByRank")
+			else if ((*j).first == CC_TOTAL_KILLS_WITH_A_WEAPON || (*j).first == CC_TOTAL_MISSIONS_IN_A_REGION || (*j).first == CC_TOTAL_KILLS_BY_RACE || (*j).first == CC_TOTAL_KILLS_BY_RANK)
 			{
-				std::map<std::string, int> tempTotal;
-				if ((*j).first == "totalKillsWithAWeapon")
-					tempTotal = getWeaponTotal();
-				else if ((*j).first == "totalMissionsInARegion")
-					tempTotal = getRegionTotal(missionStatistics);
-				else if ((*j).first == "totalKillsByRace")
-					tempTotal = getAlienRaceTotal();
-				else if ((*j).first == "totalKillsByRank")
-					tempTotal = getAlienRankTotal();
-				// Loop over the temporary map.
+				const std::map<std::string, int> *tempTotal;
+				if ((*j).first == CC_TOTAL_KILLS_WITH_A_WEAPON)
+					tempTotal = &_weaponTotal;
+				else if ((*j).first == CC_TOTAL_MISSIONS_IN_A_REGION)
+				{
+					cacheMissionTotals(missionStatistics);
+					tempTotal = &_regionTotal;
+				}
+				else if ((*j).first == CC_TOTAL_KILLS_BY_RACE)
+					tempTotal = &_alienRaceTotal;
+				else
+					tempTotal = &_alienRankTotal;
+				// Loop over the totals.
 				// Match nouns and decoration levels.
-				for(std::map<std::string, int>::const_iterator k = tempTotal.begin(); k != tempTotal.end(); ++k)
+				for(std::map<std::string, int>::const_iterator k = tempTotal->begin(); k != tempTotal->end(); ++k)
 				{
 					int criteria = -1;
-					std::string noun = (*k).first;
+					const std::string &noun = (*k).first;
+					std::map<std::string, int>::const_iterator level = nextCommendationLevel.find(noun);
 					// If there is no matching noun, get the first award criteria.
-					if (nextCommendationLevel.count(noun) == 0)
+					if (level == nextCommendationLevel.end())
 						criteria = (*j).second.front();
 					// Otherwise, get the criteria that reflects the soldier's commendation level.
-					else if ((unsigned int)nextCommendationLevel[noun] != (*j).second.size())
-						criteria = (*j).second.at(nextCommendationLevel[noun]);
+					else if ((unsigned int)level->second != (*j).second.size())
+						criteria = (*j).second.at(level->second);
 
 					// If a criteria was set AND the stat's count exceeds the criteria.
 					if (criteria != -1 && (*k).second >= criteria)
@@ -393,21 +375,20 @@ bool SoldierDiary::manageCommendations(Mod *mod, std::vector<MissionStatistics*>
 				}
 			}
 			// Medals that are based on _how_ a kill was achieved are found here.
-			else if ((*j).first == "killsWithCriteriaCareer" || (*j).first == "killsWithCriteriaMission" || (*j).first == "killsWithCriteriaTurn")
+			else if ((*j).first == CC_KILLS_WITH_CRITERIA_CAREER || (*j).first == CC_KILLS_WITH_CRITERIA_MISSION || (*j).first == CC_KILLS_WITH_CRITERIA_TURN)
 			{
 				// Fetch the kill criteria list.
-				if (!(*i).second->getKillCriteria())
-					break;
-				std::vector<std::vector<std::pair<int, std::vector<std::string> > > > *_killCriteriaList = (*i).second->getKillCriteria();
+				const std::vector<std::vector<std::pair<int, std::vector<CommendationKillDetail> > > > &killCriteriaList = (*i).second->getCompiledKillCriteria();
+				const bool career = (*j).first == CC_KILLS_WITH_CRITERIA_CAREER;
 
 				bool andCriteriaMet = true;
 
 				// Loop over the OR vectors.
-				for (std::vector<std::vector<std::pair<int, std::vector<std::string> > > >::const_iterator orCriteria = _killCriteriaList->begin(); orCriteria != _killCriteriaList->end(); ++orCriteria)
+				for (std::vector<std::vector<std::pair<int, std::vector<CommendationKillDetail> > > >::const_iterator orCriteria = killCriteriaList.begin(); orCriteria != killCriteriaList.end(); ++orCriteria)
 				{
 					andCriteriaMet = true;
 					// Loop over the AND vectors.
-					for (std::vector<std::pair<int, std::vector<std::string> > >::const_iterator andCriteria = orCriteria->begin(); andCriteria != orCriteria->end(); ++andCriteria)
+					for (std::vector<std::pair<int, std::vector<CommendationKillDetail> > >::const_iterator andCriteria = orCriteria->begin(); andCriteria != orCriteria->end(); ++andCriteria)
 					{
 						int detailCount = 0; // How many kills have met the same DETAIL
 						int thisTime = -1; // Time being a turn or a mission.
@@ -415,7 +396,7 @@ bool SoldierDiary::manageCommendations(Mod *mod, std::vector<MissionStatistics*>
 						bool goToNextTime = false;
 						int successionCount = 0; // How many blocks of kills were in the same turn or mission.
 
-						if ((*j).first == "killsWithCriteriaTurn" || (*j).first == "killsWithCriteriaMission")
+						if (!career)
 							detailCount++; // Turns and missions start at 1 because of how thisTime and lastTime work.
 
 						// Loop over the KILLS.
@@ -423,75 +404,66 @@ bool SoldierDiary::manageCommendations(Mod *mod, std::vector<MissionStatistics*>
 						{
 							bool foundMatch = true;
 
-							if ((*j).first == "killsWithCriteriaMission")
+							if ((*j).first == CC_KILLS_WITH_CRITERIA_MISSION)
 							{
 								thisTime = (*singleKill)->mission;
 								if (singleKill != _killList.begin())
 								{
-									--singleKill;
-									lastTime = (*singleKill)->mission;
-									++singleKill;
+									lastTime = (*(singleKill - 1))->mission;
 								}
 							}
-							else if ((*j).first == "killsWithCriteriaTurn")
+							else if ((*j).first == CC_KILLS_WITH_CRITERIA_TURN)
 							{
 								thisTime = (*singleKill)->turn;
 								if (singleKill != _killList.begin())
 								{
-									--singleKill;
-									lastTime = (*singleKill)->turn;
-									++singleKill;
+									lastTime = (*(singleKill - 1))->turn;
 								}
 							}
 							// Skip kill-groups that we already got an award for.
 							// Skip kills that are inbetween turns.
-							if ( thisTime == lastTime && goToNextTime && (*j).first != "killsWithCriteriaCareer")
+							if ( thisTime == lastTime && goToNextTime && !career)
 							{
 								continue;
 							}
-							else if (thisTime != lastTime && (*j).first != "killsWithCriteriaCareer")
+							else if (thisTime != lastTime && !career)
 							{
 								detailCount = 1; // Reset.
 								goToNextTime = false;
 								continue;
 							}
 
-							// Loop over the DETAILs of one AND vector.
-							for (std::vector<std::string>::const_iterator detail = andCriteria->second.begin(); detail != andCriteria->second.end(); ++detail)
+							// See if we find _no_ matches with any criteria. If so, break and try the next kill.
+							RuleItem *weapon = mod->getItem((*singleKill)->weapon);
+							RuleItem *weaponAmmo = mod->getItem((*singleKill)->weaponAmmo);
+							if (andCriteria->second.empty())
 							{
-								int battleType = 0;
-								int damageType = 0;
-
-								for (; battleType != BATTLE_TYPES; ++battleType)
-								{
-									if ((*detail) == battleTypeArray[battleType])
-									{
-										break;
-									}
-								}
-
-								for (; damageType != DAMAGE_TYPES; ++damageType)
+								// Nothing to match against.
+							}
+							else if (weapon == 0 || weaponAmmo == 0)
+							{
+								foundMatch = false;
+							}
+							else
+							{
+								const std::string status = (*singleKill)->getUnitStatusString();
+								const std::string faction = (*singleKill)->getUnitFactionString();
+								const std::string side = (*singleKill)->getUnitSideString();
+								const std::string bodyPart = (*singleKill)->getUnitBodyPartString();
+								// Loop over the DETAILs of one AND vector.
+								for (std::vector<CommendationKillDetail>::const_iterator detail = andCriteria->second.begin(); detail != andCriteria->second.end(); ++detail)
 								{
-									if ((*detail) == damageTypeArray[damageType])
+									if ((*singleKill)->rank != detail->name && (*singleKill)->race != detail->name &&
+										(*singleKill)->weapon != detail->name && (*singleKill)->weaponAmmo != detail->name &&
+										status != detail->name && faction != detail->name &&
+										side != detail->name && bodyPart != detail->name &&
+										weaponAmmo->getDamageType() != detail->damageType && weapon->getBattleType() != detail->battleType)
 									{
+										foundMatch = false;
 										break;
 									}
-								}
-
-								// See if we find _no_ matches with any criteria. If so, break and try the next kill.
-								RuleItem *weapon = mod->getItem((*singleKill)->weapon);
-								RuleItem *weaponAmmo = mod->getItem((*singleKill)->weaponAmmo);
-								if (weapon == 0 || weaponAmmo == 0 ||
-									((*singleKill)->rank != (*detail) && (*singleKill)->race != (*detail) &&
-									 (*singleKill)->weapon != (*detail) && (*singleKill)->weaponAmmo != (*detail) &&
-									 (*singleKill)->getUnitStatusString() != (*detail) && (*singleKill)->getUnitFactionString() != (*detail) &&
-									 (*singleKill)->getUnitSideString() != (*detail) && (*singleKill)->getUnitBodyPartString() != (*detail) &&
-									 weaponAmmo->getDamageType() != damageType && weapon->getBattleType() != battleType))
-								{
-									foundMatch = false;
-									break;
-								}
-							} /// End of DETAIL loop.
+								} /// End of DETAIL loop.
+							}
 							if (foundMatch)
 							{
 								detailCount++;
@@ -508,7 +480,7 @@ bool SoldierDiary::manageCommendations(Mod *mod, std::vector<MissionStatistics*>
 							detailCount = successionCount;
 						}
 						// If _no_ kill met this DETAIL, then the whole AND block is failed. Move to the next OR block.
-						if (detailCount == 0 || detailCount < (*j).second.at(nextCommendationLevel["noNoun"]))
+						if (detailCount == 0 || detailCount < (*j).second.at(noNounLevel))
 						{
 							andCriteriaMet = false;
 							break;
@@ -522,6 +494,12 @@ bool SoldierDiary::manageCommendations(Mod *mod, std::vector<MissionStatistics*>
 					awardCommendationBool = false;
 
 			}
+			// These criteria have no nouns, so only the noNoun level will ever be used.
+			else if (!meetsCriterion((*j).first, (*j).second.at(noNounLevel), mod, missionStatistics))
+			{
+				awardCommendationBool = false;
+				break;
+			}
 		}
 		if (awardCommendationBool)
 		{
@@ -558,6 +536,67 @@ bool SoldierDiary::manageCommendations(Mod *mod, std::vector<MissionStatistics*>
 	return awardedCommendation;
 }
 
+/**
+ * Checks a commendation criterion that doesn't need a noun.
+ * @param criterion The criterion to check.
+ * @param threshold The value needed for the next award level.
+ * @param mod Pointer to the mod.
+ * @param missionStatistics Mission Statistics.
+ * @return Has the soldier reached the threshold?
+ */
+bool SoldierDiary::meetsCriterion(CommendationCriterion criterion, int threshold, Mod *mod, std::vector<MissionStatistics*> *missionStatistics)
+{
+	switch (criterion)
+	{
+	case CC_TOTAL_KILLS: return (unsigned int)getKillTotal() >= (unsigned int)threshold;
+	case CC_TOTAL_MISSIONS: return _missionIdList.size() >= (unsigned int)threshold;
+	case CC_TOTAL_WINS: return getWinTotal(missionStatistics) >= threshold;
+	case CC_TOTAL_SCORE: return getScoreTotal(missionStatistics) >= threshold;
+	case CC_TOTAL_STUNS: return getStunTotal() >= threshold;
+	case CC_TOTAL_DAYS_WOUNDED: return _daysWoundedTotal >= threshold;
+	case CC_TOTAL_BASE_DEFENSE_MISSIONS: return getBaseDefenseMissionTotal(missionStatistics) >= threshold;
+	case CC_TOTAL_TERROR_MISSIONS: return getTerrorMissionTotal(missionStatistics) >= threshold;
+	case CC_TOTAL_NIGHT_MISSIONS: return getNightMissionTotal(missionStatistics) >= threshold;
+	case CC_TOTAL_NIGHT_TERROR_MISSIONS: return getNightTerrorMissionTotal(missionStatistics) >= threshold;
+	case CC_TOTAL_MONTHLY_SERVICE: return _monthsService >= threshold;
+	case CC_TOTAL_FELL_UNCONSCIOUS: return _unconciousTotal >= threshold;
+	case CC_TOTAL_SHOT_AT_10_TIMES: return _shotAtCounter10in1Mission >= threshold;
+	case CC_TOTAL_HIT_5_TIMES: return _hitCounter5in1Mission >= threshold;
+	case CC_TOTAL_FRIENDLY_FIRED: return _totalShotByFriendlyCounter >= threshold && !_KIA && !_MIA;
+	case CC_TOTAL_LONE_SURVIVOR: return _loneSurvivorTotal >= threshold;
+	case CC_TOTAL_IRON_MAN: return _ironManTotal >= threshold;
+	case CC_TOTAL_IMPORTANT_MISSIONS: return getImportantMissionTotal(missionStatistics) >= threshold;
+	case CC_TOTAL_LONG_DISTANCE_HITS: return _longDistanceHitCounterTotal >= threshold;
+	case CC_TOTAL_LOW_ACCURACY_HITS: return _lowAccuracyHitCounterTotal >= threshold;
+	case CC_TOTAL_REACTION_FIRE: return getReactionFireKillTotal(mod) >= threshold;
+	case CC_TOTAL_TIMES_WOUNDED: return _timesWoundedTotal >= threshold;
+	case CC_TOTAL_VALIANT_CRUX: return getValiantCruxTotal(missionStatistics) >= threshold;
+	case CC_IS_DEAD: return _KIA >= threshold;
+	case CC_TOTAL_TRAP_KILLS: return getTrapKillTotal(mod) >= threshold;
+	case CC_TOTAL_ALIEN_BASE_ASSAULTS: return getAlienBaseAssaultTotal(missionStatistics) >= threshold;
+	case CC_TOTAL_ALL_ALIENS_KILLED: return _allAliensKilledTotal >= threshold;
+	case CC_TOTAL_ALL_ALIENS_STUNNED: return _allAliensStunnedTotal >= threshold;
+	case CC_TOTAL_WOUNDS_HEALED: return _woundsHealedTotal >= threshold;
+	case CC_TOTAL_ALL_UFOS: return _allUFOs >= threshold;
+	case CC_TOTAL_ALL_MISSION_TYPES: return _allMissionTypes >= threshold;
+	case CC_TOTAL_STAT_GAIN: return _statGainTotal >= threshold;
+	case CC_TOTAL_REVIVES: return _revivedUnitTotal >= threshold;
+	case CC_TOTAL_SOLDIER_REVIVES: return _revivedSoldierTotal >= threshold;
+	case CC_TOTAL_HOSTILE_REVIVES: return _revivedHostileTotal >= threshold;
+	case CC_TOTAL_NEUTRAL_REVIVES: return _revivedNeutralTotal >= threshold;
+	case CC_TOTAL_WHOLE_MEDIKIT: return _wholeMedikitTotal >= threshold;
+	case CC_TOTAL_BRAVERY_GAIN: return _braveryGainTotal >= threshold;
+	case CC_BEST_OF_RANK: return _bestOfRank >= threshold;
+	case CC_BEST_SOLDIER: return (int)_bestSoldier >= threshold;
+	case CC_IS_MIA: return _MIA >= threshold;
+	case CC_TOTAL_MARTYR_KILLS: return _martyrKillsTotal >= threshold;
+	case CC_TOTAL_POST_MORTEM_KILLS: return _postMortemKills >= threshold;
+	case CC_GLOBE_TROTTER: return (int)_globeTrotter >= threshold;
+	case CC_TOTAL_SLAVE_KILLS: return _slaveKillsTotal >= threshold;
+	default: return true;
+	}
+}
+
 /**
  * Award commendations to the soldier.
  * @param type string
@@ -605,12 +644,7 @@ std::vector<BattleUnitKills*> &SoldierDiary::getKills()
  */
 std::map<std::string, int> SoldierDiary::getAlienRankTotal()
 {
-	std::map<std::string, int> list;
-	for(std::vector<BattleUnitKills*>::const_iterator kill = _killList.begin(); kill != _killList.end(); ++kill)
-	{
-		list[(*kill)->rank]++;
-	}
-	return list;
+	return _alienRankTotal;
 }
 
 /**
@@ -618,12 +652,7 @@ std::map<std::string, int> SoldierDiary::getAlienRankTotal()
  */
 std::map<std::string, int> SoldierDiary::getAlienRaceTotal()
 {
-	std::map<std::string, int> list;
-	for(std::vector<BattleUnitKills*>::const_iterator kill = _killList.begin(); kill != _killList.end(); ++kill)
-	{
-		list[(*kill)->race]++;
-	}
-	return list;
+	return _alienRaceTotal;
 }
 
 /**
@@ -631,13 +660,7 @@ std::map<std::string, int> SoldierDiary::getAlienRaceTotal()
  */
 std::map<std::string, int> SoldierDiary::getWeaponTotal()
 {
-	std::map<std::string, int> list;
-	for(std::vector<BattleUnitKills*>::const_iterator kill = _killList.begin(); kill != _killList.end(); ++kill)
-	{
-		if ((*kill)->faction == FACTION_HOSTILE)
-			list[(*kill)->weapon]++;
-	}
-	return list;
+	return _weaponTotal;
 }
 
 /**
@@ -645,101 +668,47 @@ std::map<std::string, int> SoldierDiary::getWeaponTotal()
  */
 std::map<std::string, int> SoldierDiary::getWeaponAmmoTotal()
 {
-	std::map<std::string, int> list;
-	for(std::vector<BattleUnitKills*>::const_iterator kill = _killList.begin(); kill != _killList.end(); ++kill)
-	{
-		if ((*kill)->faction == FACTION_HOSTILE)
-			list[(*kill)->weaponAmmo]++;
-	}
-	return list;
+	return _weaponAmmoTotal;
 }
 
 /**
  *  Get a map of the amount of missions done in each region.
- *  @param MissionStatistics
+ *  @param missionStatistics Mission Statistics.
  */
-std::map<std::string, int> SoldierDiary::getRegionTotal(std::vector<MissionStatistics*> *missionStatistics) const
+std::map<std::string, int> SoldierDiary::getRegionTotal(std::vector<MissionStatistics*> *missionStatistics)
 {
-	std::map<std::string, int> regionTotal;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				regionTotal[(*i)->region]++;
-			}
-		}
-	}
-
-	return regionTotal;
+	cacheMissionTotals(missionStatistics);
+	return _regionTotal;
 }
 
 /**
  *  Get a map of the amount of missions done in each country.
- *  @param MissionStatistics
+ *  @param missionStatistics Mission Statistics.
  */
-std::map<std::string, int> SoldierDiary::getCountryTotal(std::vector<MissionStatistics*> *missionStatistics) const
+std::map<std::string, int> SoldierDiary::getCountryTotal(std::vector<MissionStatistics*> *missionStatistics)
 {
-	std::map<std::string, int> countryTotal;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				countryTotal[(*i)->country]++;
-			}
-		}
-	}
-
-	return countryTotal;
+	cacheMissionTotals(missionStatistics);
+	return _countryTotal;
 }
 
 /**
  *  Get a map of the amount of missions done in each type.
- *  @param MissionStatistics
+ *  @param missionStatistics Mission Statistics.
  */
-std::map<std::string, int> SoldierDiary::getTypeTotal(std::vector<MissionStatistics*> *missionStatistics) const
+std::map<std::string, int> SoldierDiary::getTypeTotal(std::vector<MissionStatistics*> *missionStatistics)
 {
-	std::map<std::string, int> typeTotal;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				typeTotal[(*i)->type]++;
-			}
-		}
-	}
-
-	return typeTotal;
+	cacheMissionTotals(missionStatistics);
+	return _typeTotal;
 }
 
 /**
  *  Get a map of the amount of missions done in each UFO.
- *  @param MissionStatistics
+ *  @param missionStatistics Mission Statistics.
  */
-std::map<std::string, int> SoldierDiary::getUFOTotal(std::vector<MissionStatistics*> *missionStatistics) const
+std::map<std::string, int> SoldierDiary::getUFOTotal(std::vector<MissionStatistics*> *missionStatistics)
 {
-	std::map<std::string, int> ufoTotal;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				ufoTotal[(*i)->ufo]++;
-			}
-		}
-	}
-
-	return ufoTotal;
+	cacheMissionTotals(missionStatistics);
+	return _ufoTotal;
 }
 
 /**
@@ -747,17 +716,7 @@ std::map<std::string, int> SoldierDiary::getUFOTotal(std::vector<MissionStatisti
  */
 int SoldierDiary::getKillTotal() const
 {
-	int killTotal = 0;
-
-	for (std::vector<BattleUnitKills*>::const_iterator i = _killList.begin(); i != _killList.end(); ++i)
-	{
-		if ((*i)->status == STATUS_DEAD && (*i)->faction == FACTION_HOSTILE)
-		{
-			killTotal++;
-		}
-	}
-
-	return killTotal;
+	return _killTotal;
 }
 
 /**
@@ -769,28 +728,13 @@ int SoldierDiary::getMissionTotal() const
 }
 
 /**
- *  Get the total if wins.
- *  @param Mission Statistics
+ *  Get the total of wins.
+ *  @param missionStatistics Mission Statistics.
  */
-int SoldierDiary::getWinTotal(std::vector<MissionStatistics*> *missionStatistics) const
+int SoldierDiary::getWinTotal(std::vector<MissionStatistics*> *missionStatistics)
 {
-	int winTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success)
-				{
-					winTotal++;
-				}
-			}
-		}
-	}
-
-	return winTotal;
+	cacheMissionTotals(missionStatistics);
+	return _winTotal;
 }
 
 /**
@@ -798,17 +742,7 @@ int SoldierDiary::getWinTotal(std::vector<MissionStatistics*> *missionStatistics
  */
 int SoldierDiary::getStunTotal() const
 {
-	int stunTotal = 0;
-
-	for (std::vector<BattleUnitKills*>::const_iterator i = _killList.begin(); i != _killList.end(); ++i)
-	{
-		if ((*i)->status == STATUS_UNCONSCIOUS && (*i)->faction == FACTION_HOSTILE)
-		{
-			stunTotal++;
-		}
-	}
-
-	return stunTotal;
+	return _stunTotal;
 }
 
 /**
@@ -970,219 +904,180 @@ int SoldierDiary::getTrapKillTotal(Mod *mod) const
 
 /**
  *  Get the total of terror missions.
- *  @param Mission Statistics
+ *  @param missionStatistics Mission Statistics.
  */
-int SoldierDiary::getTerrorMissionTotal(std::vector<MissionStatistics*> *missionStatistics) const
+int SoldierDiary::getTerrorMissionTotal(std::vector<MissionStatistics*> *missionStatistics)
 {
-	/// Not a UFO, not the base, not the alien base or colony
-	int terrorMissionTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success && !(*i)->isBaseDefense() && !(*i)->isUfoMission() && !(*i)->isAlienBase())
-				{
-					terrorMissionTotal++;
-				}
-			}
-		}
-	}
-
-	return terrorMissionTotal;
+	cacheMissionTotals(missionStatistics);
+	return _terrorMissionTotal;
 }
 
 /**
  *  Get the total of night missions.
- *  @param Mission Statistics
+ *  @param missionStatistics Mission Statistics.
  */
-int SoldierDiary::getNightMissionTotal(std::vector<MissionStatistics*> *missionStatistics) const
+int SoldierDiary::getNightMissionTotal(std::vector<MissionStatistics*> *missionStatistics)
 {
-	int nightMissionTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success && (*i)->isDarkness() && !(*i)->isBaseDefense() && !(*i)->isAlienBase())
-				{
-					nightMissionTotal++;
-				}
-			}
-		}
-	}
-
-	return nightMissionTotal;
+	cacheMissionTotals(missionStatistics);
+	return _nightMissionTotal;
 }
 
 /**
  *  Get the total of night terror missions.
- *  @param Mission Statistics
+ *  @param missionStatistics Mission Statistics.
  */
-int SoldierDiary::getNightTerrorMissionTotal(std::vector<MissionStatistics*> *missionStatistics) const
+int SoldierDiary::getNightTerrorMissionTotal(std::vector<MissionStatistics*> *missionStatistics)
 {
-	int nightTerrorMissionTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success && (*i)->isDarkness() && !(*i)->isBaseDefense() && !(*i)->isUfoMission() && !(*i)->isAlienBase())
-				{
-					nightTerrorMissionTotal++;
-				}
-			}
-		}
-	}
-
-	return nightTerrorMissionTotal;
+	cacheMissionTotals(missionStatistics);
+	return _nightTerrorMissionTotal;
 }
 
 /**
  *  Get the total of base defense missions.
- *  @param Mission Statistics
+ *  @param missionStatistics Mission Statistics.
  */
-int SoldierDiary::getBaseDefenseMissionTotal(std::vector<MissionStatistics*> *missionStatistics) const
+int SoldierDiary::getBaseDefenseMissionTotal(std::vector<MissionStatistics*> *missionStatistics)
 {
-	int baseDefenseMissionTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success && (*i)->isBaseDefense())
-				{
-					baseDefenseMissionTotal++;
-				}
-			}
-		}
-	}
-
-	return baseDefenseMissionTotal;
+	cacheMissionTotals(missionStatistics);
+	return _baseDefenseMissionTotal;
 }
 
 /**
  *  Get the total of alien base assaults.
- *  @param Mission Statistics
+ *  @param missionStatistics Mission Statistics.
  */
-int SoldierDiary::getAlienBaseAssaultTotal(std::vector<MissionStatistics*> *missionStatistics) const
+int SoldierDiary::getAlienBaseAssaultTotal(std::vector<MissionStatistics*> *missionStatistics)
 {
-	int alienBaseAssaultTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success && (*i)->isAlienBase())
-				{
-					alienBaseAssaultTotal++;
-				}
-			}
-		}
-	}
-
-	return alienBaseAssaultTotal;
+	cacheMissionTotals(missionStatistics);
+	return _alienBaseAssaultTotal;
 }
 
 /**
  *  Get the total of important missions.
- *  @param Mission Statistics
+ *  @param missionStatistics Mission Statistics.
  */
-int SoldierDiary::getImportantMissionTotal(std::vector<MissionStatistics*> *missionStatistics) const
+int SoldierDiary::getImportantMissionTotal(std::vector<MissionStatistics*> *missionStatistics)
 {
-	int importantMissionTotal = 0;
+	cacheMissionTotals(missionStatistics);
+	return _importantMissionTotal;
+}
 
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
-	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				if ((*i)->success && (*i)->type != "STR_UFO_CRASH_RECOVERY")
-				{
-					importantMissionTotal++;
-				}
-			}
-		}
-	}
+/**
+ *  Get the total score.
+ *  @param missionStatistics Mission Statistics.
+ */
+int SoldierDiary::getScoreTotal(std::vector<MissionStatistics*> *missionStatistics)
+{
+	cacheMissionTotals(missionStatistics);
+	return _scoreTotal;
+}
 
-	return importantMissionTotal;
+/**
+ *  Get the Valient Crux total.
+ *  @param missionStatistics Mission Statistics.
+ */
+int SoldierDiary::getValiantCruxTotal(std::vector<MissionStatistics*> *missionStatistics)
+{
+	cacheMissionTotals(missionStatistics);
+	return _valiantCruxTotal;
 }
 
 /**
- *  Get the total score.
- *  @param Mission Statistics
+ *  Get the loot value total.
+ *  @param missionStatistics Mission Statistics.
  */
-int SoldierDiary::getScoreTotal(std::vector<MissionStatistics*> *missionStatistics) const
+int SoldierDiary::getLootValueTotal(std::vector<MissionStatistics*> *missionStatistics)
 {
-	int scoreTotal = 0;
+	cacheMissionTotals(missionStatistics);
+	return _lootValueTotal;
+}
 
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
+/**
+ * Adds a kill to the soldier's kill totals.
+ * @param kill The kill to count.
+ */
+void SoldierDiary::addKillTotals(const BattleUnitKills *kill)
+{
+	if (kill->faction == FACTION_HOSTILE)
 	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
-		{
-			if ((*j) == (*i)->id)
-			{
-				scoreTotal += (*i)->score;
-			}
-		}
+		if (kill->status == STATUS_DEAD)
+			_killTotal++;
+		else if (kill->status == STATUS_UNCONSCIOUS)
+			_stunTotal++;
+		_weaponTotal[kill->weapon]++;
+		_weaponAmmoTotal[kill->weaponAmmo]++;
 	}
-
-	return scoreTotal;
+	_alienRankTotal[kill->rank]++;
+	_alienRaceTotal[kill->race]++;
 }
 
 /**
- *  Get the Valient Crux total.
- *  @param Mission Statistics
+ * Adds a mission the soldier took part in to the mission totals.
+ * @param missionStatistics The mission to count.
  */
-int SoldierDiary::getValiantCruxTotal(std::vector<MissionStatistics*> *missionStatistics) const
+void SoldierDiary::addMissionTotals(const MissionStatistics *missionStatistics)
 {
-	int valiantCruxTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
+	_regionTotal[missionStatistics->region]++;
+	_countryTotal[missionStatistics->country]++;
+	_typeTotal[missionStatistics->type]++;
+	_ufoTotal[missionStatistics->ufo]++;
+	_scoreTotal += missionStatistics->score;
+	_lootValueTotal += missionStatistics->lootValue;
+	if (missionStatistics->valiantCrux)
+		_valiantCruxTotal++;
+	if (!missionStatistics->success)
+		return;
+	_winTotal++;
+	if (missionStatistics->type != "STR_UFO_CRASH_RECOVERY")
+		_importantMissionTotal++;
+	if (missionStatistics->isBaseDefense())
 	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
+		_baseDefenseMissionTotal++;
+	}
+	else if (missionStatistics->isAlienBase())
+	{
+		_alienBaseAssaultTotal++;
+	}
+	else
+	{
+		/// Not a UFO, not the base, not the alien base or colony
+		bool terror = !missionStatistics->isUfoMission();
+		if (terror)
+			_terrorMissionTotal++;
+		if (missionStatistics->isDarkness())
 		{
-			if ((*j) == (*i)->id && (*i)->valiantCrux)
-			{
-				valiantCruxTotal++;
-			}
+			_nightMissionTotal++;
+			if (terror)
+				_nightTerrorMissionTotal++;
 		}
 	}
-
-	return valiantCruxTotal;
 }
 
 /**
- *  Get the loot value total.
- *  @param Mission Statistics
+ * Builds the mission totals from the soldier's mission list, if
+ * that hasn't been done yet. Afterwards updateDiary() keeps them
+ * up to date, so this only has to run once per loaded game.
+ * @param missionStatistics Mission Statistics.
  */
-int SoldierDiary::getLootValueTotal(std::vector<MissionStatistics*> *missionStatistics) const
+void SoldierDiary::cacheMissionTotals(std::vector<MissionStatistics*> *missionStatistics)
 {
-	int lootValueTotal = 0;
-
-	for (std::vector<MissionStatistics*>::const_iterator i = missionStatistics->begin(); i != missionStatistics->end(); ++i)
+	if (_missionTotalsCached)
+		return;
+	_winTotal = _scoreTotal = _terrorMissionTotal = _nightMissionTotal = _nightTerrorMissionTotal = _baseDefenseMissionTotal = 0;
+	_alienBaseAssaultTotal = _importantMissionTotal = _valiantCruxTotal = _lootValueTotal = 0;
+	_regionTotal.clear();
+	_countryTotal.clear();
+	_typeTotal.clear();
+	_ufoTotal.clear();
+	for (std::vector<int>::const_iterator i = _missionIdList.begin(); i != _missionIdList.end(); ++i)
 	{
-		for (std::vector<int>::const_iterator j = _missionIdList.begin(); j != _missionIdList.end(); ++j)
+		MissionStatistics *ms = findMissionStatistics(missionStatistics, *i);
+		if (ms)
 		{
-			if ((*j) == (*i)->id)
-			{
-				lootValueTotal += (*i)->lootValue;
-			}
+			addMissionTotals(ms);
 		}
 	}
-
-	return lootValueTotal;
+	_missionTotalsCached = true;
 }
 
 /**
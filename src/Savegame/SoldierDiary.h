@@ -21,6 +21,7 @@
 #include "BattleUnit.h"
 #include "SavedGame.h"
 #include "../Mod/Mod.h"
+#include "../Mod/RuleCommendations.h"
 
 namespace OpenXcom
 {
@@ -79,7 +80,22 @@ private:
 		_woundsHealedTotal, _allUFOs, _allMissionTypes, _statGainTotal, _revivedUnitTotal, _wholeMedikitTotal, _braveryGainTotal, _bestOfRank, _MIA,
 		_martyrKillsTotal, _postMortemKills, _slaveKillsTotal, _bestSoldier, _revivedSoldierTotal, _revivedHostileTotal, _revivedNeutralTotal;
 	bool _globeTrotter;
+	// Totals derived from the kill list and the mission statistics, kept up to date by updateDiary().
+	int _killTotal, _stunTotal;
+	std::map<std::string, int> _alienRankTotal, _alienRaceTotal, _weaponTotal, _weaponAmmoTotal;
+	bool _missionTotalsCached;
+	int _winTotal, _scoreTotal, _terrorMissionTotal, _nightMissionTotal, _nightTerrorMissionTotal, _baseDefenseMissionTotal,
+		_alienBaseAssaultTotal, _importantMissionTotal, _valiantCruxTotal, _lootValueTotal;
+	std::map<std::string, int> _regionTotal, _countryTotal, _typeTotal, _ufoTotal;
 	void awardCommendation(const std::string& type, const std::string& noun = "noNoun");
+	/// Adds a kill to the kill totals.
+	void addKillTotals(const BattleUnitKills *kill);
+	/// Adds a mission to the mission totals.
+	void addMissionTotals(const MissionStatistics *missionStatistics);
+	/// Builds the mission totals from the soldier's missions.
+	void cacheMissionTotals(std::vector<MissionStatistics*> *missionStatistics);
+	/// Checks if a criterion reaches its threshold.
+	bool meetsCriterion(CommendationCriterion criterion, int threshold, Mod *mod, std::vector<MissionStatistics*> *missionStatistics);
 public:
 	/// Construct a diary.
 	SoldierDiary();
@@ -100,19 +116,19 @@ public:
 	/// Get the list of kills, mapped by weapon ammo used.
 	std::map<std::string, int> getWeaponAmmoTotal();
 	/// Get the list of missions, mapped by region.
-	std::map<std::string, int> getRegionTotal(std::vector<MissionStatistics*>*) const;
+	std::map<std::string, int> getRegionTotal(std::vector<MissionStatistics*>*);
 	/// Get the list of missions, mapped by country.
-	std::map<std::string, int> getCountryTotal(std::vector<MissionStatistics*>*) const;
+	std::map<std::string, int> getCountryTotal(std::vector<MissionStatistics*>*);
 	/// Get the list of missions, mapped by type.
-	std::map<std::string, int> getTypeTotal(std::vector<MissionStatistics*>*) const;
+	std::map<std::string, int> getTypeTotal(std::vector<MissionStatistics*>*);
 	/// Get the list of missions, mapped by UFO.
-	std::map<std::string, int> getUFOTotal(std::vector<MissionStatistics*>*) const;
+	std::map<std::string, int> getUFOTotal(std::vector<MissionStatistics*>*);
 	/// Get the total number of kills.
 	int getKillTotal() const;
 	/// Get the total number of missions.
 	int getMissionTotal() const;
 	/// Get the total number of wins.
-	int getWinTotal(std::vector<MissionStatistics*>*) const;
+	int getWinTotal(std::vector<MissionStatistics*>*);
 	/// Get the total number of stuns.
 	int getStunTotal() const;
 	/// Get the total number of psi panicks.
@@ -152,23 +168,23 @@ public:
 	/// Get the total number of reaction fire kills.
 	int getReactionFireKillTotal(Mod*) const;
 	/// Get the total number of terror missions.
-	int getTerrorMissionTotal(std::vector<MissionStatistics*>*) const;
+	int getTerrorMissionTotal(std::vector<MissionStatistics*>*);
 	/// Get the total number of night missions.
-	int getNightMissionTotal(std::vector<MissionStatistics*>*) const;
+	int getNightMissionTotal(std::vector<MissionStatistics*>*);
 	/// Get the total number of night terror missions.
-	int getNightTerrorMissionTotal(std::vector<MissionStatistics*>*) const;
+	int getNightTerrorMissionTotal(std::vector<MissionStatistics*>*);
 	/// Get the total number of base defense missions.
-	int getBaseDefenseMissionTotal(std::vector<MissionStatistics*>*) const;
+	int getBaseDefenseMissionTotal(std::vector<MissionStatistics*>*);
 	/// Get the total number of alien base assaults.
-	int getAlienBaseAssaultTotal(std::vector<MissionStatistics*>*) const;
+	int getAlienBaseAssaultTotal(std::vector<MissionStatistics*>*);
 	/// Get the total number of important missions.
-	int getImportantMissionTotal(std::vector<MissionStatistics*>*) const;
+	int getImportantMissionTotal(std::vector<MissionStatistics*>*);
 	/// Get the total score.
-	int getScoreTotal(std::vector<MissionStatistics*>*) const;
+	int getScoreTotal(std::vector<MissionStatistics*>*);
 	/// Get the Valiant Crux total.
-	int getValiantCruxTotal(std::vector<MissionStatistics*>*) const;
+	int getValiantCruxTotal(std::vector<MissionStatistics*>*);
 	/// Get the loot value total.
-	int getLootValueTotal(std::vector<MissionStatistics*>*) const;
+	int getLootValueTotal(std::vector<MissionStatistics*>*);
 };
 
 }
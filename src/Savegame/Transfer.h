@@ -19,6 +19,7 @@
  */
 #include <string>
 #include <yaml-cpp/yaml.h>
+#include "../Engine/ObjectPool.h"
 
 namespace OpenXcom
 {
@@ -61,6 +62,7 @@ public:
 	Transfer(int hours);
 	/// Cleans up the transfer.
 	~Transfer();
+	OXC_POOLED_OBJECT(Transfer)
 	/// Loads the transfer from YAML.
 	bool load(const YAML::Node& node, Base *base, const Mod *mod, SavedGame *save);
 	/// Saves the transfer to YAML.
@@ -20,6 +20,7 @@
 #include "Target.h"
 #include <string>
 #include <yaml-cpp/yaml.h>
+#include "../Engine/ObjectPool.h"
 
 namespace OpenXcom
 {
@@ -34,6 +35,7 @@ public:
 	Waypoint();
 	/// Cleans up the waypoint.
 	~Waypoint();
+	OXC_POOLED_OBJECT(Waypoint)
 	/// Gets the waypoint's type.
 	std::string getType() const;
 	/// Gets the waypoint's marker sprite.
@@ -115,6 +115,15 @@ int main(int argc, char *argv[])
 	Options::baseXResolution = Options::displayWidth;
 	Options::baseYResolution = Options::displayHeight;
 
+	// The campaign benchmark runs without a window or sound card
+	if (!Options::getBenchmarkSave().empty())
+	{
+		SDL_putenv((char*)"SDL_VIDEODRIVER=dummy");
+		SDL_putenv((char*)"SDL_AUDIODRIVER=dummy");
+		Options::useOpenGL = false;
+		Options::playIntro = false;
+	}
+
 	game = new Game(title.str());
 	State::setGamePtr(game);
 	game->setState(new StartState);